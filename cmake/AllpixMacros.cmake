@@ -264,6 +264,17 @@ FUNCTION(add_allpix_test)
             PROPERTY FAIL_REGULAR_EXPRESSION "${fail}")
     ENDFOREACH()
 
+    # Skip the test if one of the expressions is found, e.g. if the system does not support a feature
+    FILE(STRINGS ${TEST_FILE} SKIP_LST_ REGEX "#SKIP ")
+    FOREACH(skip ${SKIP_LST_})
+        STRING(REPLACE "#SKIP " "" skip "${skip}")
+        ESCAPE_REGEX("${skip}" skip)
+        SET_PROPERTY(
+            TEST ${TEST_NAME}
+            APPEND
+            PROPERTY SKIP_REGULAR_EXPRESSION "${skip}")
+    ENDFOREACH()
+
     # Add default fail conditions
     ADD_DEFAULT_FAIL_CONDITIONS(${TEST_NAME})
 
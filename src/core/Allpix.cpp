@@ -117,6 +117,16 @@ void Allpix::load() {
     LOG(STATUS) << "Welcome to Allpix^2 " << ALLPIX_PROJECT_VERSION;
     global_config.set<std::string>("version", ALLPIX_PROJECT_VERSION, true);
 
+    // Select the engine of all pseudo-random number generators before seeding them
+    auto random_engine = global_config.get<RandomNumberGenerator::Engine>("random_engine",
+                                                                          RandomNumberGenerator::Engine::MERSENNE_TWISTER);
+    RandomNumberGenerator::setDefaultEngine(random_engine);
+    seeder_modules_.setEngine(random_engine);
+    seeder_core_.setEngine(random_engine);
+    if(random_engine != RandomNumberGenerator::Engine::MERSENNE_TWISTER) {
+        LOG(STATUS) << "Using " << allpix::to_string(random_engine) << " engine for pseudo-random numbers";
+    }
+
     uint64_t seed = 0;
     if(global_config.has("random_seed")) {
         // Use provided random seed
@@ -118,7 +118,8 @@ ROOT::Math::XYZVector Detector::getElectricField(const ROOT::Math::XYZPoint& loc
 }
 
 /**
- * @throws std::invalid_argument If the electric field dimensions are incorrect or the thickness domain is outside the sensor
+ * @throws std::invalid_argument If the electric field dimensions are incorrect, the thickness domain is outside the sensor
+ * or the interpolation is not available
  */
 void Detector::setElectricFieldGrid(const std::shared_ptr<std::vector<double>>& field,
                                     std::array<size_t, 3> bins,
@@ -126,9 +127,24 @@ void Detector::setElectricFieldGrid(const std::shared_ptr<std::vector<double>>&
                                     FieldMapping mapping,
                                     std::array<double, 2> scales,
                                     std::array<double, 2> offset,
-                                    std::pair<double, double> thickness_domain) {
+                                    std::pair<double, double> thickness_domain,
+                                    FieldInterpolation interpolation,
+                                    FieldLayout layout) {
     check_field_match(size, mapping, scales, thickness_domain);
-    electric_field_.setGrid(field, bins, size, mapping, scales, offset, thickness_domain);
+    electric_field_.setGrid(field, bins, size, mapping, scales, offset, thickness_domain, interpolation, layout);
+}
+
+void Detector::setElectricFieldGrid(const std::shared_ptr<std::vector<float>>& field,
+                                    std::array<size_t, 3> bins,
+                                    std::array<double, 3> size,
+                                    FieldMapping mapping,
+                                    std::array<double, 2> scales,
+                                    std::array<double, 2> offset,
+                                    std::pair<double, double> thickness_domain,
+                                    FieldInterpolation interpolation,
+                                    FieldLayout layout) {
+    check_field_match(size, mapping, scales, thickness_domain);
+    electric_field_.setGrid(field, bins, size, mapping, scales, offset, thickness_domain, interpolation, layout);
 }
 
 void Detector::setElectricFieldFunction(FieldFunction<ROOT::Math::XYZVector> function,
@@ -159,9 +175,24 @@ void Detector::setWeightingPotentialGrid(const std::shared_ptr<std::vector<doubl
                                          FieldMapping mapping,
                                          std::array<double, 2> scales,
                                          std::array<double, 2> offset,
-                                         std::pair<double, double> thickness_domain) {
+                                         std::pair<double, double> thickness_domain,
+                                         FieldInterpolation interpolation,
+                                         FieldLayout layout) {
+    check_field_match(size, mapping, scales, thickness_domain);
+    weighting_potential_.setGrid(potential, bins, size, mapping, scales, offset, thickness_domain, interpolation, layout);
+}
+
+void Detector::setWeightingPotentialGrid(const std::shared_ptr<std::vector<float>>& potential,
+                                         std::array<size_t, 3> bins,
+                                         std::array<double, 3> size,
+                                         FieldMapping mapping,
+                                         std::array<double, 2> scales,
+                                         std::array<double, 2> offset,
+                                         std::pair<double, double> thickness_domain,
+                                         FieldInterpolation interpolation,
+                                         FieldLayout layout) {
     check_field_match(size, mapping, scales, thickness_domain);
-    weighting_potential_.setGrid(potential, bins, size, mapping, scales, offset, thickness_domain);
+    weighting_potential_.setGrid(potential, bins, size, mapping, scales, offset, thickness_domain, interpolation, layout);
 }
 
 void Detector::setWeightingPotentialFunction(FieldFunction<double> function,
@@ -182,6 +213,27 @@ void Detector::setMagneticField(ROOT::Math::XYZVector b_field) {
  */
 ROOT::Math::XYZVector Detector::getMagneticField(const ROOT::Math::XYZPoint&) const { return magnetic_field_; }
 
+/**
+ * The fields are evaluated as by the individual getters. The lookup of the pixel, which the fields are replicated for, is
+ * shared between the electric field and the doping profile.
+ */
+FieldSample Detector::getFieldSample(const ROOT::Math::XYZPoint& local_pos) const {
+    FieldSample sample;
+    sample.magnetic_field = magnetic_field_;
+
+    // Outside of the pixel matrix the electric field and doping profile are zero by definition
+    if(!model_->isWithinMatrix(local_pos)) {
+        return sample;
+    }
+
+    auto [px, py] = model_->getPixelIndex(local_pos);
+    auto pixel_center = static_cast<ROOT::Math::XYPoint>(model_->getPixelCenter(px, py));
+    sample.electric_field = electric_field_.getWithinMatrix(local_pos, pixel_center);
+    // Extrapolate doping profile if outside defined field:
+    sample.doping_concentration = doping_profile_.getWithinMatrix(local_pos, pixel_center, true);
+    return sample;
+}
+
 /**
  * The doping profile is replicated for all pixels and uses flipping at each boundary (side effects are not modeled in this
  * stage). Outside of the sensor the doping profile is strictly zero by definition.
@@ -203,9 +255,24 @@ void Detector::setDopingProfileGrid(std::shared_ptr<std::vector<double>> field,
                                     FieldMapping mapping,
                                     std::array<double, 2> scales,
                                     std::array<double, 2> offset,
-                                    std::pair<double, double> thickness_domain) {
+                                    std::pair<double, double> thickness_domain,
+                                    FieldInterpolation interpolation,
+                                    FieldLayout layout) {
+    check_field_match(size, mapping, scales, thickness_domain);
+    doping_profile_.setGrid(std::move(field), bins, size, mapping, scales, offset, thickness_domain, interpolation, layout);
+}
+
+void Detector::setDopingProfileGrid(std::shared_ptr<std::vector<float>> field,
+                                    std::array<size_t, 3> bins,
+                                    std::array<double, 3> size,
+                                    FieldMapping mapping,
+                                    std::array<double, 2> scales,
+                                    std::array<double, 2> offset,
+                                    std::pair<double, double> thickness_domain,
+                                    FieldInterpolation interpolation,
+                                    FieldLayout layout) {
     check_field_match(size, mapping, scales, thickness_domain);
-    doping_profile_.setGrid(std::move(field), bins, size, mapping, scales, offset, thickness_domain);
+    doping_profile_.setGrid(std::move(field), bins, size, mapping, scales, offset, thickness_domain, interpolation, layout);
 }
 
 void Detector::setDopingProfileFunction(FieldFunction<double> function, FieldType type) {
@@ -32,6 +32,15 @@
 
 namespace allpix {
 
+    /**
+     * @brief Values of the fields of a detector at a single position
+     */
+    struct FieldSample {
+        ROOT::Math::XYZVector electric_field{}; ///< Electric field
+        double doping_concentration{};          ///< Doping concentration
+        ROOT::Math::XYZVector magnetic_field{}; ///< Magnetic field
+    };
+
     /**
      * @brief Instantiation of a detector model in the world
      *
@@ -113,6 +122,12 @@ namespace allpix {
          * @return The type of the electric field
          */
         FieldType getElectricFieldType() const { return electric_field_.getType(); }
+        /**
+         * @brief Return the mapping of the electric field to the sensor
+         * @note The mapping only applies to electric fields supplied through a grid or a custom function
+         * @return The mapping of the electric field
+         */
+        FieldMapping getElectricFieldMapping() const { return electric_field_.getMapping(); }
         /**
          * @brief Get the electric field in the sensor at a local position
          * @param local_pos Position in the local frame
@@ -129,6 +144,8 @@ namespace allpix {
          * @param scales Scaling factors for the field size, given in fractions of the field size in x and y
          * @param offset Offset of the field, given in fractions of the field size in x and y
          * @param thickness_domain Domain in local coordinates in the thickness direction where the field holds
+         * @param interpolation Interpolation of the values between the bins of the grid
+         * @param layout Memory layout used to store the grid
          */
         void setElectricFieldGrid(const std::shared_ptr<std::vector<double>>& field,
                                   std::array<size_t, 3> bins,
@@ -136,7 +153,30 @@ namespace allpix {
                                   FieldMapping mapping,
                                   std::array<double, 2> scales,
                                   std::array<double, 2> offset,
-                                  std::pair<double, double> thickness_domain);
+                                  std::pair<double, double> thickness_domain,
+                                  FieldInterpolation interpolation = FieldInterpolation::NEAREST,
+                                  FieldLayout layout = FieldLayout::FLAT);
+        /**
+         * @brief Set the electric field in a single pixel in the detector using a grid stored in single precision
+         * @param field Flat array of the field vectors (see detailed description)
+         * @param bins The dimensions of the flat electric field array
+         * @param size Size of the electric field along the three dimensions of the field map
+         * @param mapping Specification of the mapping of the field onto the pixel plane
+         * @param scales Scaling factors for the field size, given in fractions of the field size in x and y
+         * @param offset Offset of the field, given in fractions of the field size in x and y
+         * @param thickness_domain Domain in local coordinates in the thickness direction where the field holds
+         * @param interpolation Interpolation of the values between the bins of the grid
+         * @param layout Memory layout used to store the grid
+         */
+        void setElectricFieldGrid(const std::shared_ptr<std::vector<float>>& field,
+                                  std::array<size_t, 3> bins,
+                                  std::array<double, 3> size,
+                                  FieldMapping mapping,
+                                  std::array<double, 2> scales,
+                                  std::array<double, 2> offset,
+                                  std::pair<double, double> thickness_domain,
+                                  FieldInterpolation interpolation = FieldInterpolation::NEAREST,
+                                  FieldLayout layout = FieldLayout::FLAT);
         /**
          * @brief Set the electric field in a single pixel using a function
          * @param function Function used to retrieve the electric field
@@ -158,6 +198,12 @@ namespace allpix {
          * @return The type of the doping profile
          */
         FieldType getDopingProfileType() const { return doping_profile_.getType(); }
+        /**
+         * @brief Return the mapping of the doping profile to the sensor
+         * @note The mapping only applies to doping profiles supplied through a grid or a custom function
+         * @return The mapping of the doping profile
+         */
+        FieldMapping getDopingProfileMapping() const { return doping_profile_.getMapping(); }
         /**
          * @brief Get the doping profile in the sensor at a local position
          * @param pos Position in the local frame
@@ -174,6 +220,8 @@ namespace allpix {
          * @param scales Scaling factors for the field size, given in fractions of a pixel unit cell in x and y
          * @param offset Offset of the field, given in fractions of the field size in x and y
          * @param thickness_domain Domain in local coordinates in the thickness direction where the profile holds
+         * @param interpolation Interpolation of the values between the bins of the grid
+         * @param layout Memory layout used to store the grid
          */
         void setDopingProfileGrid(std::shared_ptr<std::vector<double>> field,
                                   std::array<size_t, 3> bins,
@@ -181,7 +229,30 @@ namespace allpix {
                                   FieldMapping mapping,
                                   std::array<double, 2> scales,
                                   std::array<double, 2> offset,
-                                  std::pair<double, double> thickness_domain);
+                                  std::pair<double, double> thickness_domain,
+                                  FieldInterpolation interpolation = FieldInterpolation::NEAREST,
+                                  FieldLayout layout = FieldLayout::FLAT);
+        /**
+         * @brief Set the doping profile in a single pixel in the detector using a grid stored in single precision
+         * @param field Flat array of the field (see detailed description)
+         * @param bins The dimensions of the flat doping profile array
+         * @param size Size of the doping profile along the three dimensions of the field map
+         * @param mapping Specification of the mapping of the field onto the pixel plane
+         * @param scales Scaling factors for the field size, given in fractions of a pixel unit cell in x and y
+         * @param offset Offset of the field, given in fractions of the field size in x and y
+         * @param thickness_domain Domain in local coordinates in the thickness direction where the profile holds
+         * @param interpolation Interpolation of the values between the bins of the grid
+         * @param layout Memory layout used to store the grid
+         */
+        void setDopingProfileGrid(std::shared_ptr<std::vector<float>> field,
+                                  std::array<size_t, 3> bins,
+                                  std::array<double, 3> size,
+                                  FieldMapping mapping,
+                                  std::array<double, 2> scales,
+                                  std::array<double, 2> offset,
+                                  std::pair<double, double> thickness_domain,
+                                  FieldInterpolation interpolation = FieldInterpolation::NEAREST,
+                                  FieldLayout layout = FieldLayout::FLAT);
         /**
          * @brief Set the doping profile in a single pixel using a function
          * @param function Function used to retrieve the doping profile
@@ -218,6 +289,8 @@ namespace allpix {
          * @param scales Scaling factors for the field size, given in fractions of a pixel unit cell in x and y
          * @param offset Offset of the field, given in fractions of the field size in x and y
          * @param thickness_domain Domain in local coordinates in the thickness direction where the potential holds
+         * @param interpolation Interpolation of the values between the bins of the grid
+         * @param layout Memory layout used to store the grid
          */
         void setWeightingPotentialGrid(const std::shared_ptr<std::vector<double>>& potential,
                                        std::array<size_t, 3> bins,
@@ -225,7 +298,30 @@ namespace allpix {
                                        FieldMapping mapping,
                                        std::array<double, 2> scales,
                                        std::array<double, 2> offset,
-                                       std::pair<double, double> thickness_domain);
+                                       std::pair<double, double> thickness_domain,
+                                       FieldInterpolation interpolation = FieldInterpolation::NEAREST,
+                                       FieldLayout layout = FieldLayout::FLAT);
+        /**
+         * @brief Set the weighting potential in a single pixel in the detector using a grid stored in single precision
+         * @param potential Flat array of the potential vectors (see detailed description)
+         * @param bins The dimensions of the flat weighting potential array
+         * @param size Size of the weighting potential along the three dimensions of the field map
+         * @param mapping Specification of the mapping of the field onto the pixel plane
+         * @param scales Scaling factors for the field size, given in fractions of a pixel unit cell in x and y
+         * @param offset Offset of the field, given in fractions of the field size in x and y
+         * @param thickness_domain Domain in local coordinates in the thickness direction where the potential holds
+         * @param interpolation Interpolation of the values between the bins of the grid
+         * @param layout Memory layout used to store the grid
+         */
+        void setWeightingPotentialGrid(const std::shared_ptr<std::vector<float>>& potential,
+                                       std::array<size_t, 3> bins,
+                                       std::array<double, 3> size,
+                                       FieldMapping mapping,
+                                       std::array<double, 2> scales,
+                                       std::array<double, 2> offset,
+                                       std::pair<double, double> thickness_domain,
+                                       FieldInterpolation interpolation = FieldInterpolation::NEAREST,
+                                       FieldLayout layout = FieldLayout::FLAT);
         /**
          * @brief Set the weighting potential in a single pixel using a function
          * @param function Function used to retrieve the weighting potential
@@ -254,6 +350,15 @@ namespace allpix {
          */
         ROOT::Math::XYZVector getMagneticField(const ROOT::Math::XYZPoint& local_pos) const;
 
+        /**
+         * @brief Get the electric field, the doping concentration and the magnetic field at a local position
+         * @param local_pos Position in the local frame
+         * @return Values of all fields at the queried point
+         * @note The pixel containing the position is only determined once for all fields, which makes this faster than
+         *       querying the fields individually
+         */
+        FieldSample getFieldSample(const ROOT::Math::XYZPoint& local_pos) const;
+
         /**
          * @brief Get the model of this detector
          * @return Pointer to the constant detector model
@@ -12,8 +12,13 @@
 #ifndef ALLPIX_DETECTOR_FIELD_H
 #define ALLPIX_DETECTOR_FIELD_H
 
+#include <algorithm>
 #include <array>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include <Math/Point2D.h>
@@ -27,6 +32,43 @@
 
 namespace allpix {
 
+    /**
+     * @brief Copies of read-only field grids for separate memory domains, such as NUMA nodes
+     *
+     * The framework sets the number of copies before the fields are loaded, and selects the copy read by every thread when
+     * the thread is started. Threads without a selected copy read from the original grid.
+     */
+    class FieldReplicas {
+    public:
+        /**
+         * @brief Set the number of copies created for every field grid loaded afterwards
+         * @param count Number of copies, zero to disable replication
+         */
+        static void setCount(unsigned int count) { count_ = count; }
+
+        /**
+         * @brief Get the number of copies created for every field grid
+         * @return Number of copies, zero if replication is disabled
+         */
+        static unsigned int count() { return count_; }
+
+        /**
+         * @brief Select the copy read by the calling thread
+         * @param index Index of the copy between zero and \ref count, or -1 to read from the original grid
+         */
+        static void setThreadIndex(int index) { thread_index_ = index; }
+
+        /**
+         * @brief Get the copy read by the calling thread
+         * @return Index of the copy, or -1 if the thread reads from the original grid
+         */
+        static int threadIndex() { return thread_index_; }
+
+    private:
+        inline static unsigned int count_{0};
+        inline static thread_local int thread_index_{-1};
+    };
+
     /**
      * @brief Type of fields
      */
@@ -61,6 +103,23 @@ namespace allpix {
                 ///< mirrored at its edges.
     };
 
+    /**
+     * @brief Interpolation of field grids between the centers of their bins
+     */
+    enum class FieldInterpolation {
+        NEAREST = 0, ///< Value of the bin the position is contained in
+        LINEAR,      ///< Trilinear interpolation between the eight surrounding bin centers
+        CUBIC,       ///< Tricubic interpolation between the 64 surrounding bin centers, only available for scalar fields
+    };
+
+    /**
+     * @brief Memory layout of field grids
+     */
+    enum class FieldLayout {
+        FLAT = 0, ///< Grid points stored in a single array with z as fastest and x as slowest running index
+        BRICKED,  ///< Grid stored in cubic bricks of up to 4 KiB, each in the order of the flat layout
+    };
+
     /**
      * @brief Functor returning the field at a given position
      * @param pos Position in local coordinates at which the field should be evaluated
@@ -122,6 +181,13 @@ namespace allpix {
          */
         FieldType getType() const { return type_; }
 
+        /**
+         * @brief Return the mapping of the field to the sensor
+         * @note The mapping only applies to fields supplied through a grid or a custom function
+         * @return The mapping of the field
+         */
+        FieldMapping getMapping() const { return mapping_; }
+
         /**
          * @brief Get the field value in the sensor at a position provided in local coordinates
          * @param local_pos Position in the local frame
@@ -130,6 +196,17 @@ namespace allpix {
          */
         T get(const ROOT::Math::XYZPoint& local_pos, const bool extrapolate_z = false) const;
 
+        /**
+         * @brief Get the field value at a position within the pixel matrix for which the pixel center is already known
+         * @param local_pos Position in the local frame, required to be within the pixel matrix
+         * @param pixel_center Center of the pixel the position is located in, x and y coordinate only
+         * @param extrapolate_z Extrapolate the field along z when outside the defined region
+         * @return Value(s) of the field at the queried point
+         */
+        T getWithinMatrix(const ROOT::Math::XYZPoint& local_pos,
+                          const ROOT::Math::XYPoint& pixel_center,
+                          const bool extrapolate_z = false) const;
+
         /**
          * @brief Get the value of the field at a position provided in local coordinates with respect to the reference
          * @param local_pos Position in the local frame
@@ -143,21 +220,26 @@ namespace allpix {
 
         /**
          * @brief Set the field in the detector using a grid
-         * @param field Flat array of the field
+         * @param field Flat array of the field, stored in double or single precision
          * @param bins The bins of the flat field array
          * @param size Physical extent of the field
          * @param mapping Specification of the mapping of the field onto the pixel plane
          * @param scales Scaling factors for the field size, given in fractions of the field size in x and y
          * @param offset Offset of the field from the pixel center, given in fractions of the field size in x and y
          * @param thickness_domain Domain in local coordinates in the thickness direction where the field holds
+         * @param interpolation Interpolation of the field values between the bins of the grid
+         * @param layout Memory layout used to store the grid
          */
-        void setGrid(std::shared_ptr<std::vector<double>> field,
+        template <typename S>
+        void setGrid(std::shared_ptr<std::vector<S>> field,
                      std::array<size_t, 3> bins,
                      std::array<double, 3> size,
                      FieldMapping mapping,
                      std::array<double, 2> scales,
                      std::array<double, 2> offset,
-                     std::pair<double, double> thickness_domain);
+                     std::pair<double, double> thickness_domain,
+                     FieldInterpolation interpolation = FieldInterpolation::NEAREST,
+                     FieldLayout layout = FieldLayout::FLAT);
         /**
          * @brief Set the field in the detector using a function
          * @param function Function used to calculate the field
@@ -193,11 +275,79 @@ namespace allpix {
 
     private:
         /**
-         * @brief Helper function to retrieve the return type from a calculated index of the field data vector
+         * @brief Helper function to retrieve the return type from a calculated index of the field data
+         * @param field The field data to read from
          * @param offset The calculated global index to start from
          * @note The index sequence is expanded to the number of elements requested, depending on the template instance
          */
-        template <std::size_t... I> inline auto get_impl(size_t offset, std::index_sequence<I...>) const noexcept;
+        template <typename S, std::size_t... I>
+        inline auto get_impl(const S* field, size_t offset, std::index_sequence<I...>) const noexcept;
+
+        /**
+         * @brief Helper function to calculate the offset of a grid point along one axis in the field data
+         * @param axis Axis of the grid, zero for x, one for y and two for z
+         * @param index Index of the grid point along the axis
+         * @return Offset in the field data, the offsets along the three axes add up to the index of the grid point
+         */
+        inline size_t grid_offset(const size_t axis, const size_t index) const noexcept {
+            return layout_ == FieldLayout::FLAT ? index * strides_[axis]
+                                                : (index / brick_size_) * brick_strides_[axis] +
+                                                      (index % brick_size_) * strides_[axis];
+        }
+
+        /**
+         * @brief Helper function to evaluate the field grid with the configured interpolation
+         * @param value Value of the field at the requested position
+         * @param x Position in x in fractions of the field size, between zero and one
+         * @param y Position in y in fractions of the field size, between zero and one
+         * @param z Position in local-coordinate z
+         * @param extrapolate_z Flag whether we should extrapolate
+         * @return True if the position is within the field grid, false otherwise
+         */
+        inline bool get_grid_value(T& value, const double x, const double y, const double z, const bool extrapolate_z) const;
+
+        /**
+         * @brief Helper function to evaluate a field grid of the given precision with the configured interpolation
+         * @param field The field data vector to read from
+         * @param index Index of the bin the position is contained in
+         * @param x Position in x in fractions of the field size, between zero and one
+         * @param y Position in y in fractions of the field size, between zero and one
+         * @param z Position in local-coordinate z
+         * @return Value of the field at the requested position
+         */
+        template <typename S>
+        inline T evaluate_grid(
+            const std::vector<S>& field, const size_t index, const double x, const double y, const double z) const noexcept;
+
+        /**
+         * @brief Helper function to interpolate the field grid linearly between the centers of its bins
+         * @param field The field data vector to read from
+         * @param x Position in x in units of bins, relative to the center of the first bin
+         * @param y Position in y in units of bins, relative to the center of the first bin
+         * @param z Position in z in units of bins, relative to the center of the first bin
+         * @return Interpolated components of the field
+         */
+        template <typename S>
+        inline std::array<double, N>
+        interpolate_linear(const std::vector<S>& field, const double x, const double y, const double z) const noexcept;
+
+        /**
+         * @brief Helper function to interpolate the field grid with Catmull-Rom splines between the centers of its bins
+         * @param field The field data vector to read from
+         * @param x Position in x in units of bins, relative to the center of the first bin
+         * @param y Position in y in units of bins, relative to the center of the first bin
+         * @param z Position in z in units of bins, relative to the center of the first bin
+         * @return Interpolated components of the field
+         */
+        template <typename S>
+        inline std::array<double, N>
+        interpolate_cubic(const std::vector<S>& field, const double x, const double y, const double z) const noexcept;
+
+        /**
+         * @brief Helper function to obtain the field data vector of the given precision to read from
+         * @return The copy of the field grid on the NUMA node of the calling thread if available, the field grid otherwise
+         */
+        template <typename S> inline const std::vector<S>& get_grid() const;
 
         /**
          * @brief Helper function to calculate the field index based on the distance from its center
@@ -237,11 +387,24 @@ namespace allpix {
          * * bins of the field map (bins in x, y, z)
          * * Mapping of the field onto the pixel cell
          * * Scale of the field in x and y direction, defaults to one full pixel cell
+         * * Interpolation between the bins of the field map
          */
         std::array<size_t, 3> bins_{};
         FieldMapping mapping_{FieldMapping::PIXEL_FULL};
         std::array<double, 2> normalization_{{1., 1.}};
         std::array<double, 2> offset_{{0., 0.}};
+        FieldInterpolation interpolation_{FieldInterpolation::NEAREST};
+
+        /**
+         * Grid layout
+         * * Strides of the grid points along x, y and z, within a brick for bricked grids
+         * * Strides of the bricks along x, y and z for bricked grids
+         * * Edge length of the bricks in grid points, the largest power of two for which a brick fits into 4 KiB
+         */
+        FieldLayout layout_{FieldLayout::FLAT};
+        std::array<size_t, 3> strides_{};
+        std::array<size_t, 3> brick_strides_{};
+        static constexpr size_t brick_size_ = (N == 1 ? 8 : (N <= 8 ? 4 : 2));
 
         /**
          * Field definition
@@ -254,9 +417,23 @@ namespace allpix {
          * component in the flat field vector can be calculated as:
          *
          *   field_i(x, y, z) =  x * Y_SIZE* Z_SIZE * N + y * Z_SIZE * + z * N + i
+         *
+         * For the bricked layout, the same ordering is applied to the bricks and to the positions within each brick. The
+         * grid is stored either in double or in single precision, only the vector of the respective precision is set.
          */
-        std::shared_ptr<std::vector<double>> field_;
+        using FieldGrids = std::tuple<std::shared_ptr<std::vector<double>>, std::shared_ptr<std::vector<float>>>;
+        FieldGrids field_;
         std::pair<double, double> thickness_domain_{};
+
+        /*
+         * Copies of the field grid if replication is enabled via FieldReplicas. Each copy is created by the first thread
+         * reading it, such that its memory is allocated locally to the threads sharing it, e.g. on the same NUMA node.
+         */
+        struct Replica {
+            std::once_flag flag;
+            FieldGrids field;
+        };
+        std::shared_ptr<std::vector<Replica>> replicas_;
         FieldType type_{FieldType::NONE};
         FieldFunction<T> function_;
 
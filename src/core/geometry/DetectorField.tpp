@@ -28,7 +28,26 @@ namespace allpix {
             return {};
         }
 
-        if(type_ == FieldType::CONSTANT) {
+        // Calculate center of current pixel from index as reference point only for per-pixel fields:
+        ROOT::Math::XYPoint ref{};
+        if((type_ == FieldType::GRID || type_ == FieldType::CUSTOM) && mapping_ != FieldMapping::SENSOR) {
+            auto [px, py] = model_->getPixelIndex(pos);
+            ref = static_cast<ROOT::Math::XYPoint>(model_->getPixelCenter(px, py));
+        }
+        return getWithinMatrix(pos, ref, extrapolate_z);
+    }
+
+    /**
+     * The position is required to be within the pixel matrix, and the pixel center is only used for fields which are
+     * replicated for every pixel. This allows to share the pixel lookup between several fields at the same position.
+     */
+    template <typename T, size_t N>
+    T DetectorField<T, N>::getWithinMatrix(const ROOT::Math::XYZPoint& pos,
+                                           const ROOT::Math::XYPoint& pixel_center,
+                                           const bool extrapolate_z) const {
+        if(type_ == FieldType::NONE) {
+            return {};
+        } else if(type_ == FieldType::CONSTANT) {
             // Constant field - return value:
             return function_({});
         } else if(type_ == FieldType::LINEAR || type_ == FieldType::CUSTOM1D) {
@@ -45,12 +64,8 @@ namespace allpix {
 
             // For per-pixel fields, resort to getRelativeTo with current pixel as reference:
             if(mapping_ != FieldMapping::SENSOR) {
-                // Calculate center of current pixel from index as reference point:
-                auto [px, py] = model_->getPixelIndex(pos);
-                auto ref = static_cast<ROOT::Math::XYPoint>(model_->getPixelCenter(px, py));
-
                 // Get field relative to pixel center:
-                return getRelativeTo(pos, ref, extrapolate_z);
+                return getRelativeTo(pos, pixel_center, extrapolate_z);
             }
 
             // Check if we need to extrapolate along the z axis or if is inside thickness domain:
@@ -81,14 +96,10 @@ namespace allpix {
             T ret_val;
             // Compute using the grid or a function depending on the setting
             if(type_ == FieldType::GRID) {
-                // Calculate the linearized index of the bin in the field vector
-                size_t index = 0;
-                if(!get_grid_index(index, x * normalization_[0] + 0.5, y * normalization_[1] + 0.5, z, extrapolate_z)) {
+                // Fetch the field value at the given position
+                if(!get_grid_value(ret_val, x * normalization_[0] + 0.5, y * normalization_[1] + 0.5, z, extrapolate_z)) {
                     return {};
                 }
-
-                // Fetch the field value from the given index
-                ret_val = get_impl(index, std::make_index_sequence<N>{});
             } else {
                 // Calculate the field from the configured function:
                 ret_val = function_(ROOT::Math::XYZPoint(x, y, z));
@@ -128,15 +139,11 @@ namespace allpix {
             px -= (px == 1.0 ? std::numeric_limits<double>::epsilon() : 0.);
             py -= (py == 1.0 ? std::numeric_limits<double>::epsilon() : 0.);
 
-            // Calculate the linearized index of the bin in the field vector
-            size_t index = 0;
-            if(!get_grid_index(index, px, py, z, extrapolate_z)) {
+            // Fetch the field value at the given position
+            if(!get_grid_value(ret_val, px, py, z, extrapolate_z)) {
                 return {};
             }
 
-            // Fetch the field value from the given index
-            ret_val = get_impl(index, std::make_index_sequence<N>{});
-
             // Flip vector if necessary
             flip_vector_components(ret_val, flip_x, flip_y);
         } else {
@@ -227,8 +234,8 @@ namespace allpix {
         }
 
         // Compute total index
-        index = static_cast<size_t>(x_ind) * bins_[1] * bins_[2] * N + static_cast<size_t>(y_ind) * bins_[2] * N +
-                static_cast<size_t>(z_ind) * N;
+        index = grid_offset(0, static_cast<size_t>(x_ind)) + grid_offset(1, static_cast<size_t>(y_ind)) +
+                grid_offset(2, static_cast<size_t>(z_ind));
         return true;
     }
 
@@ -238,30 +245,228 @@ namespace allpix {
      * allows to call the appropriate constructor of the return type, e.g. ROOT::Math::XYZVector or simply a double.
      */
     template <typename T, size_t N>
-    template <std::size_t... I>
-    auto DetectorField<T, N>::get_impl(size_t offset, std::index_sequence<I...>) const noexcept {
-        return T{(*field_)[offset + I]...};
+    template <typename S, std::size_t... I>
+    auto DetectorField<T, N>::get_impl(const S* field, size_t offset, std::index_sequence<I...>) const noexcept {
+        return T{static_cast<double>(field[offset + I])...};
+    }
+
+    /**
+     * The range of the grid is checked with the bin lookup for all interpolation modes, such that the field is defined in
+     * exactly the same region independent of the interpolation. Interpolated values are computed from the bin centers,
+     * between the outermost bin centers and the border of the field the value of the edge bins is extended.
+     */
+    template <typename T, size_t N>
+    bool DetectorField<T, N>::get_grid_value(
+        T& value, const double x, const double y, const double z, const bool extrapolate_z) const {
+        // Calculate the linearized index of the bin in the field vector
+        size_t index = 0;
+        if(!get_grid_index(index, x, y, z, extrapolate_z)) {
+            return false;
+        }
+
+        // Read from the grid in the precision it is stored in
+        value = (std::get<std::shared_ptr<std::vector<float>>>(field_) != nullptr
+                     ? evaluate_grid(get_grid<float>(), index, x, y, z)
+                     : evaluate_grid(get_grid<double>(), index, x, y, z));
+        return true;
+    }
+
+    template <typename T, size_t N>
+    template <typename S>
+    T DetectorField<T, N>::evaluate_grid(
+        const std::vector<S>& field, const size_t index, const double x, const double y, const double z) const noexcept {
+        if(interpolation_ == FieldInterpolation::NEAREST) {
+            // Fetch the field value from the given index
+            return get_impl(field.data(), index, std::make_index_sequence<N>{});
+        }
+
+        // Convert to units of bins relative to the center of the first bin
+        auto bin_x = x * static_cast<double>(bins_[0]) - 0.5;
+        auto bin_y = y * static_cast<double>(bins_[1]) - 0.5;
+        auto bin_z = static_cast<double>(bins_[2]) * (z - thickness_domain_.first) /
+                         (thickness_domain_.second - thickness_domain_.first) -
+                     0.5;
+
+        auto values = (interpolation_ == FieldInterpolation::LINEAR ? interpolate_linear(field, bin_x, bin_y, bin_z)
+                                                                    : interpolate_cubic(field, bin_x, bin_y, bin_z));
+        return get_impl(values.data(), 0, std::make_index_sequence<N>{});
     }
 
     /**
-     * @throws std::invalid_argument If the field bins are incorrect or the thickness domain is outside the sensor
+     * The weights are calculated once per axis, the innermost loop runs over the contiguous components of a grid point with
+     * a length known at compile time and can be vectorized by the compiler.
      */
     template <typename T, size_t N>
-    void DetectorField<T, N>::setGrid(std::shared_ptr<std::vector<double>> field, // NOLINT
+    template <typename S>
+    std::array<double, N> DetectorField<T, N>::interpolate_linear(const std::vector<S>& field,
+                                                                  const double x,
+                                                                  const double y,
+                                                                  const double z) const noexcept {
+        const std::array<double, 3> pos{{x, y, z}};
+
+        // Offsets of the two neighboring bins and their weights, bins outside the grid are clamped to its edge
+        std::array<std::array<size_t, 2>, 3> offsets{};
+        std::array<std::array<double, 2>, 3> weights{};
+        for(size_t axis = 0; axis < 3; ++axis) {
+            auto lower = int_floor(pos[axis]);
+            auto fraction = pos[axis] - lower;
+            auto last = static_cast<int>(bins_[axis]) - 1;
+            offsets[axis] = {{grid_offset(axis, static_cast<size_t>(std::clamp(lower, 0, last))),
+                              grid_offset(axis, static_cast<size_t>(std::clamp(lower + 1, 0, last)))}};
+            weights[axis] = {{1.0 - fraction, fraction}};
+        }
+
+        std::array<double, N> values{};
+        for(size_t i = 0; i < 2; ++i) {
+            for(size_t j = 0; j < 2; ++j) {
+                for(size_t k = 0; k < 2; ++k) {
+                    const auto weight = weights[0][i] * weights[1][j] * weights[2][k];
+                    const auto* point = field.data() + offsets[0][i] + offsets[1][j] + offsets[2][k];
+                    for(size_t n = 0; n < N; ++n) {
+                        values[n] += weight * static_cast<double>(point[n]);
+                    }
+                }
+            }
+        }
+        return values;
+    }
+
+    /**
+     * Catmull-Rom splines pass through the values at the bin centers and have a continuous first derivative. The weights of
+     * the four neighboring bins are calculated once per axis, bins outside the grid are clamped to its edge.
+     */
+    template <typename T, size_t N>
+    template <typename S>
+    std::array<double, N> DetectorField<T, N>::interpolate_cubic(const std::vector<S>& field,
+                                                                 const double x,
+                                                                 const double y,
+                                                                 const double z) const noexcept {
+        const std::array<double, 3> pos{{x, y, z}};
+
+        std::array<std::array<size_t, 4>, 3> offsets{};
+        std::array<std::array<double, 4>, 3> weights{};
+        for(size_t axis = 0; axis < 3; ++axis) {
+            auto lower = int_floor(pos[axis]);
+            auto t = pos[axis] - lower;
+            auto t2 = t * t;
+            auto t3 = t2 * t;
+            auto last = static_cast<int>(bins_[axis]) - 1;
+            for(int i = 0; i < 4; ++i) {
+                offsets[axis][static_cast<size_t>(i)] =
+                    grid_offset(axis, static_cast<size_t>(std::clamp(lower - 1 + i, 0, last)));
+            }
+            weights[axis] = {{0.5 * (-t3 + 2.0 * t2 - t),
+                              0.5 * (3.0 * t3 - 5.0 * t2 + 2.0),
+                              0.5 * (-3.0 * t3 + 4.0 * t2 + t),
+                              0.5 * (t3 - t2)}};
+        }
+
+        std::array<double, N> values{};
+        for(size_t i = 0; i < 4; ++i) {
+            for(size_t j = 0; j < 4; ++j) {
+                const auto weight = weights[0][i] * weights[1][j];
+                const auto* line = field.data() + offsets[0][i] + offsets[1][j];
+                for(size_t k = 0; k < 4; ++k) {
+                    const auto weight_z = weight * weights[2][k];
+                    const auto* point = line + offsets[2][k];
+                    for(size_t n = 0; n < N; ++n) {
+                        values[n] += weight_z * static_cast<double>(point[n]);
+                    }
+                }
+            }
+        }
+        return values;
+    }
+
+    /**
+     * Threads without a selected copy, e.g. threads not pinned to a NUMA node, read from the original field grid
+     */
+    template <typename T, size_t N> template <typename S> const std::vector<S>& DetectorField<T, N>::get_grid() const {
+        const auto& field = std::get<std::shared_ptr<std::vector<S>>>(field_);
+        if(replicas_ == nullptr) {
+            return *field;
+        }
+
+        auto index = FieldReplicas::threadIndex();
+        if(index < 0 || static_cast<size_t>(index) >= replicas_->size()) {
+            return *field;
+        }
+
+        auto& replica = std::get<std::shared_ptr<std::vector<S>>>((*replicas_)[static_cast<size_t>(index)].field);
+        std::call_once((*replicas_)[static_cast<size_t>(index)].flag,
+                       [&field, &replica]() { replica = std::make_shared<std::vector<S>>(*field); });
+        return *replica;
+    }
+
+    /**
+     * @throws std::invalid_argument If the field bins are incorrect, the thickness domain is outside the sensor or the
+     * interpolation is not available for this field
+     *
+     * Bricked grids are stored in a copy of the field owned by this detector field.
+     */
+    template <typename T, size_t N>
+    template <typename S>
+    void DetectorField<T, N>::setGrid(std::shared_ptr<std::vector<S>> field, // NOLINT
                                       std::array<size_t, 3> bins,
                                       std::array<double, 3> size,
                                       FieldMapping mapping,
                                       std::array<double, 2> scales,
                                       std::array<double, 2> offset,
-                                      std::pair<double, double> thickness_domain) {
+                                      std::pair<double, double> thickness_domain,
+                                      FieldInterpolation interpolation,
+                                      FieldLayout layout) {
+        static_assert(std::is_same_v<S, double> || std::is_same_v<S, float>,
+                      "field grids can only be stored in single or double precision");
         set_grid_parameters(bins, size, mapping, scales, offset, std::move(thickness_domain));
 
         if(bins[0] * bins[1] * bins[2] * N != field->size()) {
             throw std::invalid_argument("field does not match the given dimensions");
         }
+        if(interpolation == FieldInterpolation::CUBIC && N != 1) {
+            throw std::invalid_argument("cubic interpolation is only available for scalar fields");
+        }
+        interpolation_ = interpolation;
+
+        // Calculate the strides of the grid points along the three axes, within a brick for bricked grids
+        layout_ = layout;
+        if(layout_ == FieldLayout::BRICKED) {
+            // Axes with fewer bins than the brick size, e.g. of two-dimensional fields, are not padded
+            std::array<size_t, 3> edges{};
+            std::array<size_t, 3> bricks{};
+            for(size_t axis = 0; axis < 3; ++axis) {
+                edges[axis] = std::min(bins[axis], brick_size_);
+                bricks[axis] = (bins[axis] + brick_size_ - 1) / brick_size_;
+            }
+            const auto brick_volume = edges[0] * edges[1] * edges[2] * N;
+            brick_strides_ = {{bricks[1] * bricks[2] * brick_volume, bricks[2] * brick_volume, brick_volume}};
+            strides_ = {{edges[1] * edges[2] * N, edges[2] * N, N}};
+
+            // Reorder the field, bins of incomplete bricks at the upper edges of the grid are never read and left empty
+            auto bricked = std::make_shared<std::vector<S>>(bricks[0] * bricks[1] * bricks[2] * brick_volume);
+            size_t index = 0;
+            for(size_t x = 0; x < bins[0]; ++x) {
+                for(size_t y = 0; y < bins[1]; ++y) {
+                    const auto line = grid_offset(0, x) + grid_offset(1, y);
+                    for(size_t z = 0; z < bins[2]; ++z) {
+                        std::copy_n(field->begin() + static_cast<std::ptrdiff_t>(index),
+                                    N,
+                                    bricked->begin() + static_cast<std::ptrdiff_t>(line + grid_offset(2, z)));
+                        index += N;
+                    }
+                }
+            }
+            field = std::move(bricked);
+        } else {
+            strides_ = {{bins[1] * bins[2] * N, bins[2] * N, N}};
+        }
+
+        // Store the field, replacing a previous grid of either precision
+        field_ = {};
+        std::get<std::shared_ptr<std::vector<S>>>(field_) = std::move(field);
 
-        // Store the field
-        field_ = std::move(field);
+        // Prepare copies of the field if requested
+        replicas_ =
+            (FieldReplicas::count() > 0 ? std::make_shared<std::vector<Replica>>(FieldReplicas::count()) : nullptr);
     };
 
     template <typename T, size_t N>
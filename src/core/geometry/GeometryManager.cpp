@@ -40,6 +40,7 @@ GeometryManager::GeometryManager() : closed_{false} {}
  */
 void GeometryManager::load(ConfigManager* conf_manager, RandomNumberGenerator& seeder) {
     // Set up a random number generator and seed it with the global seed:
+    random_generator_.setEngine(seeder.getEngine());
     random_generator_.seed(seeder());
 
     // Loop over all defined detectors
@@ -0,0 +1,144 @@
+/**
+ * @file
+ * @brief Non-virtual geometry kernel for rectangular pixel detector models
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_RECTANGULAR_PIXEL_GEOMETRY_H
+#define ALLPIX_RECTANGULAR_PIXEL_GEOMETRY_H
+
+#include <cmath>
+#include <optional>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <Math/Point3D.h>
+#include <Math/Vector3D.h>
+
+#include "PixelDetectorModel.hpp"
+
+namespace allpix {
+    /**
+     * @ingroup DetectorModels
+     * @brief Geometry queries of a rectangular pixel detector model without virtual dispatch
+     *
+     * The kernel caches the sensor box, the pixel pitch and the matrix dimensions of a \ref PixelDetectorModel and
+     * implements the geometry queries used in the step loops of propagation modules inline. It provides the same interface
+     * as \ref DetectorModel for these queries, such that code can be written as a template over the geometry type and
+     * specialized at compile time. Contrary to \ref DetectorModel::isWithinImplant, implants are returned by pointer
+     * instead of as copy.
+     *
+     * Only models of exactly the type \ref PixelDetectorModel can be represented, since the derived models change the
+     * layout of the pixel grid. The kernel references the implants of the model, which therefore has to outlive it.
+     */
+    class RectangularPixelGeometry {
+    public:
+        /**
+         * @brief Create the geometry kernel for a detector model
+         * @param model Detector model to represent
+         * @return Geometry kernel, or no value if the model is not a rectangular pixel detector model
+         */
+        static std::optional<RectangularPixelGeometry> create(const DetectorModel& model) {
+            if(typeid(model) != typeid(PixelDetectorModel)) {
+                return std::nullopt;
+            }
+            return RectangularPixelGeometry(model);
+        }
+
+        /**
+         * @brief Get size of the sensor
+         * @return Size of the sensor
+         */
+        const ROOT::Math::XYZVector& getSensorSize() const { return sensor_size_; }
+
+        /**
+         * @brief Returns if a local position is within the sensitive device
+         * @param local_pos Position in local coordinates of the detector model
+         * @return True if a local position is within the sensor, false otherwise
+         */
+        bool isWithinSensor(const ROOT::Math::XYZPoint& local_pos) const {
+            return (2 * std::fabs(local_pos.z() - sensor_center_.z()) <= sensor_size_.z()) &&
+                   (2 * std::fabs(local_pos.y() - sensor_center_.y()) <= sensor_size_.y()) &&
+                   (2 * std::fabs(local_pos.x() - sensor_center_.x()) <= sensor_size_.x());
+        }
+
+        /**
+         * @brief Returns if a local position is within any of the implants of the pixel it belongs to
+         * @param local_pos Position in local coordinates of the detector model
+         * @return Pointer to the implant the position lies in, or a null pointer if it is not within any implant
+         */
+        const DetectorModel::Implant* isWithinImplant(const ROOT::Math::XYZPoint& local_pos) const {
+            if(implants_->empty()) {
+                return nullptr;
+            }
+
+            auto [xpixel, ypixel] = getPixelIndex(local_pos);
+            auto in_pixel_pos = local_pos - getPixelCenter(xpixel, ypixel);
+            for(const auto& implant : *implants_) {
+                if(implant.contains(in_pixel_pos)) {
+                    return &implant;
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * @brief Returns if a set of pixel coordinates is within the grid of pixels defined for the device
+         * @param x X- (or column-) coordinate to be checked
+         * @param y Y- (or row-) coordinate to be checked
+         * @return True if pixel coordinates are within the pixel grid, false otherwise
+         */
+        bool isWithinMatrix(const int x, const int y) const { return !(x < 0 || x >= pixels_x_ || y < 0 || y >= pixels_y_); }
+
+        /**
+         * @brief Returns if a position is within the grid of pixels defined for the device
+         * @param position Position in local coordinates of the detector model
+         * @return True if position within the pixel grid, false otherwise
+         */
+        bool isWithinMatrix(const ROOT::Math::XYZPoint& position) const {
+            return !(position.x() < -0.5 * pitch_x_ || position.x() > (pixels_x_ - 0.5) * pitch_x_ ||
+                     position.y() < -0.5 * pitch_y_ || position.y() > (pixels_y_ - 0.5) * pitch_y_);
+        }
+
+        /**
+         * @brief Returns a pixel center in local coordinates
+         * @param x X- (or column-) coordinate of the pixel
+         * @param y Y- (or row-) coordinate of the pixel
+         * @return Coordinates of the pixel center
+         */
+        ROOT::Math::XYZPoint getPixelCenter(const int x, const int y) const { return {pitch_x_ * x, pitch_y_ * y, 0}; }
+
+        /**
+         * @brief Return X,Y indices of a pixel corresponding to a local position in a sensor.
+         * @param local_pos Position in local coordinates of the detector model
+         * @return X,Y pixel indices
+         *
+         * @note No checks are performed on whether these indices represent an existing pixel or are within the pixel matrix.
+         */
+        std::pair<int, int> getPixelIndex(const ROOT::Math::XYZPoint& local_pos) const {
+            return {static_cast<int>(std::lround(local_pos.x() / pitch_x_)),
+                    static_cast<int>(std::lround(local_pos.y() / pitch_y_))};
+        }
+
+    private:
+        explicit RectangularPixelGeometry(const DetectorModel& model)
+            : sensor_center_(model.getSensorCenter()), sensor_size_(model.getSensorSize()),
+              pitch_x_(model.getPixelSize().x()), pitch_y_(model.getPixelSize().y()),
+              pixels_x_(static_cast<int>(model.getNPixels().x())), pixels_y_(static_cast<int>(model.getNPixels().y())),
+              implants_(&model.getImplants()) {}
+
+        ROOT::Math::XYZPoint sensor_center_;
+        ROOT::Math::XYZVector sensor_size_;
+        double pitch_x_, pitch_y_;
+        int pixels_x_, pixels_y_;
+        const std::vector<DetectorModel::Implant>* implants_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_RECTANGULAR_PIXEL_GEOMETRY_H */
@@ -31,3 +31,8 @@ BaseMessage::~BaseMessage() = default;
 std::vector<std::reference_wrapper<Object>> BaseMessage::getObjectArray() {
     throw MessageWithoutObjectException(typeid(*this));
 }
+
+/**
+ * @throws MessageWithoutObjectException If this method is not overridden
+ */
+const std::type_info& BaseMessage::getObjectType() const { throw MessageWithoutObjectException(typeid(*this)); }
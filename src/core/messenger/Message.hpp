@@ -12,6 +12,10 @@
 #ifndef ALLPIX_MESSAGE_H
 #define ALLPIX_MESSAGE_H
 
+#include <memory>
+#include <mutex>
+#include <typeinfo>
+#include <utility>
 #include <vector>
 
 #include "core/geometry/Detector.hpp"
@@ -54,6 +58,14 @@ namespace allpix {
          */
         virtual std::vector<std::reference_wrapper<Object>> getObjectArray();
 
+        /**
+         * @brief Get the type of the objects stored in this message without accessing them
+         * @return Type information of the stored objects
+         *
+         * Allows to filter messages by their object type without creating objects which are only produced on request.
+         */
+        virtual const std::type_info& getObjectType() const;
+
     protected:
         /**
          * @brief Construct a general message not linked to a detector
@@ -69,6 +81,93 @@ namespace allpix {
         std::shared_ptr<const Detector> detector_;
     };
 
+    /**
+     * @brief Entries grouped by the pixel nearest to their local position
+     *
+     * Pixels are sorted by their index, and the entries of the pixel n are given by the positions in \ref entries between
+     * the offsets n and n+1. Entries of the same pixel keep their original order. Entries with their nearest pixel outside
+     * of the pixel matrix are listed separately.
+     */
+    template <typename E> struct PixelGroups {
+        std::vector<Pixel::Index> pixels;
+        std::vector<size_t> offsets;
+        std::vector<E> entries;
+        std::vector<E> outside;
+    };
+
+    /**
+     * @brief Group a list of entries by the pixel nearest to their local position
+     * @param model Model of the detector the entries belong to
+     * @param count Number of entries
+     * @param entry Function returning the local position and the entry stored in the groups for a position in the list
+     * @return Groups of entries
+     */
+    template <typename E, typename F>
+    PixelGroups<E> group_by_pixel(const DetectorModel& model, size_t count, const F& entry);
+
+    /**
+     * @brief Read-only index of the objects of a message grouped by the pixel nearest to their local position
+     *
+     * Pixels are sorted by their index, and the objects of every pixel are kept in the order of the message. Objects with
+     * their nearest pixel outside of the pixel matrix are listed separately. The index only references the objects and is
+     * valid for as long as the message exists.
+     */
+    template <typename T> class PixelIndex {
+    public:
+        /**
+         * @brief Range of objects assigned to a single pixel
+         */
+        class Range {
+        public:
+            Range(const T* const* first, const T* const* last) : first_(first), last_(last) {}
+            const T* const* begin() const { return first_; }
+            const T* const* end() const { return last_; }
+            size_t size() const { return static_cast<size_t>(last_ - first_); }
+
+        private:
+            const T* const* first_;
+            const T* const* last_;
+        };
+
+        /**
+         * @brief Construct the index for a list of objects
+         * @param data List of objects providing their local position via getLocalPosition()
+         * @param model Model of the detector the objects belong to
+         */
+        PixelIndex(const std::vector<T>& data, const DetectorModel& model);
+
+        /**
+         * @brief Get the number of pixels with at least one object
+         * @return Number of pixels
+         */
+        size_t size() const { return groups_.pixels.size(); }
+
+        /**
+         * @brief Get the index of a pixel
+         * @param n Position of the pixel in the index, smaller than \ref size
+         * @return Pixel index
+         */
+        const Pixel::Index& pixel(size_t n) const { return groups_.pixels[n]; }
+
+        /**
+         * @brief Get the objects assigned to a pixel
+         * @param n Position of the pixel in the index, smaller than \ref size
+         * @return Range of pointers to the objects
+         */
+        Range objects(size_t n) const {
+            return {groups_.entries.data() + groups_.offsets[n], groups_.entries.data() + groups_.offsets[n + 1]};
+        }
+
+        /**
+         * @brief Get the objects with their nearest pixel outside of the pixel matrix
+         * @return List of pointers to the objects
+         */
+        const std::vector<const T*>& outside() const { return groups_.outside; }
+
+    private:
+        PixelGroups<const T*> groups_;
+    };
+
     /**
      * @brief Generic class for all messages
      *
@@ -104,6 +203,22 @@ namespace allpix {
          */
         std::vector<std::reference_wrapper<Object>> getObjectArray() override;
 
+        /**
+         * @brief Get the type of the objects stored in this message
+         * @return Type information of the stored objects (throws if the message does not contain objects)
+         */
+        const std::type_info& getObjectType() const override;
+
+        /**
+         * @brief Get the objects of this message grouped by the pixel nearest to their local position
+         * @return Index of the objects of this message
+         * @throws MessageWithoutDetectorException If the message is not bound to a detector
+         *
+         * The index is built on the first call and shared by all receivers of the message, such that several modules
+         * grouping the same objects by pixel only pay for it once. It can be called concurrently by several modules.
+         */
+        const PixelIndex<T>& getPixelIndex() const;
+
     private:
         /**
          * @brief Returns object array for messages containing objects
@@ -132,6 +247,10 @@ namespace allpix {
         void skip_object_cleanup(typename std::enable_if<!std::is_base_of<Object, U>::value>::type* = nullptr) {}
 
         std::vector<T> data_;
+
+        // Index of the objects by pixel, only built on request
+        mutable std::once_flag pixel_index_flag_;
+        mutable std::unique_ptr<PixelIndex<T>> pixel_index_;
     };
 } // namespace allpix
 
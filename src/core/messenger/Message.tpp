@@ -9,9 +9,49 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <algorithm>
+
 #include "core/messenger/exceptions.h"
 
 namespace allpix {
+    /**
+     * The entries are sorted by their nearest pixel with a stable sort, such that entries of the same pixel keep their
+     * order. The pixel ranges are then given by offsets into the sorted list of entries.
+     */
+    template <typename E, typename F>
+    PixelGroups<E> group_by_pixel(const DetectorModel& model, size_t count, const F& entry) {
+        PixelGroups<E> groups;
+        std::vector<std::pair<Pixel::Index, E>> entries;
+        entries.reserve(count);
+        for(size_t n = 0; n < count; ++n) {
+            auto [position, value] = entry(n);
+            auto [xpixel, ypixel] = model.getPixelIndex(position);
+            if(model.isWithinMatrix(xpixel, ypixel)) {
+                entries.emplace_back(Pixel::Index(xpixel, ypixel), value);
+            } else {
+                groups.outside.push_back(value);
+            }
+        }
+        std::stable_sort(
+            entries.begin(), entries.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+        groups.entries.reserve(entries.size());
+        for(size_t n = 0; n < entries.size(); ++n) {
+            if(n == 0 || entries[n].first != entries[n - 1].first) {
+                groups.pixels.push_back(entries[n].first);
+                groups.offsets.push_back(n);
+            }
+            groups.entries.push_back(entries[n].second);
+        }
+        groups.offsets.push_back(groups.entries.size());
+        return groups;
+    }
+
+    template <typename T>
+    PixelIndex<T>::PixelIndex(const std::vector<T>& data, const DetectorModel& model)
+        : groups_(group_by_pixel<const T*>(
+              model, data.size(), [&data](size_t n) { return std::make_pair(data[n].getLocalPosition(), &data[n]); })) {}
+
     template <typename T> Message<T>::Message(std::vector<T> data) : BaseMessage(), data_(std::move(data)) {}
     template <typename T>
     Message<T>::Message(std::vector<T> data, const std::shared_ptr<const Detector>& detector)
@@ -21,6 +61,17 @@ namespace allpix {
 
     template <typename T> const std::vector<T>& Message<T>::getData() const { return data_; }
 
+    template <typename T> const PixelIndex<T>& Message<T>::getPixelIndex() const {
+        std::call_once(pixel_index_flag_, [this]() {
+            auto detector = getDetector();
+            if(detector == nullptr) {
+                throw MessageWithoutDetectorException(typeid(*this));
+            }
+            pixel_index_ = std::make_unique<PixelIndex<T>>(data_, *detector->getModel());
+        });
+        return *pixel_index_;
+    }
+
     /**
      * Chooses between internal \ref get_object_array implementations dependent on the type of the object (if it drives from
      * \ref allpix::Object).
@@ -28,6 +79,15 @@ namespace allpix {
     template <typename T> std::vector<std::reference_wrapper<Object>> Message<T>::getObjectArray() {
         return get_object_array();
     }
+    /**
+     * @throws MessageWithoutObjectException If the message does not contain types derived from \ref allpix::Object
+     */
+    template <typename T> const std::type_info& Message<T>::getObjectType() const {
+        if constexpr(!std::is_base_of<Object, T>::value) {
+            throw MessageWithoutObjectException(typeid(*this));
+        }
+        return typeid(T);
+    }
     /**
      * Pass the data as a copy of the internal vector referencing the same data as the internal vector
      *
@@ -11,6 +11,7 @@
 
 #include "Messenger.hpp"
 
+#include <cassert>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -43,6 +44,13 @@ static bool check_send(Module* source, BaseMessage* message, BaseDelegate* deleg
     return true;
 }
 
+// Check if the detector of the message matches the detector of a delegate, given by its pointer to avoid reference counting
+static bool check_detector(const Detector* message_detector, const Detector* delegate_detector) {
+    return delegate_detector == nullptr ||
+           (message_detector != nullptr &&
+            (message_detector == delegate_detector || message_detector->getName() == delegate_detector->getName()));
+}
+
 /**
  * Messages should be bound during construction, so this function only gives useful information outside the constructor
  */
@@ -109,6 +117,16 @@ void Messenger::add_delegate(const std::type_info& message_type,
     delegate_to_iterator_.emplace(delegate_iter->get(),
                                   std::make_tuple(std::type_index(message_type), message_name, delegate_iter));
 
+    // Assign the message slot of the module for this message type, shared by all its delegates of the same type
+    auto slot = module_slots_[module].emplace(std::type_index(message_type), slot_count_);
+    if(slot.second) {
+        ++slot_count_;
+    }
+    delegate->slot_ = slot.first->second;
+
+    // Routes need to be compiled again to include the new delegate
+    compiled_ = false;
+
     // Add delegate to the module itself
     module->add_delegate(this, delegate_iter->get());
 }
@@ -125,8 +143,129 @@ void Messenger::remove_delegate(BaseDelegate* delegate) {
     }
     delegates_[std::get<0>(iter->second)][std::get<1>(iter->second)].erase(std::get<2>(iter->second));
     delegate_to_iterator_.erase(iter);
+
+    // The compiled routes should not reference the removed delegate anymore
+    compiled_ = false;
+    routes_.clear();
+}
+
+/**
+ * Every message type with specific receivers is assigned an index, with an additional index for all other message types
+ * which can only be received by listeners of the base message. The routes follow the order of dispatching of the messenger,
+ * i.e. first the listeners of the output name, then generic listeners and finally listeners of unnamed messages, each
+ * starting with the specific receivers before the receivers of the base message. Only the detector of the message is checked
+ * when dispatching, since it is not known before.
+ */
+void Messenger::compileRoutes(const std::vector<Module*>& modules, bool parallel_modules) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    type_ids_.clear();
+    for(const auto& delegates : delegates_) {
+        if(delegates.first != typeid(BaseMessage)) {
+            type_ids_.emplace(delegates.first, type_ids_.size());
+        }
+    }
+    auto type_count = type_ids_.size() + 1;
+
+    routes_.assign(modules.size() * type_count, {});
+    output_names_.clear();
+    for(size_t module_id = 0; module_id < modules.size(); ++module_id) {
+        auto* module = modules[module_id];
+        module->messenger_id_ = module_id;
+
+        auto output = module->get_configuration().get<std::string>("output");
+        std::vector<std::string> ids = {output, "*"};
+        if(output.empty()) {
+            ids.emplace_back("?");
+        }
+
+        for(const auto& [type, type_id] : type_ids_) {
+            for(const auto& id : ids) {
+                append_routes(routes_[module_id * type_count + type_id], module, &type, id);
+            }
+        }
+        for(const auto& id : ids) {
+            append_routes(routes_[module_id * type_count + type_count - 1], module, nullptr, id);
+        }
+        output_names_.push_back(std::move(output));
+    }
+
+    parallel_modules_ = parallel_modules;
+    compiled_ = true;
+    LOG(TRACE) << "Compiled message routes for " << modules.size() << " modules and " << type_ids_.size()
+               << " message types into " << slot_count_ << " message slots";
+}
+
+void Messenger::append_routes(std::vector<std::pair<BaseDelegate*, const Detector*>>& routes,
+                              const Module* source,
+                              const std::type_index* type,
+                              const std::string& id) {
+    auto append = [&](std::type_index type_idx) {
+        auto type_iterator = delegates_.find(type_idx);
+        if(type_iterator == delegates_.end()) {
+            return;
+        }
+        auto name_iterator = type_iterator->second.find(id);
+        if(name_iterator == type_iterator->second.end()) {
+            return;
+        }
+        for(const auto& delegate : name_iterator->second) {
+            // Messages are never dispatched to the module itself
+            if(delegate->getUniqueName() != source->getUniqueName()) {
+                routes.emplace_back(delegate.get(), delegate->getDetector().get());
+            }
+        }
+    };
+
+    if(type != nullptr) {
+        append(*type);
+    }
+    append(typeid(BaseMessage));
+}
+
+const std::vector<std::pair<BaseDelegate*, const Detector*>>* Messenger::get_routes(const Module* source,
+                                                                                    std::type_index type) const {
+    if(!compiled_ || source->messenger_id_ >= output_names_.size()) {
+        return nullptr;
+    }
+
+    auto type_count = type_ids_.size() + 1;
+    auto type_iterator = type_ids_.find(type);
+    auto type_id = (type_iterator != type_ids_.end() ? type_iterator->second : type_count - 1);
+    return &routes_[source->messenger_id_ * type_count + type_id];
+}
+
+bool Messenger::canReceive(const Module* source, const Module* receiver) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(!compiled_ || source->messenger_id_ >= output_names_.size()) {
+        return false;
+    }
+
+    // Named messages can be received by any module, which thus has to wait for the source
+    if(source->named_dispatch_) {
+        return true;
+    }
+
+    auto source_detector = source->getDetector();
+    auto receiver_detector = receiver->getDetector();
+    if(source_detector != nullptr && receiver_detector != nullptr &&
+       source_detector->getName() != receiver_detector->getName()) {
+        return false;
+    }
+
+    auto type_count = type_ids_.size() + 1;
+    for(size_t type_id = 0; type_id < type_count; ++type_id) {
+        for(const auto& route : routes_[source->messenger_id_ * type_count + type_id]) {
+            if(route.first->getUniqueName() == receiver->getUniqueName()) {
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
+size_t Messenger::get_slot(const Module* module, std::type_index type) const { return module_slots_.at(module).at(type); }
+
 std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> Messenger::fetchFilteredMessages(Module* module,
                                                                                                    Event* event) {
     try {
@@ -138,30 +277,52 @@ std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> Messenger::fet
     }
 }
 
-LocalMessenger::LocalMessenger(Messenger& global_messenger) : global_messenger_(global_messenger) {}
+LocalMessenger::LocalMessenger(Messenger& global_messenger, std::pmr::memory_resource* resource)
+    : global_messenger_(global_messenger), messages_(global_messenger.getSlotCount(), resource), sent_messages_(resource) {}
 
 void LocalMessenger::dispatchMessage(Module* source, std::shared_ptr<BaseMessage> message, std::string name) { // NOLINT
-    // Get the name of the output message
-    if(name == "-") {
-        name = source->get_configuration().get<std::string>("output");
-    }
-
+    std::lock_guard<std::mutex> lock(mutex_);
+    const BaseMessage* inst = message.get();
     bool send = false;
 
-    // Send messages to specific listeners
-    send = dispatchMessage(source, message, name, name) || send;
+    // Use the compiled routes for messages dispatched with the output name of the module
+    const auto* routes = (name == "-" ? global_messenger_.get_routes(source, typeid(*inst)) : nullptr);
+    if(routes != nullptr) {
+        const auto& output_name = global_messenger_.output_names_[source->messenger_id_];
+        auto detector = message->getDetector();
+        for(const auto& [delegate, delegate_detector] : *routes) {
+            if(check_detector(detector.get(), delegate_detector)) {
+                LOG(TRACE) << "Sending message " << allpix::demangle(typeid(*inst).name()) << " from "
+                           << source->getUniqueName() << " to " << delegate->getUniqueName();
+                process(delegate, message, output_name);
+                send = true;
+            }
+        }
+    } else {
+        // Get the name of the output message
+        auto output = source->get_configuration().get<std::string>("output");
+        if(name == "-") {
+            name = output;
+        } else if(name != output && global_messenger_.parallel_modules_ && !source->named_dispatch_) {
+            // The receivers of this message could already be running in parallel to the source
+            throw InvalidModuleActionException("Module " + source->getUniqueName() + " dispatched message with name '" +
+                                               name + "' without allowing named dispatch, required for parallel modules");
+        }
+
+        // Send messages to specific listeners
+        send = dispatchMessage(source, message, name, name) || send;
 
-    // Send to generic listeners
-    send = dispatchMessage(source, message, name, "*") || send;
+        // Send to generic listeners
+        send = dispatchMessage(source, message, name, "*") || send;
 
-    // Send to listeners of unnamed messages
-    if(name.empty()) {
-        send = dispatchMessage(source, message, name, "?") || send;
+        // Send to listeners of unnamed messages
+        if(name.empty()) {
+            send = dispatchMessage(source, message, name, "?") || send;
+        }
     }
 
     // Display a TRACE log message if the message is send to no receiver
     if(!send) {
-        const BaseMessage* inst = message.get();
         LOG(TRACE) << "Dispatched message " << allpix::demangle(typeid(*inst).name()) << " from " << source->getUniqueName()
                    << " has no receivers!";
     }
@@ -170,6 +331,13 @@ void LocalMessenger::dispatchMessage(Module* source, std::shared_ptr<BaseMessage
     sent_messages_.emplace_back(message);
 }
 
+void LocalMessenger::process(BaseDelegate* delegate, const std::shared_ptr<BaseMessage>& message, const std::string& name) {
+    assert(delegate->getSlot() < messages_.size());
+    auto& slot = messages_[delegate->getSlot()];
+    slot.received = true;
+    delegate->process(message, name, slot.messages);
+}
+
 bool LocalMessenger::dispatchMessage(Module* source,
                                      const std::shared_ptr<BaseMessage>& message,
                                      const std::string& name,
@@ -190,10 +358,7 @@ bool LocalMessenger::dispatchMessage(Module* source,
                 if(check_send(source, message.get(), delegate.get())) {
                     LOG(TRACE) << "Sending message " << allpix::demangle(type_idx.name()) << " from "
                                << source->getUniqueName() << " to " << delegate->getUniqueName();
-                    // Construct BaseMessage where message should be stored
-                    auto& dest = messages_[delegate->getUniqueName()][type_idx];
-
-                    delegate->process(message, name, dest);
+                    process(delegate.get(), message, name);
                     send = true;
                 }
             }
@@ -210,8 +375,7 @@ bool LocalMessenger::dispatchMessage(Module* source,
                 if(check_send(source, message.get(), delegate.get())) {
                     LOG(TRACE) << "Sending message " << allpix::demangle(type_idx.name()) << " from "
                                << source->getUniqueName() << " to generic listener " << delegate->getUniqueName();
-                    auto& dest = messages_[delegate->getUniqueName()][typeid(BaseMessage)];
-                    delegate->process(message, name, dest);
+                    process(delegate.get(), message, name);
                     send = true;
                 }
             }
@@ -222,29 +386,21 @@ bool LocalMessenger::dispatchMessage(Module* source,
 }
 
 std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> LocalMessenger::fetchFilteredMessages(Module* module) {
-    const std::type_index type_idx = typeid(BaseMessage);
-    return messages_.at(module->getUniqueName()).at(type_idx).filter_multi;
+    return get_messages(module, typeid(BaseMessage)).filter_multi;
 }
 
 bool LocalMessenger::isSatisfied(BaseDelegate* delegate) const {
-    // check our records for messages for this module
-    const std::string name = delegate->getUniqueName();
-    auto messages_iter = messages_.find(name);
-    if(messages_iter == messages_.end()) {
-        return false;
-    }
-
-    // check if this delegate is in our records
-    auto delegate_iter = global_messenger_.delegate_to_iterator_.find(delegate);
-    if(delegate_iter == global_messenger_.delegate_to_iterator_.end()) {
-        throw std::out_of_range("delegate not found in listeners");
-    }
+    auto slot = delegate->getSlot();
+    return slot < messages_.size() && messages_[slot].received;
+}
 
-    // check our records for messages for this delegate
-    auto iter = messages_iter->second.find(std::get<0>(delegate_iter->second));
-    if(iter == messages_iter->second.end()) {
-        return false;
+/**
+ * @throws std::out_of_range If the module is not bound to this message type or has not received a message of this type
+ */
+const DelegateTypes& LocalMessenger::get_messages(const Module* module, std::type_index type) const {
+    const auto& slot = messages_.at(global_messenger_.get_slot(module, type));
+    if(!slot.received) {
+        throw std::out_of_range("no message received");
     }
-
-    return true;
+    return slot.messages;
 }
@@ -13,10 +13,14 @@
 #define ALLPIX_MESSENGER_H
 
 #include <list>
+#include <map>
 #include <memory>
+#include <memory_resource>
+#include <mutex>
 #include <typeindex>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Message.hpp"
 #include "core/module/Event.hpp"
@@ -157,6 +161,36 @@ namespace allpix {
          */
         bool isSatisfied(BaseDelegate* delegate, Event* event) const;
 
+        /**
+         * @brief Compile the registered delegates into flat routing tables for dispatching messages
+         * @param modules All module instantiations, which can dispatch messages
+         * @param parallel_modules If module instantiations of an event are executed in parallel according to \ref canReceive
+         *
+         * For every module and message type, the list of receiving delegates for messages dispatched with the default output
+         * name of the module is precomputed, such that dispatching does not require any lookup by name. Should be called
+         * after all modules have been constructed, the tables are invalidated when delegates are added or removed.
+         */
+        void compileRoutes(const std::vector<Module*>& modules, bool parallel_modules = false);
+
+        /**
+         * @brief Return the number of message slots, i.e. of distinct combinations of receiving module and message type
+         * @return Number of message slots required per event
+         */
+        size_t getSlotCount() const { return slot_count_; }
+
+        /**
+         * @brief Check if a module can receive messages dispatched by another module
+         * @param source Module dispatching the messages
+         * @param receiver Module receiving the messages
+         * @return True if any delegate of the receiver is bound to messages of the source, false otherwise
+         * @warning Only valid after the routes have been compiled with \ref compileRoutes
+         *
+         * Messages dispatched by a module bound to a detector are assumed to be bound to the same detector. The receivers of
+         * modules dispatching messages with names other than their output parameter are not known before dispatching, all
+         * following modules are therefore assumed to receive messages from them.
+         */
+        bool canReceive(const Module* source, const Module* receiver) const;
+
     private:
         /**
          * @brief Add a delegate to the listeners
@@ -178,9 +212,50 @@ namespace allpix {
             std::map<BaseDelegate*,
                      std::tuple<std::type_index, std::string, std::list<std::shared_ptr<BaseDelegate>>::iterator>>;
 
+        /**
+         * @brief Get the message slot of a module for a message type
+         * @param module Receiving module
+         * @param type Type of the message the module is bound to
+         * @return Index of the message slot
+         * @throws std::out_of_range If the module is not bound to this message type
+         */
+        size_t get_slot(const Module* module, std::type_index type) const;
+
+        /**
+         * @brief Append the receivers of a message type for a message name in the order of dispatching
+         * @param routes List of receivers to append to
+         * @param source Module dispatching the message
+         * @param type Type of the message, or nullptr for a type without specific receivers
+         * @param id Name the delegates are registered for
+         */
+        void append_routes(std::vector<std::pair<BaseDelegate*, const Detector*>>& routes,
+                           const Module* source,
+                           const std::type_index* type,
+                           const std::string& id);
+
+        /**
+         * @brief Get the compiled receivers of a message dispatched with the default output name of the source
+         * @param source Module dispatching the message
+         * @param type Type of the message
+         * @return List of receiving delegates and their detectors, or nullptr if the routes have not been compiled
+         */
+        const std::vector<std::pair<BaseDelegate*, const Detector*>>* get_routes(const Module* source,
+                                                                                 std::type_index type) const;
+
         DelegateMap delegates_;
         DelegateIteratorMap delegate_to_iterator_;
 
+        // Message slots of every receiving module, indexed by message type
+        std::map<const Module*, std::map<std::type_index, size_t>> module_slots_;
+        size_t slot_count_{0};
+
+        // Compiled routing tables, indexed by the module and the index of the message type
+        bool compiled_{false};
+        bool parallel_modules_{false};
+        std::unordered_map<std::type_index, size_t> type_ids_;
+        std::vector<std::vector<std::pair<BaseDelegate*, const Detector*>>> routes_;
+        std::vector<std::string> output_names_;
+
         mutable std::mutex mutex_;
     };
 
@@ -192,7 +267,13 @@ namespace allpix {
      */
     class LocalMessenger {
     public:
-        explicit LocalMessenger(Messenger& global_messenger);
+        /**
+         * @brief Construct the local messenger of an event
+         * @param global_messenger Messenger holding the delegates of all modules
+         * @param resource Memory resource used for the bookkeeping of the messages of the event
+         */
+        explicit LocalMessenger(Messenger& global_messenger,
+                                std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
         void dispatchMessage(Module* source, std::shared_ptr<BaseMessage> message, std::string name);
         bool dispatchMessage(Module* source,
@@ -225,11 +306,36 @@ namespace allpix {
         std::vector<std::pair<std::shared_ptr<BaseMessage>, std::string>> fetchFilteredMessages(Module* module);
 
     private:
+        /**
+         * @brief Pass a message to a delegate, storing it in the message slot of the delegate
+         * @param delegate Receiving delegate
+         * @param message Message to pass
+         * @param name Name of the message
+         */
+        void process(BaseDelegate* delegate, const std::shared_ptr<BaseMessage>& message, const std::string& name);
+
+        /**
+         * @brief Get the messages received by a module for a message type
+         * @param module Receiving module
+         * @param type Type of the message the module is bound to
+         * @return Received messages
+         * @throws std::out_of_range If no message of this type has been received by the module
+         */
+        const DelegateTypes& get_messages(const Module* module, std::type_index type) const;
+
         // The global messenger which contains the shared delegate information
         const Messenger& global_messenger_;
 
-        std::unordered_map<std::string, std::unordered_map<std::type_index, DelegateTypes>> messages_;
-        std::vector<std::shared_ptr<BaseMessage>> sent_messages_;
+        // Received messages for every message slot of the global messenger
+        struct MessageSlot {
+            bool received{false};
+            DelegateTypes messages;
+        };
+        std::pmr::vector<MessageSlot> messages_;
+        std::pmr::vector<std::shared_ptr<BaseMessage>> sent_messages_;
+
+        // Modules of the same event can dispatch messages concurrently
+        std::mutex mutex_;
     };
 } // namespace allpix
 
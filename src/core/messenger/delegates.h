@@ -18,6 +18,7 @@
 #define ALLPIX_DELEGATE_H
 
 #include <cassert>
+#include <cstddef>
 #include <memory>
 #include <typeinfo>
 #include <utility>
@@ -29,6 +30,8 @@
 // TODO [doc] This should partly move to a source file
 
 namespace allpix {
+    class Messenger;
+
     /**
      * @ingroup Delegates
      * @brief Container of the different delegate types
@@ -55,7 +58,8 @@ namespace allpix {
         REQUIRED = (1 << 0),        ///< Require a message before running a module
         ALLOW_OVERWRITE = (1 << 1), ///< Allow overwriting a previous message
         IGNORE_NAME = (1 << 2),     ///< Listen to all ignoring message name (equal to * as a input configuration parameter)
-        UNNAMED_ONLY = (1 << 3)     ///< Listen to all messages without explicit name (equal to ? as configuration parameter)
+        UNNAMED_ONLY = (1 << 3),    ///< Listen to all messages without explicit name (equal to ? as configuration parameter)
+        REQUIRED_ANY = (1 << 4)     ///< Require at least one of the messages bound with this flag before running a module
     };
     /**
      * @ingroup Delegates
@@ -118,6 +122,12 @@ namespace allpix {
          */
         bool isRequired() const { return (getFlags() & MsgFlags::REQUIRED) != MsgFlags::NONE; }
 
+        /**
+         * @brief Check if delegate has one of several alternative required messages
+         * @return True if at least one of the messages with this flag is required, false otherwise
+         */
+        bool isRequiredAny() const { return (getFlags() & MsgFlags::REQUIRED_ANY) != MsgFlags::NONE; }
+
         /**
          * @brief Get the flags for this delegate
          * @return Message flags
@@ -144,8 +154,18 @@ namespace allpix {
          */
         virtual void process(std::shared_ptr<BaseMessage> msg, std::string name, DelegateTypes& dest) = 0;
 
+        /**
+         * @brief Get the index of the storage for the messages received by this delegate in every event
+         * @return Index of the message slot assigned by the \ref Messenger
+         */
+        size_t getSlot() const { return slot_; }
+
     protected:
         MsgFlags flags_;
+
+    private:
+        friend class Messenger;
+        size_t slot_{0};
     };
 
     /**
@@ -58,6 +58,25 @@ namespace allpix {
         }
     };
 
+    /**
+     * @ingroup Exceptions
+     * @brief Message is not bound to a detector
+     *
+     * Raised if information requiring the detector of a message is requested for a message without detector
+     */
+    class MessageWithoutDetectorException : public RuntimeError {
+    public:
+        /**
+         * @brief Constructs an error for a message without a detector
+         * @param message Type of the message
+         */
+        explicit MessageWithoutDetectorException(const std::type_info& message) {
+            error_message_ = "Message ";
+            error_message_ += allpix::demangle(message.name());
+            error_message_ += " is not bound to a detector";
+        }
+    };
+
     /**
      * @ingroup Exceptions
      * @brief Trying to fetch a message that wasn't delivered
@@ -24,10 +24,14 @@
 
 using namespace allpix;
 
-std::mutex Event::stats_mutex_;
+namespace {
+    // Random engine replacing the one of the event for the calling thread
+    thread_local RandomNumberGenerator* thread_random_engine = nullptr;
+} // namespace
 
-Event::Event(Messenger& messenger, uint64_t event_num, uint64_t seed) : number(event_num), seed_(seed) {
-    local_messenger_ = std::make_unique<LocalMessenger>(messenger);
+Event::Event(Messenger& messenger, uint64_t event_num, uint64_t seed)
+    : number(event_num), seed_(seed), arena_(std::make_shared<EventArena>()) {
+    local_messenger_ = std::make_unique<LocalMessenger>(messenger, arena_.get());
 }
 
 void Event::set_and_seed_random_engine(RandomNumberGenerator* random_engine) {
@@ -36,6 +40,9 @@ void Event::set_and_seed_random_engine(RandomNumberGenerator* random_engine) {
 }
 
 RandomNumberGenerator& Event::getRandomEngine() {
+    if(thread_random_engine != nullptr) {
+        return *thread_random_engine;
+    }
     if(random_engine_ == nullptr) {
         throw InvalidEventStateException("No PRNG available");
     }
@@ -43,18 +50,24 @@ RandomNumberGenerator& Event::getRandomEngine() {
 }
 
 void Event::store_random_engine_state() {
-    if(random_engine_ != nullptr && state_.rdbuf()->in_avail() == 0) {
+    if(random_engine_ != nullptr && !state_stored_) {
         LOG(PRNG) << "Storing PRNG state in event";
-        state_ << *random_engine_;
+        if(state_ == nullptr) {
+            state_ = std::make_unique<RandomNumberGenerator::Snapshot>();
+        }
+        random_engine_->saveState(*state_);
+        state_stored_ = true;
     }
 }
 
 void Event::restore_random_engine_state() {
-    if(random_engine_ != nullptr && state_.rdbuf()->in_avail() != 0) {
+    if(random_engine_ != nullptr && state_stored_) {
         LOG(PRNG) << "Restoring PRNG state from event";
-        state_ >> *random_engine_;
-        state_.clear();
+        random_engine_->restoreState(*state_);
+        state_stored_ = false;
     }
 }
 
+void Event::set_thread_random_engine(RandomNumberGenerator* random_engine) { thread_random_engine = random_engine; }
+
 LocalMessenger* Event::get_local_messenger() const { return local_messenger_.get(); }
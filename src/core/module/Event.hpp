@@ -17,9 +17,11 @@
 #include <list>
 #include <map>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
 #include <vector>
 
+#include "EventArena.hpp"
 #include "core/utils/prng.h"
 
 namespace allpix {
@@ -80,6 +82,23 @@ namespace allpix {
          */
         uint64_t getSeed() const { return seed_; }
 
+        /**
+         * @brief Access the memory resource of this event for temporary containers
+         * @return Memory resource released in one go when the event is destroyed
+         *
+         * Containers using this resource, e.g. `std::pmr::vector`, should not outlive the event.
+         */
+        std::pmr::memory_resource* getMemoryResource() const { return arena_.get(); }
+
+        /**
+         * @brief Create an object, typically a message, in the memory arena of this event
+         * @param args Arguments passed to the constructor of the object
+         * @return Shared pointer to the object, which keeps the arena alive if it outlives the event
+         */
+        template <typename T, typename... Args> std::shared_ptr<T> makeShared(Args&&... args) {
+            return std::allocate_shared<T>(ArenaAllocator<T>(arena_), std::forward<Args>(args)...);
+        }
+
     private:
         /**
          * @brief Sets the random engine and seed it to be used by this event
@@ -97,14 +116,26 @@ namespace allpix {
          */
         void restore_random_engine_state();
 
+        /**
+         * @brief Use a separate random engine for all events processed by the calling thread, e.g. for a single module
+         * @param random_engine Random engine returned by \ref getRandomEngine, or nullptr to use the engine of the event
+         *
+         * This allows module instantiations of the same event running concurrently to draw from independent sequences.
+         */
+        static void set_thread_random_engine(RandomNumberGenerator* random_engine);
+
         // The random number engine associated with this event
         RandomNumberGenerator* random_engine_{nullptr};
 
         // Seed for random number generator
         uint64_t seed_;
 
-        // State of the random number generator
-        std::stringstream state_;
+        // State of the random number generator, only allocated once the event is rescheduled
+        std::unique_ptr<RandomNumberGenerator::Snapshot> state_;
+        bool state_stored_{false};
+
+        // Memory arena for all objects allocated during this event, needs to outlive the local messenger
+        std::shared_ptr<EventArena> arena_;
 
         /**
          * @brief Returns a pointer to the event local messenger
@@ -113,9 +144,6 @@ namespace allpix {
 
         // Local messenger used to dispatch messages in this event
         std::unique_ptr<LocalMessenger> local_messenger_;
-
-        // Mutex for execution time
-        static std::mutex stats_mutex_;
     };
 
 } // namespace allpix
@@ -0,0 +1,21 @@
+/**
+ * @file
+ * @brief Implementation of the memory arena of an event
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "EventArena.hpp"
+
+using namespace allpix;
+
+EventArena::EventArena(std::size_t initial_size) : resource_(initial_size, std::pmr::new_delete_resource()) {}
+
+void* EventArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    std::lock_guard<std::mutex> lock{mutex_};
+    return resource_.allocate(bytes, alignment);
+}
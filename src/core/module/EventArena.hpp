@@ -0,0 +1,82 @@
+/**
+ * @file
+ * @brief Definition of the memory arena of an event
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_EVENT_ARENA_H
+#define ALLPIX_EVENT_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+
+namespace allpix {
+    /**
+     * @brief Monotonic memory resource holding the data allocated during a single event
+     *
+     * Memory is taken from large chunks which grow geometrically and are only returned to the system when the arena is
+     * destroyed, deallocations are ignored. This replaces many small allocations by a few large ones, which reduces the
+     * contention on the allocator between the workers. The first chunk is only allocated on first use. Allocations are
+     * guarded by a mutex, since an event may be processed by different threads.
+     */
+    class EventArena : public std::pmr::memory_resource {
+    public:
+        /**
+         * @brief Construct the arena
+         * @param initial_size Size of the first chunk of memory in bytes
+         */
+        explicit EventArena(std::size_t initial_size = 64 * 1024);
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* /*pointer*/, std::size_t /*bytes*/, std::size_t /*alignment*/) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        std::mutex mutex_;
+        std::pmr::monotonic_buffer_resource resource_;
+    };
+
+    /**
+     * @brief Allocator drawing from an event arena and keeping it alive as long as allocated objects exist
+     *
+     * This allows to allocate objects which may outlive the event itself, such as messages kept by a module, from the arena.
+     */
+    template <typename T> class ArenaAllocator {
+    public:
+        using value_type = T;
+
+        /**
+         * @brief Construct the allocator
+         * @param arena Arena to allocate from
+         */
+        explicit ArenaAllocator(std::shared_ptr<EventArena> arena) noexcept : arena_(std::move(arena)) {}
+
+        /**
+         * @brief Construct the allocator from an allocator of another type sharing the same arena
+         * @param other Allocator to rebind
+         */
+        template <typename U> ArenaAllocator(const ArenaAllocator<U>& other) noexcept : arena_(other.arena_) {} // NOLINT
+
+        T* allocate(std::size_t n) { return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T))); }
+        void deallocate(T* pointer, std::size_t n) noexcept { arena_->deallocate(pointer, n * sizeof(T), alignof(T)); }
+
+        template <typename U> bool operator==(const ArenaAllocator<U>& other) const noexcept {
+            return arena_ == other.arena_;
+        }
+        template <typename U> bool operator!=(const ArenaAllocator<U>& other) const noexcept { return !(*this == other); }
+
+    private:
+        template <typename U> friend class ArenaAllocator;
+
+        std::shared_ptr<EventArena> arena_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_EVENT_ARENA_H */
@@ -0,0 +1,143 @@
+/**
+ * @file
+ * @brief Implementation of ordered event pipeline for sequential modules
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "EventPipeline.hpp"
+
+#include <cassert>
+#include <chrono>
+
+#include "core/utils/log.h"
+
+using namespace allpix;
+
+EventPipeline::EventPipeline(size_t capacity,
+                             uint64_t first_id,
+                             std::function<bool()> abort_function,
+                             const std::function<void()>& consumer_init_function,
+                             const std::function<void()>& consumer_finalize_function)
+    : slots_(capacity), next_id_(first_id), abort_function_(std::move(abort_function)) {
+    assert(capacity > 0);
+    consumer_ = std::thread(&EventPipeline::consumer, this, consumer_init_function, consumer_finalize_function);
+}
+
+EventPipeline::~EventPipeline() {
+    interrupt();
+    if(consumer_.joinable()) {
+        consumer_.join();
+    }
+}
+
+/**
+ * The slot of an event is only available once all events up to the capacity of the pipeline before it have been consumed.
+ * Since the wait may depend on events which are never handed over (e.g. if the run is terminated), the abort function is
+ * polled regularly while waiting.
+ */
+bool EventPipeline::push(uint64_t n, Task task) {
+    using namespace std::chrono_literals;
+
+    std::unique_lock<std::mutex> lock{mutex_};
+    assert(n >= next_id_);
+    while(n >= next_id_ + slots_.size() && !interrupted_) {
+        if(push_condition_.wait_for(lock, 100ms) == std::cv_status::timeout && abort_function_ && abort_function_()) {
+            return false;
+        }
+    }
+    if(interrupted_) {
+        return false;
+    }
+
+    // Store the task in the slot of this event and notify the consumer
+    slots_[n % slots_.size()] = std::make_pair(true, std::move(task));
+    size_++;
+    lock.unlock();
+    pop_condition_.notify_one();
+    return true;
+}
+
+void EventPipeline::close() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    closed_ = true;
+    lock.unlock();
+    pop_condition_.notify_all();
+
+    if(consumer_.joinable()) {
+        consumer_.join();
+    }
+}
+
+void EventPipeline::interrupt() {
+    std::unique_lock<std::mutex> lock{mutex_};
+    interrupted_ = true;
+    lock.unlock();
+    pop_condition_.notify_all();
+    push_condition_.notify_all();
+}
+
+void EventPipeline::checkException() {
+    if(has_exception_) {
+        interrupt();
+        if(consumer_.joinable()) {
+            consumer_.join();
+        }
+        Log::setSection("");
+        std::rethrow_exception(exception_ptr_);
+    }
+}
+
+/**
+ * If the pipeline is closed, the consumer stops at the first event which has not been handed over. Events following this
+ * gap cannot be processed in sequence and are dropped. If an exception is thrown by a module, it is saved to propagate in the
+ * main thread and the pipeline is interrupted.
+ */
+void EventPipeline::consumer(const std::function<void()>& initialize_function,
+                             const std::function<void()>& finalize_function) {
+    try {
+        // Initialize the consumer
+        if(initialize_function) {
+            initialize_function();
+        }
+
+        std::unique_lock<std::mutex> lock{mutex_};
+        while(!interrupted_) {
+            // Wait for the next event in sequence
+            auto& slot = slots_[next_id_ % slots_.size()];
+            pop_condition_.wait(lock, [this, &slot]() { return slot.first || closed_ || interrupted_; });
+            if(!slot.first) {
+                break;
+            }
+
+            // Execute the task outside of the lock
+            auto task = std::move(slot.second);
+            slot = std::make_pair(false, Task());
+            lock.unlock();
+            if(task) {
+                task();
+            }
+            lock.lock();
+
+            // Release the slot and notify possible workers waiting for it
+            ++next_id_;
+            ++consumed_;
+            size_--;
+            push_condition_.notify_all();
+        }
+        lock.unlock();
+
+        // Execute the cleanup function at the end of run
+        if(finalize_function) {
+            finalize_function();
+        }
+    } catch(...) {
+        exception_ptr_ = std::current_exception();
+        has_exception_ = true;
+        interrupt();
+    }
+}
@@ -0,0 +1,141 @@
+/**
+ * @file
+ * @brief Definition of ordered event pipeline for sequential modules
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_EVENT_PIPELINE_H
+#define ALLPIX_EVENT_PIPELINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace allpix {
+    /**
+     * @brief Ordered hand-off of events to a dedicated consumer thread
+     *
+     * Workers push the remaining work of an event into a ring buffer at the slot given by its event number. A single
+     * consumer thread executes these tasks strictly in the sequence of event numbers. Workers only block if their event is
+     * too far ahead of the next event to be consumed, which limits the number of events held in the pipeline to its
+     * capacity.
+     *
+     * The consumer thread is not registered with the \ref ThreadPool and therefore shares the thread number of the main
+     * thread, which does not execute any module during the event loop.
+     */
+    class EventPipeline {
+    public:
+        using Task = std::function<void()>;
+
+        /**
+         * @brief Construct the pipeline and start the consumer thread
+         * @param capacity Maximum number of events held in the pipeline
+         * @param first_id Event number of the first event to be consumed
+         * @param abort_function Function checked by blocked workers, returning true if they should stop waiting
+         * @param consumer_init_function Function run by the consumer thread to initialize
+         * @param consumer_finalize_function Function run by the consumer thread to cleanup
+         */
+        EventPipeline(size_t capacity,
+                      uint64_t first_id,
+                      std::function<bool()> abort_function,
+                      const std::function<void()>& consumer_init_function = nullptr,
+                      const std::function<void()>& consumer_finalize_function = nullptr);
+
+        /// @{
+        /**
+         * @brief Copying the pipeline is not allowed
+         */
+        EventPipeline(const EventPipeline& rhs) = delete;
+        EventPipeline& operator=(const EventPipeline& rhs) = delete;
+        /// @}
+
+        /**
+         * @brief Interrupt the pipeline and wait for the consumer thread to finish on destruction
+         */
+        ~EventPipeline();
+
+        /**
+         * @brief Hand the remaining work of an event to the consumer, will block if the event is too far ahead
+         * @param n Event number
+         * @param task Task to execute for this event, or an empty task if the event does not reach the pipeline
+         * @return If the push was successful, false if the pipeline was interrupted or the abort function returned true
+         */
+        bool push(uint64_t n, Task task);
+
+        /**
+         * @brief Consume all events handed over in sequence so far and stop the consumer thread
+         */
+        void close();
+
+        /**
+         * @brief Stop the consumer after the current event and release all blocked workers
+         */
+        void interrupt();
+
+        /**
+         * @brief Check if the calling thread is the consumer thread of this pipeline
+         * @return True if called from the consumer thread, false otherwise
+         */
+        bool isConsumerThread() const { return std::this_thread::get_id() == consumer_.get_id(); }
+
+        /**
+         * @brief Return the number of events currently held in the pipeline
+         * @return Number of events waiting to be consumed
+         */
+        size_t size() const { return size_; }
+
+        /**
+         * @brief Return the number of events consumed in sequence so far, including events without a task
+         * @return Number of consumed events
+         */
+        uint64_t consumed() const { return consumed_; }
+
+        /**
+         * @brief Return if the consumer thread has thrown an exception
+         * @return True if an exception is pending, false otherwise
+         */
+        bool failed() const { return has_exception_; }
+
+        /**
+         * @brief Check if the consumer thread has thrown an exception
+         * @throw Exception thrown by the consumer thread, if any
+         */
+        void checkException();
+
+    private:
+        /**
+         * @brief Internal function of the consumer thread executing the events in sequence
+         * @param initialize_function Function to initialize the thread
+         * @param finalize_function   Function to finalize the thread
+         */
+        void consumer(const std::function<void()>& initialize_function, const std::function<void()>& finalize_function);
+
+        std::vector<std::pair<bool, Task>> slots_;
+        uint64_t next_id_;
+        std::atomic_size_t size_{0};
+        std::atomic<uint64_t> consumed_{0};
+        std::function<bool()> abort_function_;
+
+        bool closed_{false};
+        bool interrupted_{false};
+        std::mutex mutex_{};
+        std::condition_variable push_condition_;
+        std::condition_variable pop_condition_;
+        std::thread consumer_;
+
+        std::atomic_bool has_exception_{false};
+        std::exception_ptr exception_ptr_{nullptr};
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_EVENT_PIPELINE_H */
@@ -30,6 +30,13 @@ Module::Module(Configuration& config, std::shared_ptr<Detector> detector)
  * @note The remove_delegate can throw in theory, but this should never happen in practice
  */
 Module::~Module() {
+    // Stop referencing the section headers of this module in the logger, e.g. after an exception was thrown
+    const auto* section = Log::getSectionReference();
+    if(section == &log_context_.initialize_section || section == &log_context_.thread_section ||
+       section == &log_context_.run_section || section == &log_context_.finalize_section) {
+        Log::setSection("");
+    }
+
     // Remove delegates
     try {
         for(auto& delegate : delegates_) {
@@ -134,6 +141,12 @@ Module::createOutputFile(const std::string& pathname, const std::string& extensi
     return file;
 }
 
+void Module::runBatch(const std::vector<Event*>& events) {
+    for(auto* event : events) {
+        run(event);
+    }
+}
+
 /**
  * @throws InvalidModuleActionException If this method is called from the constructor or destructor
  * @warning Cannot be used from the constructor, because the instantiation logic has not finished yet
@@ -165,9 +178,23 @@ void Module::set_config_manager(ConfigManager* conf_manager) { conf_manager_ = c
 void Module::add_delegate(Messenger* messenger, BaseDelegate* delegate) { delegates_.emplace_back(messenger, delegate); }
 bool Module::check_delegates(Messenger* messenger, Event* event) {
     // Return false if any delegate is not satisfied
-    return std::all_of(delegates_.cbegin(), delegates_.cend(), [messenger, event](auto& delegate) {
-        return !delegate.second->isRequired() || messenger->isSatisfied(delegate.second, event);
-    });
+    if(!std::all_of(delegates_.cbegin(), delegates_.cend(), [messenger, event](auto& delegate) {
+           return !delegate.second->isRequired() || messenger->isSatisfied(delegate.second, event);
+       })) {
+        return false;
+    }
+
+    // Return false if none of the alternative required delegates is satisfied
+    auto alternatives = false;
+    for(const auto& delegate : delegates_) {
+        if(delegate.second->isRequiredAny()) {
+            if(messenger->isSatisfied(delegate.second, event)) {
+                return true;
+            }
+            alternatives = true;
+        }
+    }
+    return !alternatives;
 }
 
 void SequentialModule::waive_sequence_requirement(bool waive) { sequence_required_ = !waive; }
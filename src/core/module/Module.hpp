@@ -12,11 +12,14 @@
 #ifndef ALLPIX_MODULE_H
 #define ALLPIX_MODULE_H
 
+#include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <limits>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -28,7 +31,9 @@
 #include "core/geometry/Detector.hpp"
 #include "core/messenger/delegates.h"
 #include "core/module/exceptions.h"
+#include "core/utils/log.h"
 #include "core/utils/prng.h"
+#include "objects/Object.hpp"
 
 namespace allpix {
     class Messenger;
@@ -138,6 +143,12 @@ namespace allpix {
          */
         bool multithreadingEnabled() const { return multithreading_; }
 
+        /**
+         * @brief Returns if this module processes batches of events via \ref Module::runBatch
+         * @return True if batch processing is enabled, false otherwise (the default)
+         */
+        bool batchProcessingEnabled() const { return batch_processing_; }
+
         /**
          * @brief Initialize the module for each thread after the global initialization
          * @note Useful to prepare thread local objects
@@ -161,6 +172,16 @@ namespace allpix {
          */
         virtual void run(Event* event) { (void)event; }
 
+        /**
+         * @brief Execute the function of the module for a batch of events at once
+         * @param events Pointers to the events the module is running, all of them satisfy the message requirements
+         * @note Only called if batch processing has been enabled for this module
+         * @warning An \ref AbortEventException thrown from this method aborts all events of the batch
+         *
+         * Calls \ref Module::run for every event of the batch if not overloaded.
+         */
+        virtual void runBatch(const std::vector<Event*>& events);
+
         /**
          * @brief Finalize the module after the event sequence for each thread
          * @note Useful to cleanup thread local objects
@@ -183,6 +204,29 @@ namespace allpix {
          */
         void allow_multithreading() { set_multithreading(true); }
 
+        /**
+         * @brief Enable processing of multiple events at once via \ref Module::runBatch for this module
+         */
+        void allow_batch_processing() { batch_processing_ = true; }
+
+        /**
+         * @brief Allow this module to dispatch messages with names other than its output parameter
+         *
+         * The receivers of named messages are only known when dispatching, the module is therefore executed in order with
+         * all following modules if module instantiations run in parallel.
+         */
+        void allow_named_dispatch() { named_dispatch_ = true; }
+
+        /**
+         * @brief Require the relations between objects received by this module to be kept
+         * @param mode Minimal history of objects accessed by this module
+         *
+         * Should be called in the constructor by all modules accessing related objects, e.g. via getMCParticles() or
+         * getPixelCharge(), or storing them. Relations not required by any module are dropped. The resulting history mode is
+         * fixed before the modules are initialized.
+         */
+        void require_history(HistoryMode mode) { history_mode_ = std::max(history_mode_, mode); }
+
         /**
          * @brief Get the module configuration for internal use
          * @return Configuration of the module
@@ -203,6 +247,19 @@ namespace allpix {
         ModuleIdentifier get_identifier() const { return identifier_; }
         ModuleIdentifier identifier_;
 
+        /**
+         * @brief Module specific log settings and section headers for the different stages, precomputed by the manager
+         */
+        struct LogContext {
+            std::optional<LogLevel> level;
+            std::optional<LogFormat> format;
+            std::string initialize_section;
+            std::string thread_section;
+            std::string run_section;
+            std::string finalize_section;
+        };
+        LogContext log_context_;
+
         /**
          * @brief Set the output ROOT directory for this module
          * @param directory ROOT directory for storage
@@ -238,6 +295,9 @@ namespace allpix {
 
         std::vector<std::pair<Messenger*, BaseDelegate*>> delegates_;
 
+        // Index of this module in the compiled routing tables of the messenger
+        size_t messenger_id_{std::numeric_limits<size_t>::max()};
+
         std::shared_ptr<Detector> detector_;
 
         /**
@@ -246,6 +306,12 @@ namespace allpix {
         void set_multithreading(bool multithreading) { multithreading_ = multithreading; }
         bool multithreading_{false};
 
+        bool batch_processing_{false};
+
+        bool named_dispatch_{false};
+
+        HistoryMode history_mode_{HistoryMode::NONE};
+
         /**
          * @brief Checks if object is instance of SequentialModule class
          */
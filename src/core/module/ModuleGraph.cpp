@@ -0,0 +1,174 @@
+/**
+ * @file
+ * @brief Implementation of the dependency graph of module instantiations within an event
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "ModuleGraph.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <queue>
+
+using namespace allpix;
+
+namespace {
+    // Shared state of an execution, kept alive by offered jobs which might only start after the execution has finished
+    struct ExecutionState {
+        std::mutex mutex;
+        std::condition_variable condition;
+
+        // Ready nodes, started in the order of the module chain
+        std::priority_queue<size_t, std::vector<size_t>, std::greater<>> ready;
+        // Number of unfinished dependencies of every node in the range
+        std::vector<size_t> pending;
+        size_t begin{0};
+        size_t end{0};
+
+        size_t running{0};
+        size_t offered{0};
+        size_t helpers{0};
+        bool abort{false};
+        std::exception_ptr exception;
+
+        // Only accessed while a node is running, which keeps the executing thread waiting
+        const ModuleGraph::NodeFunction* run{nullptr};
+        const std::vector<std::vector<size_t>>* successors{nullptr};
+    };
+
+    /*
+     * Start the next ready node if any, the lock is released while the node is running
+     */
+    bool run_next(ExecutionState& state, std::unique_lock<std::mutex>& lock) {
+        if(state.abort || state.ready.empty()) {
+            return false;
+        }
+
+        auto node = state.ready.top();
+        state.ready.pop();
+        ++state.running;
+        lock.unlock();
+
+        bool success = false;
+        std::exception_ptr exception;
+        try {
+            success = (*state.run)(node);
+        } catch(...) {
+            exception = std::current_exception();
+        }
+
+        lock.lock();
+        --state.running;
+        if(exception && !state.exception) {
+            state.exception = exception;
+        }
+        if(!success) {
+            state.abort = true;
+        } else {
+            // Release the successors of the node within the executed range
+            for(auto successor : (*state.successors)[node]) {
+                if(successor < state.end && --state.pending[successor - state.begin] == 0) {
+                    state.ready.push(successor);
+                }
+            }
+        }
+        state.condition.notify_all();
+        return true;
+    }
+} // namespace
+
+ModuleGraph::ModuleGraph(std::vector<std::vector<size_t>> dependencies)
+    : dependencies_(std::move(dependencies)), successors_(dependencies_.size()) {
+    for(size_t node = 0; node < dependencies_.size(); ++node) {
+        for(auto dependency : dependencies_[node]) {
+            assert(dependency < node);
+            successors_[dependency].push_back(node);
+        }
+    }
+}
+
+size_t ModuleGraph::width() const {
+    // Assign every node to the level after its deepest dependency and count the nodes per level
+    std::vector<size_t> levels(dependencies_.size(), 0);
+    std::vector<size_t> nodes_per_level(dependencies_.size() + 1, 0);
+    for(size_t node = 0; node < dependencies_.size(); ++node) {
+        for(auto dependency : dependencies_[node]) {
+            levels[node] = std::max(levels[node], levels[dependency] + 1);
+        }
+        ++nodes_per_level[levels[node]];
+    }
+    return *std::max_element(nodes_per_level.begin(), nodes_per_level.end());
+}
+
+/**
+ * The calling thread offers ready nodes to other threads whenever more nodes are ready than jobs have been offered, up to
+ * the maximum number of helpers. Offered jobs execute ready nodes until none is left and return immediately if all nodes
+ * have already been taken. The calling thread itself executes ready nodes and only waits if nodes are running on other
+ * threads.
+ */
+bool ModuleGraph::execute(
+    size_t begin, size_t end, const NodeFunction& run, const SpawnFunction& spawn, size_t max_helpers) const {
+    assert(begin <= end && end <= dependencies_.size());
+
+    auto state = std::make_shared<ExecutionState>();
+    state->begin = begin;
+    state->end = end;
+    state->run = &run;
+    state->successors = &successors_;
+    state->pending.resize(end - begin, 0);
+    for(size_t node = begin; node < end; ++node) {
+        auto& pending = state->pending[node - begin];
+        pending = static_cast<size_t>(std::count_if(dependencies_[node].begin(),
+                                                    dependencies_[node].end(),
+                                                    [begin](size_t dependency) { return dependency >= begin; }));
+        if(pending == 0) {
+            state->ready.push(node);
+        }
+    }
+
+    bool can_spawn = static_cast<bool>(spawn) && max_helpers > 0;
+    std::unique_lock<std::mutex> lock{state->mutex};
+    while(true) {
+        // Offer the ready nodes beyond the one taken by this thread to other threads
+        while(can_spawn && !state->abort && state->ready.size() > state->offered + 1 && state->helpers < max_helpers) {
+            ++state->offered;
+            ++state->helpers;
+            lock.unlock();
+            can_spawn = spawn([state]() {
+                std::unique_lock<std::mutex> helper_lock{state->mutex};
+                --state->offered;
+                while(run_next(*state, helper_lock)) {
+                }
+                --state->helpers;
+            });
+            lock.lock();
+            if(!can_spawn) {
+                --state->offered;
+                --state->helpers;
+            }
+        }
+
+        if(run_next(*state, lock)) {
+            continue;
+        }
+        if(state->running == 0) {
+            break;
+        }
+        state->condition.wait(lock);
+    }
+    lock.unlock();
+
+    if(state->exception) {
+        std::rethrow_exception(state->exception);
+    }
+    return !state->abort;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file
+ * @brief Definition of the dependency graph of module instantiations within an event
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_MODULE_GRAPH_H
+#define ALLPIX_MODULE_GRAPH_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace allpix {
+    /**
+     * @brief Directed acyclic graph of the module instantiations of an event
+     *
+     * Every node is a module instantiation, identified by its position in the module chain, and depends on a set of
+     * earlier nodes which have to be finished before it can start. Nodes without pending dependencies are executed by the
+     * thread processing the event, while additional ready nodes are offered to idle workers of the thread pool. The
+     * executing thread only waits for nodes which are already running on another thread, such that the execution can never
+     * deadlock on a busy thread pool: if no worker picks up an offered node, it is executed by the thread of the event.
+     */
+    class ModuleGraph {
+    public:
+        /**
+         * @brief Function executing a node, returning false if the event should be aborted
+         */
+        using NodeFunction = std::function<bool(size_t)>;
+        /**
+         * @brief Function offering a job to idle workers, returning false if it could not be submitted
+         */
+        using SpawnFunction = std::function<bool(std::function<void()>)>;
+
+        /**
+         * @brief Construct an empty graph
+         */
+        ModuleGraph() = default;
+
+        /**
+         * @brief Construct the graph from the dependencies of every node
+         * @param dependencies List of earlier nodes every node depends on
+         */
+        explicit ModuleGraph(std::vector<std::vector<size_t>> dependencies);
+
+        /**
+         * @brief Return the number of nodes in the graph
+         * @return Number of nodes
+         */
+        size_t size() const { return dependencies_.size(); }
+
+        /**
+         * @brief Return the maximum number of nodes which can be executed at the same time
+         * @return Width of the graph, estimated from the nodes without dependencies on each other at the same depth
+         */
+        size_t width() const;
+
+        /**
+         * @brief Execute a continuous range of nodes respecting their dependencies
+         * @param begin First node to execute
+         * @param end Node after the last one to execute
+         * @param run Function executing a node
+         * @param spawn Function to offer ready nodes to other threads, may be empty to execute all nodes on this thread
+         * @param max_helpers Maximum number of jobs offered to other threads at the same time
+         * @return False if the execution of a node requested to abort the event, true otherwise
+         *
+         * Dependencies on nodes before the range are considered to be finished. After a node requested to abort, no new
+         * nodes are started and the function returns once all running nodes have finished. Exceptions thrown by a node
+         * stop the execution in the same way and are rethrown by this function.
+         */
+        bool execute(size_t begin,
+                     size_t end,
+                     const NodeFunction& run,
+                     const SpawnFunction& spawn = nullptr,
+                     size_t max_helpers = 0) const;
+
+    private:
+        std::vector<std::vector<size_t>> dependencies_;
+        std::vector<std::vector<size_t>> successors_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_MODULE_GRAPH_H */
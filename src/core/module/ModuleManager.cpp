@@ -17,11 +17,14 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstring>
 #include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <limits>
 #include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 
@@ -34,6 +37,7 @@
 #include "core/geometry/GeometryManager.hpp"
 #include "core/messenger/Messenger.hpp"
 #include "core/utils/log.h"
+#include "core/utils/text.h"
 
 // Common prefix for all modules
 // TODO [doc] Should be provided by the build system
@@ -481,42 +485,79 @@ std::vector<std::pair<ModuleIdentifier, Module*>> ModuleManager::create_detector
 }
 
 // Helper functions to set the module specific log settings if necessary
-std::tuple<LogLevel, LogFormat, std::string, uint64_t> ModuleManager::set_module_before(const std::string& name,
-                                                                                        const Configuration& config,
-                                                                                        const std::string& prefix,
-                                                                                        const uint64_t event) {
-    // Set new log level if necessary
-    LogLevel prev_level = Log::getReportingLevel();
+Module::LogContext ModuleManager::create_log_context(const std::string& name, const Configuration& config) {
+    Module::LogContext context;
+
+    // Parse module specific log level
     if(config.has("log_level")) {
         auto log_level_string = config.get<std::string>("log_level");
         std::transform(log_level_string.begin(), log_level_string.end(), log_level_string.begin(), ::toupper);
         try {
-            LogLevel log_level = Log::getLevelFromString(log_level_string);
-            if(log_level != prev_level) {
-                LOG(TRACE) << "Local log level is set to " << log_level_string;
-                Log::setReportingLevel(log_level);
-            }
+            context.level = Log::getLevelFromString(log_level_string);
         } catch(std::invalid_argument& e) {
             throw InvalidValueError(config, "log_level", e.what());
         }
     }
 
-    // Set new log format if necessary
-    LogFormat prev_format = Log::getFormat();
+    // Parse module specific log format
     if(config.has("log_format")) {
         auto log_format_string = config.get<std::string>("log_format");
         std::transform(log_format_string.begin(), log_format_string.end(), log_format_string.begin(), ::toupper);
         try {
-            LogFormat log_format = Log::getFormatFromString(log_format_string);
-            if(log_format != prev_format) {
-                LOG(TRACE) << "Local log format is set to " << log_format_string;
-                Log::setFormat(log_format);
-            }
+            context.format = Log::getFormatFromString(log_format_string);
         } catch(std::invalid_argument& e) {
             throw InvalidValueError(config, "log_format", e.what());
         }
     }
 
+    // Section names of the different stages
+    context.initialize_section = "I:" + name;
+    context.thread_section = "T:" + name;
+    context.run_section = "R:" + name;
+    context.finalize_section = "F:" + name;
+
+    return context;
+}
+
+std::pair<LogLevel, LogFormat> ModuleManager::apply_log_context(const Module::LogContext& context) {
+    // Set new log level if necessary
+    LogLevel prev_level = Log::getReportingLevel();
+    if(context.level.has_value() && context.level.value() != prev_level) {
+        LOG(TRACE) << "Local log level is set to " << Log::getStringFromLevel(context.level.value());
+        Log::setReportingLevel(context.level.value());
+    }
+
+    // Set new log format if necessary
+    LogFormat prev_format = Log::getFormat();
+    if(context.format.has_value() && context.format.value() != prev_format) {
+        LOG(TRACE) << "Local log format is set to " << Log::getStringFromFormat(context.format.value());
+        Log::setFormat(context.format.value());
+    }
+
+    return std::make_pair(prev_level, prev_format);
+}
+
+void ModuleManager::reset_log_context(LogLevel level, LogFormat format) {
+    // Reset the previous log level
+    if(Log::getReportingLevel() != level) {
+        Log::setReportingLevel(level);
+        LOG(TRACE) << "Reset log level to global level of " << Log::getStringFromLevel(level);
+    }
+
+    // Reset the previous log format
+    if(Log::getFormat() != format) {
+        Log::setFormat(format);
+        LOG(TRACE) << "Reset log format to global level of " << Log::getStringFromFormat(format);
+    }
+}
+
+std::tuple<LogLevel, LogFormat, std::string, uint64_t> ModuleManager::set_module_before(const std::string& name,
+                                                                                        const Configuration& config,
+                                                                                        const std::string& prefix,
+                                                                                        const uint64_t event) {
+    // Set new log level and format if necessary
+    auto prev_settings = apply_log_context(create_log_context(name, config));
+
     // Set new section name
     auto prev_section = Log::getSection();
     Log::setSection(prefix + name);
@@ -525,25 +566,12 @@ std::tuple<LogLevel, LogFormat, std::string, uint64_t> ModuleManager::set_module
     auto prev_event = Log::getEventNum();
     Log::setEventNum(event);
 
-    return std::make_tuple(prev_level, prev_format, prev_section, prev_event);
+    return std::make_tuple(prev_settings.first, prev_settings.second, prev_section, prev_event);
 }
 
 void ModuleManager::set_module_after(std::tuple<LogLevel, LogFormat, std::string, uint64_t> prev) {
-    // Reset the previous log level
-    LogLevel cur_level = Log::getReportingLevel();
-    LogLevel old_level = std::get<0>(prev);
-    if(cur_level != old_level) {
-        Log::setReportingLevel(old_level);
-        LOG(TRACE) << "Reset log level to global level of " << Log::getStringFromLevel(old_level);
-    }
-
-    // Reset the previous log format
-    LogFormat cur_format = Log::getFormat();
-    LogFormat old_format = std::get<1>(prev);
-    if(cur_format != old_format) {
-        Log::setFormat(old_format);
-        LOG(TRACE) << "Reset log format to global level of " << Log::getStringFromFormat(old_format);
-    }
+    // Reset the previous log level and format
+    reset_log_context(std::get<0>(prev), std::get<1>(prev));
 
     // Reset section name
     Log::setSection(std::get<2>(prev));
@@ -552,6 +580,96 @@ void ModuleManager::set_module_after(std::tuple<LogLevel, LogFormat, std::string
     Log::setEventNum(std::get<3>(prev));
 }
 
+/**
+ * The section header is only referenced to avoid copying it, and the log level and format are only changed if they differ
+ * from the current settings.
+ */
+std::tuple<LogLevel, LogFormat, const std::string*, uint64_t>
+ModuleManager::set_module_before(const Module::LogContext& context, const std::string& section, const uint64_t event) {
+    // Set new log level and format if necessary
+    auto prev_settings = apply_log_context(context);
+
+    // Set new section name
+    const auto* prev_section = Log::getSectionReference();
+    Log::setSectionReference(&section);
+
+    // Set new event number:
+    auto prev_event = Log::getEventNum();
+    Log::setEventNum(event);
+
+    return std::make_tuple(prev_settings.first, prev_settings.second, prev_section, prev_event);
+}
+
+void ModuleManager::set_module_after(const std::tuple<LogLevel, LogFormat, const std::string*, uint64_t>& prev) {
+    // Reset the previous log level and format
+    reset_log_context(std::get<0>(prev), std::get<1>(prev));
+
+    // Reset section name
+    Log::setSectionReference(std::get<2>(prev));
+
+    // Reset event number
+    Log::setEventNum(std::get<3>(prev));
+}
+
+/**
+ * The size is given as a number followed by an optional unit (B, kB, MB, GB or TB), where the units are interpreted as
+ * powers of 1024. A size of zero disables the memory budget.
+ */
+static size_t get_memory_size(const Configuration& config, const std::string& key) {
+    auto str = config.get<std::string>(key, "0");
+    try {
+        size_t pos = 0;
+        auto value = std::stod(str, &pos);
+        auto unit = allpix::transform(allpix::trim(str.substr(pos)), ::toupper);
+        if(!unit.empty() && unit.back() == 'B') {
+            unit.pop_back();
+        }
+        const std::string prefixes = "KMGT";
+        double multiplier = 1;
+        if(!unit.empty()) {
+            auto prefix = prefixes.find(unit);
+            if(unit.size() != 1 || prefix == std::string::npos) {
+                throw InvalidValueError(config, key, "unknown memory unit, use one of B, kB, MB, GB or TB");
+            }
+            multiplier = std::pow(1024., static_cast<double>(prefix + 1));
+        }
+        if(value < 0) {
+            throw InvalidValueError(config, key, "memory size cannot be negative");
+        }
+        return static_cast<size_t>(value * multiplier);
+    } catch(std::logic_error&) {
+        throw InvalidValueError(config, key, "cannot parse memory size");
+    }
+}
+
+/**
+ * The resident memory is read from the proc filesystem and therefore only available on Linux, zero is returned otherwise
+ */
+static size_t get_resident_memory() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if(statm >> total_pages >> resident_pages) {
+        return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+// Derive the seed of a module instantiation from the seed of the event using the SplitMix64 mixing function
+static uint64_t module_seed(uint64_t event_seed, size_t module_index) {
+    uint64_t value = event_seed + 0x9E3779B97F4A7C15 * (static_cast<uint64_t>(module_index) + 1);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EB;
+    return value ^ (value >> 31);
+}
+
+static std::string memory_to_string(double bytes) {
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(1) << bytes / 1024. / 1024. << "MB";
+    return stream.str();
+}
+
 /**
  * Sets the section header and logging settings before executing the  \ref Module::initialize() function.
  */
@@ -588,6 +706,46 @@ void ModuleManager::initialize() {
             throw InvalidValueError(global_config, "buffer_per_worker", "buffer per worker should be larger than one");
         }
         LOG(STATUS) << "Allocating a total of " << max_buffer_size_ << " event slots for buffered modules";
+
+        // Adapt the number of buffered events to a memory budget if requested
+        event_buffer_memory_ = get_memory_size(global_config, "event_buffer_memory");
+        if(event_buffer_memory_ > 0 && get_resident_memory() == 0) {
+            LOG(WARNING) << "Measuring the memory usage is not supported on this system, ignoring event buffer memory";
+            event_buffer_memory_ = 0;
+        } else if(event_buffer_memory_ > 0) {
+            LOG(STATUS) << "Adapting the number of buffered events to a memory budget of "
+                        << memory_to_string(static_cast<double>(event_buffer_memory_));
+        }
+
+        // Select the strategy to distribute events to the workers
+        scheduler_ = global_config.get<ThreadPool::Scheduler>("scheduler", ThreadPool::Scheduler::FIFO);
+        LOG(STATUS) << "Distributing events to workers using the " << allpix::to_string(scheduler_) << " scheduler";
+
+        // Check if sequential modules at the end of the chain should run on a dedicated thread
+        sequential_pipeline_ = global_config.get<bool>("sequential_pipeline", false);
+
+        // Check if independent module instantiations of the same event should run concurrently
+        parallel_modules_ = global_config.get<bool>("parallel_modules", false);
+
+        // Pin the workers to the CPUs of the system if requested
+        auto affinity = global_config.get<ThreadPool::Affinity>("worker_affinity", ThreadPool::Affinity::NONE);
+        if(!ThreadPool::setAffinity(affinity)) {
+            LOG(WARNING) << "Pinning workers to CPUs is not supported on this system, ignoring worker affinity";
+        } else if(affinity != ThreadPool::Affinity::NONE) {
+            LOG(STATUS) << "Pinning workers to CPUs with " << allpix::to_string(affinity) << " affinity on "
+                        << ThreadPool::numaNodeCount() << " NUMA node(s)";
+        }
+
+        // Replicate read-only field grids for every NUMA node if requested
+        auto numa_replicas = global_config.get<bool>("numa_field_replicas", false);
+        if(numa_replicas && affinity == ThreadPool::Affinity::NONE) {
+            throw InvalidValueError(
+                global_config, "numa_field_replicas", "replication of fields requires workers pinned via worker_affinity");
+        }
+        FieldReplicas::setCount(numa_replicas && ThreadPool::numaNodeCount() > 1 ? ThreadPool::numaNodeCount() : 0);
+        if(FieldReplicas::count() > 0) {
+            LOG(STATUS) << "Replicating field grids on " << ThreadPool::numaNodeCount() << " NUMA nodes";
+        }
     } else {
         // Issue a warning in case MT was requested but we can't actually run in MT
         if(multithreading_flag_ && !can_parallelize_) {
@@ -601,6 +759,19 @@ void ModuleManager::initialize() {
     // Store final number of threads to the config for later reference
     global_config.set<size_t>("workers", number_of_threads_, true);
 
+    // Number of events processed together by the modules before reaching the first sequential module
+    event_batch_size_ = global_config.get<unsigned int>("event_batch_size", 1);
+    if(event_batch_size_ < 1) {
+        throw InvalidValueError(global_config, "event_batch_size", "batch size should be larger than zero");
+    } else if(number_of_threads_ > 0 && event_batch_size_ * number_of_threads_ > max_buffer_size_) {
+        throw InvalidValueError(global_config, "event_batch_size", "batch size should not exceed the buffer per worker");
+    } else if(event_batch_size_ > 1 && parallel_modules_) {
+        throw InvalidValueError(
+            global_config, "event_batch_size", "batches of events cannot be combined with parallel module execution");
+    } else if(event_batch_size_ > 1) {
+        LOG(STATUS) << "Processing events in batches of " << event_batch_size_;
+    }
+
     // Initialize the thread pool with the number of threads
     if(number_of_threads_ > 0) {
         ThreadPool::registerThreadCount(number_of_threads_);
@@ -613,9 +784,25 @@ void ModuleManager::initialize() {
                                                    static_cast<int>(max_buffer_size_),
                                                    0,
                                                    static_cast<double>(max_buffer_size_));
+        if(event_buffer_memory_ > 0) {
+            buffer_depth_ = CreateHistogram<TH1D>("buffer_depth",
+                                                  "Adaptive buffer depth;# event slots;# updates",
+                                                  static_cast<int>(max_buffer_size_),
+                                                  0,
+                                                  static_cast<double>(max_buffer_size_));
+        }
         event_time_ = CreateHistogram<TH1D>("event_time", "processing time per event;time [s];# events", 1000, 0, 10);
+        event_timing_ = std::make_unique<TimingHistogram>(ThreadPool::threadCount());
     }
 
+    // Only keep the relations between objects which are accessed by any of the modules, fixed before their initialization
+    auto history_mode = global_config.get<HistoryMode>("object_history", HistoryMode::NONE);
+    for(auto& module : modules_) {
+        history_mode = std::max(history_mode, module->history_mode_);
+    }
+    Object::setHistoryMode(history_mode);
+    LOG(STATUS) << "Keeping " << allpix::to_string(history_mode) << " history of objects";
+
     auto start_time = std::chrono::steady_clock::now();
     LOG_PROGRESS(STATUS, "INIT_LOOP") << "Initializing " << modules_.size() << " module instantiations";
     for(auto& module : modules_) {
@@ -653,8 +840,9 @@ void ModuleManager::initialize() {
 
         // Get current time
         auto start = std::chrono::steady_clock::now();
-        // Set module specific settings
-        auto old_settings = set_module_before(module->get_identifier().getUniqueName(), module->get_configuration(), "I:");
+        // Precompute module specific log settings for all stages and set them
+        module->log_context_ = create_log_context(module->get_identifier().getUniqueName(), module->get_configuration());
+        auto old_settings = set_module_before(module->log_context_, module->log_context_.initialize_section);
         // Change to our ROOT directory
         module->getROOTDirectory()->cd();
         // Init module
@@ -673,9 +861,37 @@ void ModuleManager::initialize() {
             auto title = module->get_configuration().getName() + " event processing time " +
                          (!identifier.empty() ? "for " + identifier : "") + ";time [s];# events";
             module_event_time_.emplace(module.get(), CreateHistogram<TH1D>(name.c_str(), title.c_str(), 1000, 0, 1));
+            module_event_timing_.emplace(module.get(), std::make_unique<TimingHistogram>(ThreadPool::threadCount()));
         }
     }
     LOG_PROGRESS(STATUS, "INIT_LOOP") << "Initialized " << modules_.size() << " module instantiations";
+
+    // Compile the message routes between all modules, all delegates have been registered at this point
+    std::vector<Module*> modules;
+    modules.reserve(modules_.size());
+    for(auto& module : modules_) {
+        modules.push_back(module.get());
+    }
+    messenger_->compileRoutes(modules, parallel_modules_);
+
+    // Build the dependency graph of the module instantiations from the compiled routes
+    if(parallel_modules_) {
+        std::vector<std::vector<size_t>> dependencies(modules.size());
+        for(size_t node = 0; node < modules.size(); ++node) {
+            for(size_t dependency = 0; dependency < node; ++dependency) {
+                // Modules without detector are kept in order with all following modules
+                if(modules[dependency]->getDetector() == nullptr ||
+                   messenger_->canReceive(modules[dependency], modules[node])) {
+                    dependencies[node].push_back(dependency);
+                }
+            }
+        }
+        module_graph_ = ModuleGraph(std::move(dependencies));
+        module_nodes_.assign(modules_.begin(), modules_.end());
+        LOG(STATUS) << "Running independent module instantiations of an event in parallel, up to " << module_graph_.width()
+                    << " at the same time";
+    }
+
     auto end_time = std::chrono::steady_clock::now();
     initialize_time_ =
         static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
@@ -698,11 +914,14 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
             Log::setReportingLevel(log_level);
             Log::setFormat(log_format);
 
+            // Read the copies of the field grids on the NUMA node the thread has been pinned to
+            FieldReplicas::setThreadIndex(ThreadPool::numaNode());
+
             // Call per-thread initialization of each module
             for(const auto& module : modules_list) {
                 // Set module specific log settings
-                auto old_settings = ModuleManager::set_module_before(
-                    module->get_identifier().getUniqueName(), module->get_configuration(), "T:");
+                auto old_settings =
+                    ModuleManager::set_module_before(module->log_context_, module->log_context_.thread_section);
 
                 LOG(TRACE) << "Initializing thread " << std::this_thread::get_id();
                 module->initializeThread();
@@ -716,8 +935,8 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
     auto finalize_function = [modules_list = modules_]() {
         for(const auto& module : modules_list) {
             // Set module specific log settings
-            auto old_settings = ModuleManager::set_module_before(
-                module->get_identifier().getUniqueName(), module->get_configuration(), "T:");
+            auto old_settings =
+                ModuleManager::set_module_before(module->log_context_, module->log_context_.thread_section);
 
             LOG(TRACE) << "Finalizing thread " << std::this_thread::get_id();
             module->finalizeThread();
@@ -729,8 +948,23 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
 
     // Push 128 events for each worker to maintain enough work
     auto max_queue_size = number_of_threads_ * 128;
-    thread_pool_ = std::make_unique<ThreadPool>(
-        number_of_threads_, max_queue_size, max_buffer_size_, initialize_function, finalize_function);
+    thread_pool_ = std::make_unique<ThreadPool>(number_of_threads_,
+                                                max_queue_size,
+                                                max_buffer_size_,
+                                                initialize_function,
+                                                finalize_function,
+                                                scheduler_,
+                                                event_batch_size_);
+
+    // Start with the smallest buffer and let it grow with the estimate of the memory per event
+    if(event_buffer_memory_ > 0) {
+        baseline_memory_ = get_resident_memory();
+        event_memory_ = 0;
+        max_buffer_depth_ = thread_pool_->setBufferLimit(0);
+        buffer_depth_update_ = std::chrono::steady_clock::now();
+        LOG(TRACE) << "Starting adaptive event buffer with " << max_buffer_depth_ << " event slots and "
+                   << memory_to_string(static_cast<double>(baseline_memory_)) << " of resident memory";
+    }
 
     // Record the run stage total time
     auto start_time = std::chrono::steady_clock::now();
@@ -738,6 +972,7 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
     // Push all events to the thread pool
     std::atomic<uint64_t> finished_events{0};
     std::atomic<uint64_t> aborted_events{0};
+    std::atomic<uint64_t> processed_batches{0};
     global_config.setDefault<uint64_t>("number_of_events", 1u);
     auto number_of_events = global_config.get<uint64_t>("number_of_events");
 
@@ -751,6 +986,159 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
         thread_pool_->markComplete(n);
     }
 
+    // Find the sequential modules at the end of the module chain and move them to a dedicated pipeline thread if requested
+    pipeline_begin_ = modules_.end();
+    if(sequential_pipeline_) {
+        while(pipeline_begin_ != modules_.begin() && (*std::prev(pipeline_begin_))->require_sequence()) {
+            --pipeline_begin_;
+        }
+
+        if(pipeline_begin_ == modules_.end()) {
+            LOG(WARNING) << "No sequential module found at the end of the module chain, running without pipeline";
+        } else {
+            LOG(STATUS) << "Running " << std::distance(pipeline_begin_, modules_.end())
+                        << " sequential module instantiations on dedicated pipeline thread";
+            pipeline_ = std::make_unique<EventPipeline>(
+                max_buffer_size_,
+                skip_events + 1,
+                [this]() { return !thread_pool_->valid(); },
+                initialize_function,
+                finalize_function);
+        }
+    }
+
+    // Check for exceptions thrown by the workers or the pipeline thread
+    auto check_exception = [this]() {
+        thread_pool_->checkException();
+        if(pipeline_ != nullptr && pipeline_->failed()) {
+            thread_pool_->destroy();
+            pipeline_->checkException();
+        }
+    };
+
+    // Events of a batch are created together and continue individually from the first module requiring the event sequence
+    using EventContinuation = std::function<void(std::shared_ptr<Event>, ModuleList::iterator, int64_t)>;
+    struct BatchEntry {
+        uint64_t number;
+        uint64_t seed;
+        EventContinuation continuation;
+    };
+    std::vector<BatchEntry> batch;
+
+    auto batch_function = [this, plot, &aborted_events, &processed_batches](const std::vector<BatchEntry>& entries) {
+        // Thread number to record the execution times without locking
+        const auto thread_num = (plot ? ThreadPool::threadNum() : 0u);
+        processed_batches++;
+
+        // Each event of the batch requires its own RNG since the events are processed alternately
+        static thread_local std::vector<std::unique_ptr<RandomNumberGenerator>> random_engines;
+        while(random_engines.size() < entries.size()) {
+            random_engines.push_back(std::make_unique<RandomNumberGenerator>());
+        }
+
+        // Create the event data
+        std::vector<std::shared_ptr<Event>> events;
+        for(size_t n = 0; n < entries.size(); ++n) {
+            events.push_back(std::make_shared<Event>(*this->messenger_, entries[n].number, entries[n].seed));
+            events.back()->set_and_seed_random_engine(random_engines[n].get());
+            LOG(INFO) << "Starting event " << entries[n].number << " with seed " << entries[n].seed;
+        }
+        std::vector<int64_t> event_times(events.size(), 0);
+        std::vector<bool> aborted(events.size(), false);
+
+        auto module_iter = modules_.begin();
+        for(; module_iter != modules_.end() && !(*module_iter)->require_sequence(); ++module_iter) {
+            auto module = *module_iter;
+
+            // Select the events for which the module is satisfied to run
+            std::vector<size_t> selected;
+            for(size_t n = 0; n < events.size(); ++n) {
+                if(!aborted[n] && module->check_delegates(this->messenger_, events[n].get())) {
+                    selected.push_back(n);
+                }
+            }
+            if(selected.empty()) {
+                LOG(TRACE) << "Not all required messages are received for " << module->get_identifier().getUniqueName()
+                           << " in any event of the batch, skipping module!";
+                continue;
+            }
+
+            LOG_PROGRESS(TRACE, "EVENT_LOOP") << "Running batch of " << selected.size() << " events ["
+                                              << module->get_identifier().getUniqueName() << "]";
+
+            // Modules without batch support are executed event by event
+            std::vector<std::vector<size_t>> groups;
+            if(module->batchProcessingEnabled()) {
+                groups.push_back(selected);
+            } else {
+                for(auto n : selected) {
+                    groups.push_back({n});
+                }
+            }
+
+            // Get current time
+            auto start = std::chrono::steady_clock::now();
+
+            // Set module specific logging settings
+            auto old_settings = ModuleManager::set_module_before(
+                module->log_context_, module->log_context_.run_section, events[selected.front()]->number);
+
+            for(const auto& group : groups) {
+                std::vector<Event*> group_events;
+                for(auto n : group) {
+                    group_events.push_back(events[n].get());
+                }
+                Log::setEventNum(group_events.front()->number);
+
+                // Run module
+                try {
+                    if(module->batchProcessingEnabled()) {
+                        module->runBatch(group_events);
+                    } else {
+                        module->run(group_events.front());
+                    }
+                } catch(const AbortEventException& e) {
+                    LOG(WARNING) << "Event aborted:" << std::endl << e.what();
+                    for(auto n : group) {
+                        aborted[n] = true;
+                    }
+                } catch(const EndOfRunException& e) {
+                    // Terminate if the module threw the EndOfRun request exception:
+                    LOG(WARNING) << "Request to terminate:" << std::endl << e.what();
+                    this->terminate_ = true;
+                }
+            }
+
+            // Reset logging
+            ModuleManager::set_module_after(std::move(old_settings));
+
+            // Update execution time, the time spent on the batch is distributed equally to its events
+            auto end = std::chrono::steady_clock::now();
+            auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            this->module_execution_time_[module.get()] += duration;
+
+            if(plot) {
+                auto event_duration = duration / static_cast<int64_t>(selected.size());
+                auto& module_timing = this->module_event_timing_[module.get()];
+                for(auto n : selected) {
+                    event_times[n] += event_duration;
+                    module_timing->record(thread_num, event_duration);
+                }
+            }
+        }
+
+        // Continue every event individually, finishing it if all modules have been executed or it has been aborted
+        for(size_t n = 0; n < events.size(); ++n) {
+            if(aborted[n]) {
+                aborted_events++;
+            } else if(module_iter != modules_.end()) {
+                // Store state of PRNG engine to continue on the engine of the thread
+                events[n]->store_random_engine_state();
+            }
+            entries[n].continuation(events[n], (aborted[n] ? modules_.end() : module_iter), event_times[n]);
+        }
+    };
+
     LOG(STATUS) << "Starting event loop";
     for(uint64_t i = 1 + skip_events; i <= number_of_events + skip_events; i++) {
         // Check if run was aborted and stop pushing extra events to the threadpool
@@ -774,6 +1162,9 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
             // The RNG to be used by all events running on this thread
             static thread_local RandomNumberGenerator random_engine;
 
+            // Thread number to record the execution times without locking
+            const auto thread_num = (plot ? ThreadPool::threadNum() : 0u);
+
             // Create the event data
             if(event == nullptr) {
                 event = std::make_shared<Event>(*this->messenger_, event_num, event_seed);
@@ -786,6 +1177,85 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
             }
 
             while(module_iter != modules_.end()) {
+                // Hand the event over to the pipeline thread to run the remaining sequential modules
+                if(pipeline_ != nullptr && module_iter == pipeline_begin_ && !pipeline_->isConsumerThread()) {
+                    LOG(TRACE) << "Handing over event " << event->number << " to pipeline";
+                    // Store state of PRNG engine:
+                    event->store_random_engine_state();
+                    auto event_function = std::bind(self_func, event, module_iter, event_time, self_func);
+                    pipeline_->push(event->number, event_function);
+                    return;
+                }
+
+                // Run all modules up to the next sequential module following their dependencies
+                if(parallel_modules_ && !(*module_iter)->require_sequence()) {
+                    auto segment_end = module_iter;
+                    while(segment_end != modules_.end() && !(*segment_end)->require_sequence()) {
+                        ++segment_end;
+                    }
+                    auto begin = static_cast<size_t>(std::distance(modules_.begin(), module_iter));
+                    auto end = static_cast<size_t>(std::distance(modules_.begin(), segment_end));
+
+                    std::atomic<int64_t> segment_time{0};
+                    auto run_node = [this, plot, &event, &segment_time](size_t node) {
+                        const auto& module = module_nodes_[node];
+                        if(!module->check_delegates(this->messenger_, event.get())) {
+                            LOG(TRACE) << "Not all required messages are received for "
+                                       << module->get_identifier().getUniqueName() << ", skipping module!";
+                            return true;
+                        }
+
+                        LOG_PROGRESS(TRACE, "EVENT_LOOP") << "Running event " << event->number << " ["
+                                                          << module->get_identifier().getUniqueName() << "]";
+                        auto start = std::chrono::steady_clock::now();
+                        auto old_settings = ModuleManager::set_module_before(
+                            module->log_context_, module->log_context_.run_section, event->number);
+
+                        // Every module draws from its own random engine, independent of the order of execution
+                        static thread_local RandomNumberGenerator module_random_engine;
+                        module_random_engine.seed(module_seed(event->getSeed(), node));
+                        Event::set_thread_random_engine(&module_random_engine);
+
+                        bool success = true;
+                        try {
+                            module->run(event.get());
+                        } catch(const AbortEventException& e) {
+                            LOG(WARNING) << "Event aborted:" << std::endl << e.what();
+                            success = false;
+                        } catch(const EndOfRunException& e) {
+                            // Terminate if the module threw the EndOfRun request exception:
+                            LOG(WARNING) << "Request to terminate:" << std::endl << e.what();
+                            this->terminate_ = true;
+                        } catch(...) {
+                            Event::set_thread_random_engine(nullptr);
+                            throw;
+                        }
+                        Event::set_thread_random_engine(nullptr);
+                        ModuleManager::set_module_after(std::move(old_settings));
+
+                        auto end = std::chrono::steady_clock::now();
+                        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+                        this->module_execution_time_[module.get()] += duration;
+                        if(plot) {
+                            segment_time += duration;
+                            this->module_event_timing_[module.get()]->record(ThreadPool::threadNum(), duration);
+                        }
+                        return success;
+                    };
+                    auto spawn = [this](std::function<void()> job) {
+                        return thread_pool_->submitUrgent(std::move(job));
+                    };
+
+                    auto success = module_graph_.execute(begin, end, run_node, spawn, number_of_threads_ - 1);
+                    event_time += segment_time;
+                    if(!success) {
+                        aborted_events++;
+                        break;
+                    }
+                    module_iter = segment_end;
+                    continue;
+                }
+
                 auto module = *module_iter;
 
                 LOG_PROGRESS(TRACE, "EVENT_LOOP")
@@ -803,8 +1273,8 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                 auto start = std::chrono::steady_clock::now();
 
                 // Set module specific logging settings
-                auto old_settings = ModuleManager::set_module_before(
-                    module->get_identifier().getUniqueName(), module->get_configuration(), "R:", event->number);
+                auto old_settings =
+                    ModuleManager::set_module_before(module->log_context_, module->log_context_.run_section, event->number);
 
                 // Run module
                 bool stop = false;
@@ -836,10 +1306,8 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                 this->module_execution_time_[module.get()] += duration;
 
                 if(plot) {
-                    std::lock_guard<std::mutex> stat_lock{event->stats_mutex_};
                     event_time += duration;
-                    this->module_event_time_[module.get()]->Fill(
-                        std::chrono::duration<double>(std::chrono::nanoseconds(duration)).count());
+                    this->module_event_timing_[module.get()]->record(thread_num, duration);
                 }
 
                 if(abort) {
@@ -849,6 +1317,8 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
                 }
 
                 if(stop) {
+                    // Events are handed over to the pipeline in sequence and are never rescheduled from there
+                    assert(pipeline_ == nullptr || !pipeline_->isConsumerThread());
                     LOG(DEBUG) << "Event " << event->number
                                << " was interrupted because of missing dependencies, rescheduling...";
                     // Store state of PRNG engine:
@@ -871,23 +1341,49 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
             thread_pool_->markComplete(event->number);
             LOG(INFO) << "Finished event " << event_num << " with seed " << event_seed;
 
-            auto buffered_events = thread_pool_->bufferedQueueSize();
+            // Release the pipeline slot of events aborted before reaching the pipeline
+            if(pipeline_ != nullptr && !pipeline_->isConsumerThread()) {
+                pipeline_->push(event->number, nullptr);
+            }
+
+            auto buffered_events = thread_pool_->bufferedQueueSize() + (pipeline_ != nullptr ? pipeline_->size() : 0);
             if(plot) {
                 this->buffer_fill_level_->Fill(static_cast<double>(buffered_events));
-                event_time_->Fill(static_cast<double>(event_time) * 1e-9);
+                event_timing_->record(thread_num, event_time);
             }
 
             finished_events++;
             LOG_PROGRESS(STATUS, "EVENT_LOOP") << "Buffered " << buffered_events << ", finished " << finished_events
                                                << " of " << number_of_events << " events";
+
+            if(event_buffer_memory_ > 0) {
+                update_buffer_depth();
+            }
         };
 
-        auto event_function =
-            std::bind(event_function_with_module, nullptr, modules_.begin(), 0, event_function_with_module);
+        if(event_batch_size_ > 1) {
+            // Collect the events of a batch and submit them together once the batch is full
+            auto continuation = [event_function_with_module](std::shared_ptr<Event> event,
+                                                             ModuleList::iterator module_iter,
+                                                             int64_t event_time) mutable {
+                event_function_with_module(std::move(event), module_iter, event_time, event_function_with_module);
+            };
+            batch.push_back({i, seed, continuation});
+            if(batch.size() < event_batch_size_ && i < number_of_events + skip_events) {
+                continue;
+            }
 
-        auto future = thread_pool_->submit(event_function);
-        assert(future.valid() || !thread_pool_->valid());
-        thread_pool_->checkException();
+            auto future = thread_pool_->submit(batch_function, std::move(batch));
+            assert(future.valid() || !thread_pool_->valid());
+            batch.clear();
+        } else {
+            auto event_function =
+                std::bind(event_function_with_module, nullptr, modules_.begin(), 0, event_function_with_module);
+
+            auto future = thread_pool_->submit(event_function);
+            assert(future.valid() || !thread_pool_->valid());
+        }
+        check_exception();
     }
 
     LOG(TRACE) << "All events have been initialized. Waiting for thread pool to finish...";
@@ -895,8 +1391,15 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
     // Wait for workers to finish
     thread_pool_->wait();
 
+    // Wait for the pipeline thread to process all events handed over
+    if(pipeline_ != nullptr) {
+        LOG(TRACE) << "Waiting for pipeline to finish...";
+        pipeline_->close();
+        LOG(STATUS) << "Consumed " << pipeline_->consumed() << " events in sequence on the pipeline thread";
+    }
+
     // Check exception for last events
-    thread_pool_->checkException();
+    check_exception();
 
     LOG_PROGRESS(STATUS, "EVENT_LOOP") << "Finished run of " << finished_events << " events";
     global_config.set<uint64_t>("number_of_events", finished_events);
@@ -905,11 +1408,70 @@ void ModuleManager::run(RandomNumberGenerator& seeder) {
         LOG(WARNING) << "Aborted " << aborted_events << " events in this run";
     }
 
+    if(event_batch_size_ > 1) {
+        LOG(STATUS) << "Processed events in " << processed_batches << " batches of up to " << event_batch_size_
+                    << " events";
+    }
+
+    if(thread_pool_->pinnedWorkers() > 0) {
+        LOG(STATUS) << "Pinned " << thread_pool_->pinnedWorkers() << " of " << number_of_threads_ << " workers to CPUs";
+    }
+
+    if(scheduler_ == ThreadPool::Scheduler::WORK_STEALING) {
+        LOG(STATUS) << "Workers stole " << thread_pool_->stolenJobs() << " jobs from the queues of other workers";
+    }
+
+    if(event_buffer_memory_ > 0) {
+        LOG(STATUS) << "Adaptive event buffer grew up to " << max_buffer_depth_ << " event slots, finishing with "
+                    << thread_pool_->bufferLimit() << " slots for an estimated " << memory_to_string(event_memory_)
+                    << " per event";
+    }
+
     auto end_time = std::chrono::steady_clock::now();
     run_time_ = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
 
     LOG(TRACE) << "Destroying thread pool";
     thread_pool_.reset();
+    pipeline_.reset();
+}
+
+/**
+ * The memory held per event is estimated from the growth of the resident memory since the start of the run, divided by the
+ * number of events currently buffered or processed. This includes memory which is not released by the allocator and other
+ * growth during the run, which leads to a conservative estimate. The estimate is smoothed over consecutive updates.
+ */
+void ModuleManager::update_buffer_depth() {
+    using namespace std::chrono_literals;
+
+    std::unique_lock<std::mutex> lock{buffer_depth_mutex_, std::try_to_lock};
+    auto now = std::chrono::steady_clock::now();
+    if(!lock.owns_lock() || now - buffer_depth_update_ < 100ms) {
+        return;
+    }
+    buffer_depth_update_ = now;
+
+    auto memory = get_resident_memory();
+    if(memory <= baseline_memory_) {
+        return;
+    }
+    auto events = thread_pool_->bufferedQueueSize() + (pipeline_ != nullptr ? pipeline_->size() : 0) + number_of_threads_;
+    auto memory_per_event = static_cast<double>(memory - baseline_memory_) / static_cast<double>(events);
+    event_memory_ = (event_memory_ > 0 ? 0.8 * event_memory_ + 0.2 * memory_per_event : memory_per_event);
+
+    // Shrink the buffer immediately but grow it at most by a factor of two per update to let the estimate follow
+    auto current_depth = thread_pool_->bufferLimit();
+    auto target_depth = static_cast<double>(event_buffer_memory_) / event_memory_ - number_of_threads_;
+    target_depth = std::clamp(target_depth, 0., static_cast<double>(std::min(2 * current_depth, max_buffer_size_)));
+    auto depth = thread_pool_->setBufferLimit(static_cast<size_t>(target_depth));
+
+    if(depth != current_depth) {
+        LOG(DEBUG) << "Changed event buffer from " << current_depth << " to " << depth << " event slots, estimated "
+                   << memory_to_string(event_memory_) << " per event";
+    }
+    max_buffer_depth_ = std::max(max_buffer_depth_, depth);
+    if(buffer_depth_ != nullptr) {
+        buffer_depth_->Fill(static_cast<double>(depth));
+    }
 }
 
 static std::string nanoseconds_to_time(uint64_t nanoseconds) {
@@ -948,7 +1510,7 @@ void ModuleManager::finalize() {
         auto start = std::chrono::steady_clock::now();
 
         // Set module specific log settings
-        auto old_settings = set_module_before(module->get_identifier().getUniqueName(), module->get_configuration(), "F:");
+        auto old_settings = set_module_before(module->log_context_, module->log_context_.finalize_section);
         // Change to our ROOT directory
         module->getROOTDirectory()->cd();
         // Finalize module
@@ -973,8 +1535,23 @@ void ModuleManager::finalize() {
         }
         perf_dir->cd();
 
+        // Merge the execution times recorded by all threads and fill them into the histograms
+        auto fill_histogram = [](TimingHistogram& timing, ThreadedHistogram<TH1D>& histogram) {
+            timing.merge();
+            timing.forEachBucket(
+                [&histogram](double time, uint64_t count) { histogram.Fill(time * 1e-9, static_cast<double>(count)); });
+            histogram.Get()->SetEntries(static_cast<double>(timing.count()));
+        };
+        fill_histogram(*event_timing_, *event_time_);
+        for(auto& module : modules_) {
+            fill_histogram(*module_event_timing_[module.get()], *module_event_time_[module.get()]);
+        }
+
         event_time_->Write();
         buffer_fill_level_->Write();
+        if(buffer_depth_ != nullptr) {
+            buffer_depth_->Write();
+        }
 
         for(auto& module : modules_) {
             const auto& module_name = module->get_configuration().getName();
@@ -1043,8 +1620,16 @@ void ModuleManager::finalize() {
                 << ", spending " << std::round((100 * slowest_time) / std::max(int64_t(1), total_module_time))
                 << "% of time in slowest instantiation " << slowest_module;
     for(auto& module : modules_) {
+        std::stringstream timing;
+        auto timing_iter = module_event_timing_.find(module.get());
+        if(timing_iter != module_event_timing_.end() && timing_iter->second->count() > 0) {
+            const auto& module_timing = *timing_iter->second;
+            timing << ", per event p50 " << Units::display(module_timing.percentile(50), {"s", "ms", "us"}) << ", p99 "
+                   << Units::display(module_timing.percentile(99), {"s", "ms", "us"}) << ", max "
+                   << Units::display(module_timing.max(), {"s", "ms", "us"});
+        }
         LOG(INFO) << " Module " << module->getUniqueName() << " took "
-                  << Units::display(module_execution_time_[module.get()].load(), {"s", "ms"});
+                  << Units::display(module_execution_time_[module.get()].load(), {"s", "ms"}) << timing.str();
     }
 
     auto processing_time = std::round(run_time_ / std::max(uint64_t(1), global_config.get<uint64_t>("number_of_events")));
@@ -13,17 +13,22 @@
 #define ALLPIX_MODULE_MANAGER_H
 
 #include <atomic>
+#include <chrono>
 #include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 
 #include <TDirectory.h>
 #include <TFile.h>
 #include <TH1D.h>
 
+#include "EventPipeline.hpp"
 #include "Module.hpp"
+#include "ModuleGraph.hpp"
 #include "ThreadPool.hpp"
+#include "TimingHistogram.hpp"
 #include "core/config/Configuration.hpp"
 #include "core/utils/log.h"
 #include "tools/ROOT.h"
@@ -149,6 +154,50 @@ namespace allpix {
          */
         static void set_module_after(std::tuple<LogLevel, LogFormat, std::string, uint64_t> prev);
 
+        /**
+         * @brief Parse the module specific log settings from the configuration once for all later stages
+         * @param mod_name Unique identifier of the module
+         * @param config   Module configuration
+         * @return Log context of the module
+         */
+        static Module::LogContext create_log_context(const std::string& mod_name, const Configuration& config);
+
+        /**
+         * @brief Set precomputed module specific log setting before running init/run/finalize without parsing the config
+         * @param context Log context of the module
+         * @param section Section header of the current stage, stored in the log context
+         * @param event   Event number, defaults to 0 for not displaying it
+         */
+        static std::tuple<LogLevel, LogFormat, const std::string*, uint64_t>
+        set_module_before(const Module::LogContext& context, const std::string& section, const uint64_t event = 0);
+
+        /**
+         * @brief Reset global log setting after running init/run/finalize with a precomputed log context
+         * @param prev Set of previous settings generated by \ref set_module_before
+         */
+        static void set_module_after(const std::tuple<LogLevel, LogFormat, const std::string*, uint64_t>& prev);
+
+        /**
+         * @brief Apply the log level and format of a log context if they differ from the current ones
+         * @param context Log context of the module
+         * @return Previous log level and format
+         */
+        static std::pair<LogLevel, LogFormat> apply_log_context(const Module::LogContext& context);
+
+        /**
+         * @brief Reset the log level and format to the previous ones if necessary
+         * @param level  Previous log level
+         * @param format Previous log format
+         */
+        static void reset_log_context(LogLevel level, LogFormat format);
+
+        /**
+         * @brief Adapt the number of buffered events to the memory budget based on the current memory usage
+         *
+         * Only executed by one thread at a time and at most every 100ms, calls from other threads return immediately.
+         */
+        void update_buffer_depth();
+
         using IdentifierToModuleMap = std::map<ModuleIdentifier, ModuleList::iterator>;
 
         ModuleList modules_;
@@ -161,8 +210,11 @@ namespace allpix {
         // Duration in ns
         std::map<Module*, std::atomic_int64_t> module_execution_time_;
         std::map<Module*, Histogram<TH1D>> module_event_time_;
+        std::map<Module*, std::unique_ptr<TimingHistogram>> module_event_timing_;
         Histogram<TH1D> event_time_;
+        std::unique_ptr<TimingHistogram> event_timing_;
         Histogram<TH1D> buffer_fill_level_;
+        Histogram<TH1D> buffer_depth_;
 
         // Durations in ns
         uint64_t initialize_time_{}, run_time_{}, finalize_time_{};
@@ -176,10 +228,30 @@ namespace allpix {
         // The thread pool used in the run method
         std::unique_ptr<ThreadPool> thread_pool_{nullptr};
 
+        // The pipeline running sequential modules at the end of the chain on a dedicated thread
+        std::unique_ptr<EventPipeline> pipeline_{nullptr};
+        ModuleList::iterator pipeline_begin_;
+
         // User defined multithreading flags and parameters from configuration
         bool multithreading_flag_{false};
         unsigned int number_of_threads_{0};
         size_t max_buffer_size_{1};
+        ThreadPool::Scheduler scheduler_{ThreadPool::Scheduler::FIFO};
+        bool sequential_pipeline_{false};
+        unsigned int event_batch_size_{1};
+
+        // Dependency graph to run independent module instantiations of an event concurrently
+        bool parallel_modules_{false};
+        ModuleGraph module_graph_;
+        std::vector<std::shared_ptr<Module>> module_nodes_;
+
+        // Memory budget for buffered events in bytes and the state of the adaptive buffer depth
+        size_t event_buffer_memory_{0};
+        size_t baseline_memory_{0};
+        double event_memory_{0};
+        size_t max_buffer_depth_{0};
+        std::mutex buffer_depth_mutex_;
+        std::chrono::steady_clock::time_point buffer_depth_update_;
 
         // Possibility of running loaded modules in parallel
         bool can_parallelize_{true};
@@ -11,7 +11,17 @@
 
 #include "ThreadPool.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 #include "Module.hpp"
 
@@ -21,6 +31,34 @@ std::map<std::thread::id, unsigned int> ThreadPool::thread_nums_;
 std::atomic_uint ThreadPool::thread_cnt_{1u};
 std::atomic_uint ThreadPool::thread_total_{1u};
 
+ThreadPool::Affinity ThreadPool::affinity_{ThreadPool::Affinity::NONE};
+std::vector<std::vector<int>> ThreadPool::numa_cpus_;
+
+namespace {
+    // NUMA node the current thread is pinned to
+    thread_local int numa_node = -1;
+
+    // Parse a list of CPUs in the format used by the Linux kernel, e.g. "0-3,8,10-11"
+    std::vector<int> parse_cpu_list(const std::string& list) {
+        std::vector<int> cpus;
+        std::stringstream stream(list);
+        std::string range;
+        while(std::getline(stream, range, ',')) {
+            try {
+                auto separator = range.find('-');
+                auto first = std::stoi(range.substr(0, separator));
+                auto last = (separator == std::string::npos ? first : std::stoi(range.substr(separator + 1)));
+                for(auto cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            } catch(std::logic_error&) {
+                // Ignore malformed entries
+            }
+        }
+        return cpus;
+    }
+} // namespace
+
 /**
  * The threads are created in an exception-safe way and all of them will be destroyed when creation of one fails
  */
@@ -36,15 +74,19 @@ ThreadPool::ThreadPool(unsigned int num_threads,
                        unsigned int max_queue_size,
                        unsigned int max_buffered_size,
                        const std::function<void()>& worker_init_function,
-                       const std::function<void()>& worker_finalize_function)
-    : queue_(max_queue_size, max_buffered_size) {
-    assert(max_buffered_size == 0 || max_buffered_size >= num_threads);
+                       const std::function<void()>& worker_finalize_function,
+                       Scheduler scheduler,
+                       unsigned int max_buffered_per_job)
+    : queue_(max_queue_size, max_buffered_size, (scheduler == Scheduler::WORK_STEALING ? num_threads : 0u)) {
+    assert(max_buffered_size == 0 || max_buffered_size >= num_threads * max_buffered_per_job);
+    min_buffered_size_ = std::min(num_threads * max_buffered_per_job, max_buffered_size);
     // Create threads
     try {
         for(unsigned int i = 0u; i < num_threads; ++i) {
             threads_.emplace_back(&ThreadPool::worker,
                                   this,
-                                  std::min(num_threads, max_buffered_size),
+                                  i,
+                                  min_buffered_size_,
                                   worker_init_function,
                                   worker_finalize_function);
         }
@@ -69,6 +111,14 @@ ThreadPool::~ThreadPool() { destroy(); }
 
 void ThreadPool::markComplete(uint64_t n) { queue_.complete(n); }
 
+/**
+ * Every worker only starts a new job if the buffer can hold the jobs of all workers, a lower limit would stall all workers
+ */
+size_t ThreadPool::setBufferLimit(size_t limit) {
+    queue_.setPriorityLimit(std::max(limit, min_buffered_size_));
+    return queue_.priorityLimit();
+}
+
 void ThreadPool::checkException() {
     // If exception has been thrown, destroy pool and propagate it
     if(exception_ptr_) {
@@ -86,7 +136,8 @@ void ThreadPool::wait() {
 /**
  * If an exception is thrown by a module, the first exception is saved to propagate in the main thread
  */
-void ThreadPool::worker(size_t min_thread_buffer,
+void ThreadPool::worker(size_t lane,
+                        size_t min_thread_buffer,
                         const std::function<void()>& initialize_function,
                         const std::function<void()>& finalize_function) {
     try {
@@ -95,22 +146,34 @@ void ThreadPool::worker(size_t min_thread_buffer,
         assert(thread_num < thread_total_);
         thread_nums_[std::this_thread::get_id()] = thread_num;
 
+        // Pin the worker before initializing it, such that its memory is allocated on the local NUMA node
+        auto pinned = pin_worker(lane);
+
         // Initialize the worker
         if(initialize_function) {
             initialize_function();
         }
 
+        if(affinity_ != Affinity::NONE) {
+            if(pinned) {
+                pinned_workers_++;
+                LOG(TRACE) << "Pinned worker " << lane << " to CPUs of NUMA node " << numa_node;
+            } else {
+                LOG(WARNING) << "Could not pin worker " << lane << " to CPUs, running without affinity";
+            }
+        }
+
         while(!done_) {
             Task task{nullptr};
 
-            if(queue_.pop(task, min_thread_buffer)) {
+            if(queue_.pop(task, min_thread_buffer, lane)) {
                 // Execute task
                 (*task)();
                 // Fetch the future to propagate exceptions
                 task->get_future().get();
                 // Update the run count and propagate update
-                std::unique_lock<std::mutex> lock{run_mutex_};
                 if(--run_cnt_ == 0) {
+                    std::lock_guard<std::mutex> lock{run_mutex_};
                     run_condition_.notify_all();
                 }
             }
@@ -167,3 +230,111 @@ unsigned int ThreadPool::threadNum() {
 unsigned int ThreadPool::threadCount() { return thread_total_; }
 
 void ThreadPool::registerThreadCount(unsigned int cnt) { thread_total_ += cnt; }
+
+/**
+ * The NUMA topology is read from the sysfs of the Linux kernel and restricted to the CPUs this process is allowed to run on.
+ * If the topology is not available, all CPUs are treated as a single NUMA node.
+ */
+bool ThreadPool::setAffinity(Affinity affinity) {
+    affinity_ = affinity;
+    numa_cpus_.clear();
+#ifdef __linux__
+    cpu_set_t available;
+    CPU_ZERO(&available);
+    if(sched_getaffinity(0, sizeof(available), &available) != 0) {
+        affinity_ = Affinity::NONE;
+        return false;
+    }
+
+    // Assign the available CPUs to their NUMA nodes
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    std::error_code error;
+    for(const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", error)) {
+        auto name = entry.path().filename().string();
+        if(name.size() <= 4 || name.compare(0, 4, "node") != 0 || std::isdigit(name[4]) == 0) {
+            continue;
+        }
+
+        std::ifstream file(entry.path() / "cpulist");
+        std::string list;
+        std::getline(file, list);
+
+        std::vector<int> cpus;
+        for(auto cpu : parse_cpu_list(list)) {
+            if(cpu < CPU_SETSIZE && CPU_ISSET(cpu, &available)) {
+                cpus.push_back(cpu);
+            }
+        }
+        if(!cpus.empty()) {
+            nodes.emplace_back(std::stoi(name.substr(4)), std::move(cpus));
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+    for(auto& node : nodes) {
+        numa_cpus_.push_back(std::move(node.second));
+    }
+
+    // Treat all available CPUs as single node if the topology is not known
+    if(numa_cpus_.empty()) {
+        std::vector<int> cpus;
+        for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if(CPU_ISSET(cpu, &available)) {
+                cpus.push_back(cpu);
+            }
+        }
+        numa_cpus_.push_back(std::move(cpus));
+    }
+    return true;
+#else
+    affinity_ = Affinity::NONE;
+    return affinity == Affinity::NONE;
+#endif
+}
+
+unsigned int ThreadPool::numaNodeCount() { return std::max(static_cast<unsigned int>(numa_cpus_.size()), 1u); }
+
+int ThreadPool::numaNode() { return numa_node; }
+
+bool ThreadPool::pin_worker([[maybe_unused]] size_t worker) {
+#ifdef __linux__
+    if(affinity_ == Affinity::NONE || numa_cpus_.empty()) {
+        return false;
+    }
+
+    // Select the NUMA node and the CPUs of the worker
+    auto node = worker % numa_cpus_.size();
+    std::vector<int> cpus;
+    if(affinity_ == Affinity::COMPACT) {
+        size_t total = 0;
+        for(const auto& node_cpus : numa_cpus_) {
+            total += node_cpus.size();
+        }
+        auto index = worker % total;
+        node = 0;
+        while(index >= numa_cpus_[node].size()) {
+            index -= numa_cpus_[node].size();
+            ++node;
+        }
+        cpus.push_back(numa_cpus_[node][index]);
+    } else if(affinity_ == Affinity::SCATTER) {
+        const auto& node_cpus = numa_cpus_[node];
+        cpus.push_back(node_cpus[(worker / numa_cpus_.size()) % node_cpus.size()]);
+    } else {
+        cpus = numa_cpus_[node];
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for(auto cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    if(pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        return false;
+    }
+
+    numa_node = static_cast<int>(node);
+    return true;
+#else
+    return false;
+#endif
+}
@@ -14,15 +14,19 @@
 
 #include <algorithm>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <exception>
 #include <functional>
 #include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <queue>
 #include <set>
 #include <thread>
 #include <utility>
+#include <vector>
 
 namespace allpix {
     /**
@@ -30,6 +34,24 @@ namespace allpix {
      */
     class ThreadPool {
     public:
+        /**
+         * @brief Scheduling strategy used to distribute standard jobs to the workers
+         */
+        enum class Scheduler {
+            FIFO,          ///< Single first-in-first-out queue shared by all workers
+            WORK_STEALING, ///< Separate queue per worker, idle workers steal jobs from the others
+        };
+
+        /**
+         * @brief Strategy to pin the workers to the CPUs of the system
+         */
+        enum class Affinity {
+            NONE,    ///< Workers are not pinned and scheduled freely by the operating system
+            COMPACT, ///< Workers are pinned to consecutive CPUs, filling one NUMA node after the other
+            SCATTER, ///< Workers are pinned to single CPUs, distributed round-robin over the NUMA nodes
+            NUMA,    ///< Workers are pinned to all CPUs of a NUMA node, distributed round-robin over the NUMA nodes
+        };
+
         /**
          * @brief Internal thread-safe queuing system
          *
@@ -39,6 +61,14 @@ namespace allpix {
          *
          * The priority queue is popped if the top of the queue can be directly processed. Otherwise work is popped from the
          * default queue unless the priority queue size is too large.
+         *
+         * If the queue is constructed with lanes, the standard queue is replaced by one double-ended queue per lane, each
+         * guarded by its own mutex. Jobs are distributed over the lanes in round-robin order and popped from the lane of the
+         * calling worker first, and stolen from the other lanes if the own lane is empty. The global mutex is then only
+         * taken for the priority queue and to put idle workers to sleep.
+         *
+         * Urgent jobs, such as parts of an event which has already been started, are kept in a separate queue which is
+         * popped before all other queues and is not limited by the capacity of the queues.
          */
         template <typename T> class SafeQueue {
         public:
@@ -46,8 +76,9 @@ namespace allpix {
              * @brief Default constructor, initializes empty queue
              * @param max_standard_size Max size of the default queue
              * @param max_priority_size Max size of the priority queue
+             * @param lanes Number of work-stealing lanes, zero for a single shared standard queue
              */
-            SafeQueue(unsigned int max_standard_size, unsigned int max_priority_size);
+            SafeQueue(unsigned int max_standard_size, unsigned int max_priority_size, unsigned int lanes = 0);
 
             /**
              * @brief Erases the queue and release waiting threads on destruction
@@ -58,9 +89,10 @@ namespace allpix {
              * @brief Get the top value from the appropriate queue
              * @param out Reference where the value at the top of the queue will be written to
              * @param buffer_left Optional number of jobs that should be left in priority buffer without stall on push
+             * @param lane Lane of the calling worker, only used if the queue has been constructed with lanes
              * @return True if a task was acquired or false if pop was exited for another reason
              */
-            bool pop(T& out, size_t buffer_left = 0);
+            bool pop(T& out, size_t buffer_left = 0, size_t lane = 0);
 
             /**
              * @brief Push a new value onto the standard queue, will block if queue is full
@@ -77,6 +109,12 @@ namespace allpix {
              * @return If the push was successful
              */
             bool push(uint64_t n, T value, bool wait = true);
+            /**
+             * @brief Push a new value onto the urgent queue, which is popped before all other queues
+             * @param value Value to push to the queue
+             * @return If the push was successful
+             */
+            bool pushUrgent(T value);
 
             /**
              * @brief Mark an identifier as complete
@@ -114,24 +152,99 @@ namespace allpix {
              */
             size_t prioritySize() const;
 
+            /**
+             * @brief Change the number of values in the priority queue up to which the standard queue is popped
+             * @param limit New limit, capped to the maximum size of the priority queue given at construction
+             *
+             * The maximum size of the priority queue itself is not changed, such that values which are already being
+             * processed can always be pushed. Lowering the limit only prevents new values from being popped from the
+             * standard queue until the priority queue has drained below the new limit.
+             */
+            void setPriorityLimit(size_t limit);
+
+            /**
+             * @brief Return the current limit of the priority queue
+             * @return Number of values in the priority queue up to which the standard queue is popped
+             */
+            size_t priorityLimit() const { return priority_limit_; }
+
+            /**
+             * @brief Return the number of values popped from another lane than the one of the calling worker
+             * @return Number of stolen values, always zero if the queue has been constructed without lanes
+             */
+            size_t stolen() const { return stolen_; }
+
             /**
              * @brief Invalidate the queue
              */
             void invalidate();
 
         private:
+            /**
+             * @brief Get the top value from the priority queue or from one of the work-stealing lanes
+             * @param out Reference where the acquired value will be written to
+             * @param buffer_left Number of jobs that should be left in priority buffer without stall on push
+             * @param lane Lane of the calling worker which is checked before stealing from other lanes
+             * @return True if a task was acquired or false if the queue has been invalidated
+             */
+            bool pop_lanes(T& out, size_t buffer_left, size_t lane);
+
+            /**
+             * @brief Push a new value onto the next work-stealing lane
+             * @param value Value to push to the lane
+             * @param wait If the push is allowed to stall if there is no capacity
+             * @return If the push was successful
+             */
+            bool push_lanes(T value, bool wait);
+
+            /**
+             * @brief Pop the front value of the given lane or of any other lane if it is empty
+             * @param out Reference where the acquired value will be written to
+             * @param lane Lane to look at first
+             * @return True if a value was acquired
+             */
+            bool steal(T& out, size_t lane);
+
+            /**
+             * @brief Check if the top of the priority queue can be processed (requires the mutex to be locked)
+             */
+            bool priority_ready() const { return !priority_queue_.empty() && priority_queue_.top().first == current_id_; }
+
+            /**
+             * @brief Update cached identifier of the top of the priority queue (requires the mutex to be locked)
+             */
+            void update_priority_top() {
+                priority_top_ = (priority_queue_.empty() ? UINT64_MAX : priority_queue_.top().first);
+            }
+
             std::atomic_bool valid_{true};
             mutable std::mutex mutex_{};
             std::queue<T> queue_;
             std::set<uint64_t> completed_ids_;
-            uint64_t current_id_{0};
+            std::atomic<uint64_t> current_id_{0};
             using PQValue = std::pair<uint64_t, T>;
             std::priority_queue<PQValue, std::vector<PQValue>, std::greater<>> priority_queue_;
             std::atomic_size_t priority_queue_size_{0};
+            std::deque<T> urgent_queue_;
+            std::atomic_size_t urgent_size_{0};
+            std::atomic<uint64_t> priority_top_{UINT64_MAX};
             std::condition_variable push_condition_;
             std::condition_variable pop_condition_;
             const size_t max_standard_size_;
             const size_t max_priority_size_;
+            std::atomic_size_t priority_limit_;
+
+            // Work-stealing lanes, aligned to avoid false sharing between the lane mutexes
+            struct alignas(64) Lane {
+                std::mutex mutex;
+                std::deque<T> deque;
+            };
+            std::vector<Lane> lanes_;
+            std::atomic_size_t next_lane_{0};
+            std::atomic_size_t lanes_size_{0};
+            std::atomic_size_t idle_poppers_{0};
+            std::atomic_size_t waiting_pushers_{0};
+            std::atomic_size_t stolen_{0};
         };
 
         /**
@@ -154,13 +267,17 @@ namespace allpix {
          * @param max_buffered_size Maximum size of the buffered job queue (should be at least number of threads)
          * @param worker_init_function Function run by all the workers to initialize
          * @param worker_finalize_function Function run by all the workers to cleanup
+         * @param scheduler Strategy used to distribute the standard jobs to the workers
+         * @param max_buffered_per_job Maximum number of buffered jobs a single standard job can create
          * @warning Total count of threads need to be preregistered via \ref ThreadPool::registerThreadCount
          */
         ThreadPool(unsigned int num_threads,
                    unsigned int max_queue_size,
                    unsigned int max_buffered_size,
                    const std::function<void()>& worker_init_function = nullptr,
-                   const std::function<void()>& worker_finalize_function = nullptr);
+                   const std::function<void()>& worker_finalize_function = nullptr,
+                   Scheduler scheduler = Scheduler::FIFO,
+                   unsigned int max_buffered_per_job = 1);
 
         /// @{
         /**
@@ -187,6 +304,15 @@ namespace allpix {
          * @warning This function can only be called if thread pool was initialized with buffered jobs
          */
         template <typename Func, typename... Args> auto submit(uint64_t n, Func&& func, Args&&... args);
+        /**
+         * @brief Submit an urgent job which is run before all other jobs, without waiting for capacity in the queues
+         * @param func Function to execute by the pool
+         * @return True if the job was submitted, false if the pool has no workers or has been invalidated
+         *
+         * Urgent jobs are never executed immediately by the submitting thread. Exceptions thrown by the function are
+         * propagated as for any other job and terminate the pool, they should thus be handled by the function itself.
+         */
+        template <typename Func> bool submitUrgent(Func&& func);
 
         /**
          * @brief Mark identifier as completed
@@ -212,6 +338,34 @@ namespace allpix {
          */
         size_t bufferedQueueSize() const { return queue_.prioritySize(); }
 
+        /**
+         * @brief Change the number of buffered jobs up to which new jobs are started
+         * @param limit New limit of the buffered queue
+         * @return Limit which has been applied, bounded by the buffer kept available for the workers and the maximum size
+         *
+         * This allows to shrink and grow the window of buffered events at run time without reallocating the queue. The
+         * limit can never become smaller than the buffer each worker requires to finish the jobs it is processing.
+         */
+        size_t setBufferLimit(size_t limit);
+
+        /**
+         * @brief Return the current limit of the buffered queue
+         * @return Number of buffered jobs up to which new jobs are started
+         */
+        size_t bufferLimit() const { return queue_.priorityLimit(); }
+
+        /**
+         * @brief Return the number of standard jobs a worker has stolen from the lane of another worker
+         * @return Number of stolen jobs, always zero unless the work-stealing scheduler is used
+         */
+        size_t stolenJobs() const { return queue_.stolen(); }
+
+        /**
+         * @brief Return the number of workers which have been pinned to CPUs
+         * @return Number of pinned workers, zero if no worker affinity is set
+         */
+        unsigned int pinnedWorkers() const { return pinned_workers_; }
+
         /**
          * @brief Check if any worker thread has thrown an exception
          * @throw Exception thrown by worker thread, if any
@@ -256,14 +410,42 @@ namespace allpix {
          */
         static void registerThreadCount(unsigned int cnt);
 
+        /**
+         * @brief Set the strategy to pin workers to CPUs, used for all workers started afterwards
+         * @param affinity Strategy to pin the workers
+         * @return True if pinning is supported on this system, false otherwise
+         */
+        static bool setAffinity(Affinity affinity);
+
+        /**
+         * @brief Get the number of NUMA nodes with CPUs available to this process
+         * @return Number of NUMA nodes, one if the topology cannot be determined
+         */
+        static unsigned int numaNodeCount();
+
+        /**
+         * @brief Get the NUMA node the current thread is pinned to
+         * @return Index of the NUMA node between 0 and \ref numaNodeCount, or -1 if not pinned to a single node
+         */
+        static int numaNode();
+
     private:
+        /**
+         * @brief Pin the calling worker thread to CPUs according to the configured affinity
+         * @param worker Index of the worker in the pool
+         * @return True if the worker has been pinned, false otherwise
+         */
+        static bool pin_worker(size_t worker);
+
         /**
          * @brief Constantly running internal function each thread uses to acquire work items from the queue.
+         * @param lane                Work-stealing lane assigned to this worker
          * @param min_thread_buffer   Minimum buffer size to keep available without stall on push
          * @param initialize_function Function to initialize the thread
          * @param finalize_function   Function to finalize the thread
          */
-        void worker(size_t min_thread_buffer,
+        void worker(size_t lane,
+                    size_t min_thread_buffer,
                     const std::function<void()>& initialize_function,
                     const std::function<void()>& finalize_function);
 
@@ -271,11 +453,13 @@ namespace allpix {
         using Task = std::unique_ptr<std::packaged_task<void()>>;
         SafeQueue<Task> queue_;
         bool with_buffered_{true};
+        size_t min_buffered_size_{0};
         std::function<void()> finalize_function_{};
 
         std::atomic_bool done_{false};
 
         std::atomic<unsigned int> run_cnt_{0};
+        std::atomic<unsigned int> pinned_workers_{0};
         mutable std::mutex run_mutex_{};
         std::condition_variable run_condition_;
         std::vector<std::thread> threads_;
@@ -286,6 +470,9 @@ namespace allpix {
         static std::map<std::thread::id, unsigned int> thread_nums_;
         static std::atomic_uint thread_cnt_;
         static std::atomic_uint thread_total_;
+
+        static Affinity affinity_;
+        static std::vector<std::vector<int>> numa_cpus_;
     };
 } // namespace allpix
 
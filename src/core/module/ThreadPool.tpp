@@ -9,21 +9,27 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <algorithm>
 #include <cassert>
 #include <climits>
 
 namespace allpix {
     template <typename T>
-    ThreadPool::SafeQueue<T>::SafeQueue(unsigned int max_standard_size, unsigned max_priority_size)
-        : max_standard_size_(max_standard_size), max_priority_size_(max_priority_size) {}
+    ThreadPool::SafeQueue<T>::SafeQueue(unsigned int max_standard_size, unsigned max_priority_size, unsigned int lanes)
+        : max_standard_size_(max_standard_size), max_priority_size_(max_priority_size),
+          priority_limit_(max_priority_size), lanes_(lanes) {}
 
     /*
      * Block until a value is available if the wait parameter is set to true. The wait exits when the queue is invalidated.
      */
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wstrict-overflow"
-    template <typename T> bool ThreadPool::SafeQueue<T>::pop(T& out, size_t buffer_left) {
+    template <typename T> bool ThreadPool::SafeQueue<T>::pop(T& out, size_t buffer_left, size_t lane) {
         assert(buffer_left <= max_priority_size_);
+        if(!lanes_.empty()) {
+            return pop_lanes(out, buffer_left, lane);
+        }
+
         // Lock the mutex
         std::unique_lock<std::mutex> lock{mutex_};
         if(!valid_) {
@@ -31,24 +37,33 @@ namespace allpix {
         }
 
         // Wait for one of the queues to be available
+        bool pop_urgent = !urgent_queue_.empty();
         bool pop_priority = !priority_queue_.empty() && priority_queue_.top().first == current_id_;
-        bool pop_standard = !queue_.empty() && priority_queue_.size() + buffer_left <= max_priority_size_;
-        while(!pop_priority && !pop_standard) {
+        bool pop_standard = !queue_.empty() && priority_queue_.size() + buffer_left <= priority_limit_;
+        while(!pop_urgent && !pop_priority && !pop_standard) {
             // Wait for new item in the queue (unlocks the mutex while waiting)
             pop_condition_.wait(lock);
             if(!valid_) {
                 return false;
             }
+            pop_urgent = !urgent_queue_.empty();
             pop_priority = !priority_queue_.empty() && priority_queue_.top().first == current_id_;
-            pop_standard = !queue_.empty() && priority_queue_.size() + buffer_left <= max_priority_size_;
+            pop_standard = !queue_.empty() && priority_queue_.size() + buffer_left <= priority_limit_;
         }
 
         // Pop the appropriate queue
-        if(pop_priority) {
+        if(pop_urgent) {
+            out = std::move(urgent_queue_.front());
+            urgent_queue_.pop_front();
+            urgent_size_--;
+            lock.unlock();
+            return true;
+        } else if(pop_priority) {
             // Priority queue is missing a pop returning a non-const reference, so need to apply a const_cast
             out = std::move(const_cast<PQValue&>(priority_queue_.top())).second; // NOLINT
             priority_queue_.pop();
             priority_queue_size_--;
+            update_priority_top();
         } else { // pop_standard
             out = std::move(queue_.front());
             queue_.pop();
@@ -62,9 +77,93 @@ namespace allpix {
         push_condition_.notify_one();
         return true;
     }
+
+    /*
+     * The global mutex is only locked if the next job in sequence is available in the priority queue or if no work is left
+     * and the worker has to sleep. Both the own lane and the stolen lanes are popped from the front, such that the oldest
+     * jobs are processed first and events are kept close to their sequence, limiting the buffering for sequential modules.
+     */
+    template <typename T> bool ThreadPool::SafeQueue<T>::pop_lanes(T& out, size_t buffer_left, size_t lane) {
+        while(valid_) {
+            // Urgent jobs are taken before anything else
+            if(urgent_size_ > 0) {
+                std::unique_lock<std::mutex> lock{mutex_};
+                if(valid_ && !urgent_queue_.empty()) {
+                    out = std::move(urgent_queue_.front());
+                    urgent_queue_.pop_front();
+                    urgent_size_--;
+                    return true;
+                }
+            }
+
+            // Check the cached priority top first to avoid locking the mutex if it cannot be popped anyway
+            if(priority_top_ == current_id_) {
+                std::unique_lock<std::mutex> lock{mutex_};
+                if(valid_ && priority_ready()) {
+                    // Priority queue is missing a pop returning a non-const reference, so need to apply a const_cast
+                    out = std::move(const_cast<PQValue&>(priority_queue_.top())).second; // NOLINT
+                    priority_queue_.pop();
+                    priority_queue_size_--;
+                    update_priority_top();
+
+                    // Notify possible other workers and pushers waiting for the priority queue
+                    lock.unlock();
+                    pop_condition_.notify_one();
+                    push_condition_.notify_one();
+                    return true;
+                }
+            }
+
+            // Pop from the own lane or steal from another lane if the priority queue has enough space left
+            if(priority_queue_size_ + buffer_left <= priority_limit_ && steal(out, lane)) {
+                // Notify possible pusher waiting for free capacity
+                if(waiting_pushers_ > 0) {
+                    std::lock_guard<std::mutex> lock{mutex_};
+                    push_condition_.notify_one();
+                }
+                return true;
+            }
+
+            // Sleep until new work is available (unlocks the mutex while waiting)
+            std::unique_lock<std::mutex> lock{mutex_};
+            ++idle_poppers_;
+            pop_condition_.wait(lock, [this, buffer_left]() {
+                return !valid_ || !urgent_queue_.empty() || priority_ready() ||
+                       (lanes_size_ > 0 && priority_queue_size_ + buffer_left <= priority_limit_);
+            });
+            --idle_poppers_;
+        }
+        return false;
+    }
 #pragma GCC diagnostic pop
 
+    template <typename T> bool ThreadPool::SafeQueue<T>::steal(T& out, size_t lane) {
+        if(lanes_size_ == 0) {
+            return false;
+        }
+
+        // Start with the own lane and continue with the neighbouring ones
+        for(size_t i = 0; i < lanes_.size(); ++i) {
+            auto& current = lanes_[(lane + i) % lanes_.size()];
+            std::lock_guard<std::mutex> lock{current.mutex};
+            if(!current.deque.empty()) {
+                out = std::move(current.deque.front());
+                current.deque.pop_front();
+                lanes_size_--;
+                if(i > 0) {
+                    stolen_++;
+                }
+                return true;
+            }
+        }
+        return false;
+    }
+
     template <typename T> bool ThreadPool::SafeQueue<T>::push(T value, bool wait) {
+        if(!lanes_.empty()) {
+            return push_lanes(std::move(value), wait);
+        }
+
         // Lock the mutex
         std::unique_lock<std::mutex> lock{mutex_};
 
@@ -113,12 +212,61 @@ namespace allpix {
         // Push a new element to the queue and notify possible consumer
         priority_queue_.emplace(n, std::move(value));
         priority_queue_size_++;
+        update_priority_top();
         lock.unlock();
         pop_condition_.notify_one();
         return true;
     }
 #pragma GCC diagnostic pop
 
+    template <typename T> bool ThreadPool::SafeQueue<T>::pushUrgent(T value) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        if(!valid_) {
+            return false;
+        }
+
+        // Push a new element to the queue and notify possible consumer
+        urgent_queue_.push_back(std::move(value));
+        urgent_size_++;
+        lock.unlock();
+        pop_condition_.notify_one();
+        return true;
+    }
+
+    template <typename T> bool ThreadPool::SafeQueue<T>::push_lanes(T value, bool wait) {
+        // Check if the lanes reached their combined full size
+        if(lanes_size_ >= max_standard_size_) {
+            // Wait until the lanes are below the max size or the queue was invalidated (shutdown)
+            if(!wait) {
+                return false;
+            }
+            std::unique_lock<std::mutex> lock{mutex_};
+            ++waiting_pushers_;
+            push_condition_.wait(lock, [this]() { return lanes_size_ < max_standard_size_ || !valid_; });
+            --waiting_pushers_;
+        }
+
+        // Abort the push operation if the queue has been invalidated
+        if(!valid_) {
+            return false;
+        }
+
+        // Distribute the jobs over the lanes in round-robin order
+        auto& lane = lanes_[next_lane_++ % lanes_.size()];
+        {
+            std::lock_guard<std::mutex> lock{lane.mutex};
+            lane.deque.push_back(std::move(value));
+            lanes_size_++;
+        }
+
+        // Wake up a sleeping worker if there is any
+        if(idle_poppers_ > 0) {
+            std::lock_guard<std::mutex> lock{mutex_};
+            pop_condition_.notify_one();
+        }
+        return true;
+    }
+
     template <typename T> void ThreadPool::SafeQueue<T>::complete(uint64_t n) {
         std::unique_lock<std::mutex> lock{mutex_};
         completed_ids_.insert(n);
@@ -135,10 +283,7 @@ namespace allpix {
         }
     }
 
-    template <typename T> uint64_t ThreadPool::SafeQueue<T>::currentId() const {
-        std::lock_guard<std::mutex> lock{mutex_};
-        return current_id_;
-    }
+    template <typename T> uint64_t ThreadPool::SafeQueue<T>::currentId() const { return current_id_; }
 
     template <typename T> bool ThreadPool::SafeQueue<T>::valid() const {
         std::lock_guard<std::mutex> lock{mutex_};
@@ -147,16 +292,26 @@ namespace allpix {
 
     template <typename T> bool ThreadPool::SafeQueue<T>::empty() const {
         std::lock_guard<std::mutex> lock{mutex_};
-        return !valid_ || (queue_.empty() && priority_queue_.empty());
+        return !valid_ || (queue_.empty() && lanes_size_ == 0 && priority_queue_.empty() && urgent_queue_.empty());
     }
 
     template <typename T> size_t ThreadPool::SafeQueue<T>::size() const {
         std::lock_guard<std::mutex> lock{mutex_};
-        return queue_.size() + priority_queue_.size();
+        return queue_.size() + lanes_size_ + priority_queue_.size() + urgent_queue_.size();
     }
 
     template <typename T> size_t ThreadPool::SafeQueue<T>::prioritySize() const { return priority_queue_size_; }
 
+    /*
+     * Workers waiting for the priority queue to drain are woken up, since a raised limit might allow them to continue
+     */
+    template <typename T> void ThreadPool::SafeQueue<T>::setPriorityLimit(size_t limit) {
+        std::unique_lock<std::mutex> lock{mutex_};
+        priority_limit_ = std::min(limit, max_priority_size_);
+        lock.unlock();
+        pop_condition_.notify_all();
+    }
+
     /*
      * Used to ensure no conditions are being waited for in pop when a thread or the application is trying to exit. The queue
      * is invalid after calling this method and it is an error to continue using a queue after this method has been called.
@@ -165,7 +320,15 @@ namespace allpix {
         std::unique_lock<std::mutex> lock{mutex_};
         std::priority_queue<PQValue, std::vector<PQValue>, std::greater<>>().swap(priority_queue_);
         priority_queue_size_ = 0;
+        update_priority_top();
         std::queue<T>().swap(queue_);
+        std::deque<T>().swap(urgent_queue_);
+        urgent_size_ = 0;
+        for(auto& lane : lanes_) {
+            std::lock_guard<std::mutex> lane_lock{lane.mutex};
+            std::deque<T>().swap(lane.deque);
+        }
+        lanes_size_ = 0;
         valid_ = false;
         lock.unlock();
         push_condition_.notify_all();
@@ -200,8 +363,7 @@ namespace allpix {
             } else {
                 success = queue_.push(n, std::make_unique<std::packaged_task<void()>>(std::move(task_function)), false);
             }
-            // Increment run count:
-            std::unique_lock<std::mutex> lock{run_mutex_};
+            // Increment run count, the mutex is only required when waking up threads waiting for the count to drop to zero
             ++run_cnt_;
         }
         if(success) {
@@ -211,4 +373,21 @@ namespace allpix {
         }
     }
 
+    template <typename Func> bool ThreadPool::submitUrgent(Func&& func) {
+        if(threads_.empty()) {
+            return false;
+        }
+
+        // Count the job before pushing it, such that waiting for the pool never misses it
+        ++run_cnt_;
+        if(queue_.pushUrgent(std::make_unique<std::packaged_task<void()>>(std::forward<Func>(func)))) {
+            return true;
+        }
+        if(--run_cnt_ == 0) {
+            std::lock_guard<std::mutex> lock{run_mutex_};
+            run_condition_.notify_all();
+        }
+        return false;
+    }
+
 } // namespace allpix
@@ -0,0 +1,112 @@
+/**
+ * @file
+ * @brief Implementation of lock-free per-thread histogram of execution times
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "TimingHistogram.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace allpix;
+
+TimingHistogram::TimingHistogram(unsigned int num_slots) : slots_(std::max(num_slots, 1u)) {}
+
+/**
+ * Since every slot is only written by a single thread, the counters are updated with relaxed loads and stores instead of
+ * atomic increments. The atomic types only guarantee that no torn values are read while merging.
+ */
+void TimingHistogram::record(unsigned int slot, int64_t duration) {
+    assert(slot < slots_.size());
+    auto& buckets = slots_[slot];
+    if(!buckets) {
+        buckets = std::make_unique<Slot>();
+    }
+
+    duration = std::max(duration, int64_t(0));
+    auto& count = buckets->counts[bucket_index(static_cast<uint64_t>(duration))];
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if(duration > buckets->max.load(std::memory_order_relaxed)) {
+        buckets->max.store(duration, std::memory_order_relaxed);
+    }
+}
+
+void TimingHistogram::merge() {
+    merged_.assign(bucket_count, 0);
+    merged_count_ = 0;
+    merged_max_ = 0;
+
+    for(const auto& buckets : slots_) {
+        if(!buckets) {
+            continue;
+        }
+        for(unsigned int i = 0; i < bucket_count; ++i) {
+            auto count = buckets->counts[i].load(std::memory_order_relaxed);
+            merged_[i] += count;
+            merged_count_ += count;
+        }
+        merged_max_ = std::max(merged_max_, buckets->max.load(std::memory_order_relaxed));
+    }
+}
+
+int64_t TimingHistogram::percentile(double percentile) const {
+    if(merged_count_ == 0) {
+        return 0;
+    }
+
+    // Find the bucket containing the requested rank, the largest value cannot exceed the recorded maximum
+    auto fraction = std::clamp(percentile, 0., 100.) / 100.;
+    auto rank = std::max(static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(merged_count_))), uint64_t(1));
+    uint64_t cumulative = 0;
+    for(unsigned int i = 0; i < bucket_count; ++i) {
+        cumulative += merged_[i];
+        if(cumulative >= rank) {
+            auto range = bucket_range(i);
+            return std::min(static_cast<int64_t>(range.first + range.second / 2), merged_max_);
+        }
+    }
+    return merged_max_;
+}
+
+void TimingHistogram::forEachBucket(const std::function<void(double, uint64_t)>& function) const {
+    for(unsigned int i = 0; i < merged_.size(); ++i) {
+        if(merged_[i] == 0) {
+            continue;
+        }
+        auto range = bucket_range(i);
+        function(static_cast<double>(range.first) + static_cast<double>(range.second) / 2., merged_[i]);
+    }
+}
+
+/**
+ * Durations below twice the number of sub-buckets are stored exactly. For larger durations, the magnitude is given by the
+ * position of the highest set bit beyond the sub-bucket resolution and the sub-bucket by the leading bits of the duration.
+ * Durations beyond the maximum magnitude are stored in the last bucket.
+ */
+unsigned int TimingHistogram::bucket_index(uint64_t duration) {
+    duration = std::min(duration, (uint64_t(1) << max_magnitude) - 1);
+    if(duration < 2 * sub_bucket_count) {
+        return static_cast<unsigned int>(duration);
+    }
+
+    unsigned int highest_bit = 63u - static_cast<unsigned int>(__builtin_clzll(duration));
+    unsigned int magnitude = highest_bit - sub_bucket_bits;
+    return magnitude * sub_bucket_count + static_cast<unsigned int>(duration >> magnitude);
+}
+
+std::pair<uint64_t, uint64_t> TimingHistogram::bucket_range(unsigned int index) {
+    if(index < 2 * sub_bucket_count) {
+        return {index, 1};
+    }
+
+    unsigned int magnitude = index / sub_bucket_count - 1;
+    uint64_t sub_bucket = index - magnitude * sub_bucket_count;
+    return {sub_bucket << magnitude, uint64_t(1) << magnitude};
+}
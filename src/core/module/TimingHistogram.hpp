@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @brief Definition of lock-free per-thread histogram of execution times
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_TIMING_HISTOGRAM_H
+#define ALLPIX_TIMING_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace allpix {
+    /**
+     * @brief Histogram of execution times with logarithmic buckets, filled independently by every thread
+     *
+     * Durations are sorted into buckets following the scheme of HDR histograms: durations below 32ns are stored exactly,
+     * each larger power of two is divided into 16 linear buckets. This keeps the relative bucket width below about 6% over
+     * the full range of durations up to roughly 18 minutes with a fixed number of buckets.
+     *
+     * Every thread fills its own set of buckets, indexed by its thread number, without any locking or atomic read-modify-
+     * write operations. The buckets of a thread are only allocated when it records its first duration. All threads are
+     * merged after the event loop, when no more durations are recorded.
+     */
+    class TimingHistogram {
+    public:
+        /**
+         * @brief Construct the histogram
+         * @param num_slots Number of threads which can record durations, typically \ref ThreadPool::threadCount
+         */
+        explicit TimingHistogram(unsigned int num_slots);
+
+        /**
+         * @brief Record a duration for the calling thread
+         * @param slot     Thread number of the calling thread, typically \ref ThreadPool::threadNum
+         * @param duration Duration in nanoseconds
+         * @warning Every slot may only be filled by a single thread at a time
+         */
+        void record(unsigned int slot, int64_t duration);
+
+        /**
+         * @brief Merge the durations recorded by all threads
+         * @warning Should only be called when no thread is recording durations anymore
+         */
+        void merge();
+
+        /**
+         * @brief Get the total number of recorded durations
+         * @return Number of durations, only valid after \ref merge
+         */
+        uint64_t count() const { return merged_count_; }
+
+        /**
+         * @brief Get the longest recorded duration
+         * @return Maximum duration in nanoseconds, only valid after \ref merge
+         */
+        int64_t max() const { return merged_max_; }
+
+        /**
+         * @brief Get a percentile of the recorded durations
+         * @param percentile Percentile to calculate, between 0 and 100
+         * @return Center of the bucket containing the percentile in nanoseconds, only valid after \ref merge
+         */
+        int64_t percentile(double percentile) const;
+
+        /**
+         * @brief Call a function for all non-empty buckets, e.g. to fill a ROOT histogram
+         * @param function Function called with the center of the bucket in nanoseconds and the number of entries
+         */
+        void forEachBucket(const std::function<void(double, uint64_t)>& function) const;
+
+    private:
+        static constexpr unsigned int sub_bucket_bits = 4;
+        static constexpr unsigned int sub_bucket_count = 1u << sub_bucket_bits;
+        static constexpr unsigned int max_magnitude = 40;
+        static constexpr unsigned int bucket_count = (max_magnitude - sub_bucket_bits + 1) * sub_bucket_count;
+
+        /**
+         * @brief Get the index of the bucket for a duration
+         * @param duration Duration in nanoseconds
+         * @return Index of the bucket
+         */
+        static unsigned int bucket_index(uint64_t duration);
+
+        /**
+         * @brief Get the lower edge and the width of a bucket
+         * @param index Index of the bucket
+         * @return Lower edge and width of the bucket in nanoseconds
+         */
+        static std::pair<uint64_t, uint64_t> bucket_range(unsigned int index);
+
+        // Buckets of a single thread, aligned to avoid sharing cache lines between threads
+        struct alignas(64) Slot {
+            std::array<std::atomic<uint64_t>, bucket_count> counts{};
+            std::atomic<int64_t> max{0};
+        };
+        std::vector<std::unique_ptr<Slot>> slots_;
+
+        std::vector<uint64_t> merged_;
+        uint64_t merged_count_{0};
+        int64_t merged_max_{0};
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_TIMING_HISTOGRAM_H */
@@ -214,9 +214,9 @@ DefaultLogger::getStream(LogLevel level, const std::string& file, const std::str
     }
 
     // Add section if available
-    if(!get_section().empty()) {
+    if(!get_section()->empty()) {
         os << "\x1B[1m"; // BOLD
-        os << "[" << get_section() << "] ";
+        os << "[" << *get_section() << "] ";
         os << "\x1B[0m"; // RESET
     }
 
@@ -358,13 +358,24 @@ void DefaultLogger::addStream(std::ostream& stream) {
     get_streams().push_back(&stream);
 }
 
-// Getters and setters for the section header
-std::string& DefaultLogger::get_section() {
+// Getters and setters for the section header, which is either stored internally or referenced
+std::string& DefaultLogger::get_section_storage() {
     thread_local std::string section;
     return section;
 }
-void DefaultLogger::setSection(std::string section) { get_section() = std::move(section); }
-std::string DefaultLogger::getSection() { return get_section(); }
+const std::string*& DefaultLogger::get_section() {
+    thread_local const std::string* section = &get_section_storage();
+    return section;
+}
+void DefaultLogger::setSection(std::string section) {
+    get_section_storage() = std::move(section);
+    get_section() = &get_section_storage();
+}
+std::string DefaultLogger::getSection() { return *get_section(); }
+void DefaultLogger::setSectionReference(const std::string* section) {
+    get_section() = (section != nullptr ? section : &get_section_storage());
+}
+const std::string* DefaultLogger::getSectionReference() { return get_section(); }
 
 // Getters and setters for the event number
 uint64_t& DefaultLogger::get_event_num() {
@@ -187,6 +187,18 @@ namespace allpix {
          * @return Header used
          */
         static std::string getSection();
+        /**
+         * @brief Use a section header stored externally from now on, avoiding to copy it
+         * @param header Pointer to the header to use, which needs to outlive its use, or nullptr for the internal header
+         * @warning Setting a section header via \ref setSection overwrites the internally stored header. References to it
+         *          obtained from \ref getSectionReference will therefore point to the new header.
+         */
+        static void setSectionReference(const std::string* header);
+        /**
+         * @brief Get a reference to the current section header
+         * @return Pointer to the header used
+         */
+        static const std::string* getSectionReference();
 
         /**
          * @brief Set the current event number from now on
@@ -221,7 +233,8 @@ namespace allpix {
         unsigned int indent_count_{};
 
         // Internal methods to store static values
-        static std::string& get_section();
+        static std::string& get_section_storage();
+        static const std::string*& get_section();
         static uint64_t& get_event_num();
         static LogLevel& get_reporting_level();
         static LogFormat& get_format();
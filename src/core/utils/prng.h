@@ -1,6 +1,6 @@
 /**
  * @file
- * @brief Provides a wrapper around the STL pseudo-random number generator Mersenne Twister
+ * @brief Provides a wrapper around the STL pseudo-random number generator Mersenne Twister and a counter-based alternative
  *
  * @copyright Copyright (c) 2020-2025 CERN and the Allpix Squared authors.
  * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
@@ -12,17 +12,141 @@
 #ifndef ALLPIX_PRNG_H
 #define ALLPIX_PRNG_H
 
+#include "core/utils/distributions.h"
 #include "core/utils/log.h"
 
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
 #include <random>
 
 namespace allpix {
 
     /**
-     * @brief Wrapper around the STL's Mersenne Twister
+     * @brief Counter-based Philox4x32-10 engine
+     *
+     * The engine encrypts a 128-bit counter with a key given by the seed in ten rounds of multiplications, following Salmon
+     * et al., "Parallel Random Numbers: As Easy as 1, 2, 3" (SC11). Each counter value yields two 64-bit numbers. The state
+     * only consists of the seed and the position in the sequence, which allows to skip ahead in constant time and to copy
+     * the state cheaply. The engine satisfies the requirements of a uniform random bit generator.
+     */
+    class PhiloxEngine {
+    public:
+        using result_type = std::uint64_t;
+        static constexpr result_type default_seed = 5489u;
+
+        /**
+         * @brief Construct the engine with a seed
+         * @param value Seed of the engine
+         */
+        explicit PhiloxEngine(result_type value = default_seed) { seed(value); }
+
+        /**
+         * @brief Seed the engine and reset the position to the start of the sequence
+         * @param value Seed of the engine
+         */
+        void seed(result_type value = default_seed) {
+            key_ = {static_cast<std::uint32_t>(value), static_cast<std::uint32_t>(value >> 32)};
+            position_ = 0;
+            cached_block_ = std::numeric_limits<std::uint64_t>::max();
+        }
+
+        /**
+         * @brief Retrieve the next number of the sequence
+         * @return 64-bit pseudo-random number
+         */
+        result_type operator()() {
+            auto block = position_ / 2;
+            if(block != cached_block_) {
+                generate(block, buffer_.data());
+                cached_block_ = block;
+            }
+            return buffer_[position_++ % 2];
+        }
+
+        /**
+         * @brief Advance the sequence without generating the numbers
+         * @param count Number of values to skip
+         */
+        void discard(unsigned long long count) { position_ += count; }
+
+        /**
+         * @brief Fill an array with the next numbers of the sequence
+         * @param out   Array to fill
+         * @param count Number of values to generate
+         *
+         * Complete blocks are written directly to the output without passing through the internal buffer.
+         */
+        void fill(result_type* out, std::size_t count) {
+            std::size_t n = 0;
+            if(position_ % 2 != 0 && count > 0) {
+                out[n++] = (*this)();
+            }
+            for(; n + 2 <= count; n += 2) {
+                generate(position_ / 2, out + n);
+                position_ += 2;
+            }
+            if(n < count) {
+                out[n] = (*this)();
+            }
+        }
+
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    private:
+        /**
+         * @brief Compute the two numbers of a block by encrypting the block counter with the key
+         * @param block Counter of the block
+         * @param out   Array of two values to write the result to
+         */
+        void generate(std::uint64_t block, result_type* out) const {
+            std::array<std::uint32_t, 4> ctr = {
+                static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32), 0, 0};
+            auto key = key_;
+            for(unsigned int round = 0; round < 10; ++round) {
+                auto product0 = static_cast<std::uint64_t>(0xD2511F53) * ctr[0];
+                auto product1 = static_cast<std::uint64_t>(0xCD9E8D57) * ctr[2];
+                ctr = {static_cast<std::uint32_t>(product1 >> 32) ^ ctr[1] ^ key[0],
+                       static_cast<std::uint32_t>(product1),
+                       static_cast<std::uint32_t>(product0 >> 32) ^ ctr[3] ^ key[1],
+                       static_cast<std::uint32_t>(product0)};
+                key[0] += 0x9E3779B9;
+                key[1] += 0xBB67AE85;
+            }
+            out[0] = (static_cast<std::uint64_t>(ctr[1]) << 32) | ctr[0];
+            out[1] = (static_cast<std::uint64_t>(ctr[3]) << 32) | ctr[2];
+        }
+
+        std::array<std::uint32_t, 2> key_{};
+        std::uint64_t position_{0};
+        std::uint64_t cached_block_{std::numeric_limits<std::uint64_t>::max()};
+        std::array<result_type, 2> buffer_{};
+    };
+
+    /**
+     * @brief Wrapper around the STL's Mersenne Twister, optionally replaced by a counter-based engine
+     *
+     * The engine used is selected when constructing the generator from the default engine, which is configured globally via
+     * the `random_engine` parameter, and can be changed explicitly with \ref setEngine before seeding.
      */
     class RandomNumberGenerator : public std::mt19937_64 {
     public:
+        /**
+         * @brief Type of the underlying pseudo-random number engine
+         */
+        enum class Engine {
+            MERSENNE_TWISTER, ///< 64-bit Mersenne Twister mt19937_64 of the STL
+            PHILOX,           ///< Counter-based Philox4x32-10 engine
+        };
+
+        /**
+         * @brief Construct the generator with the current default engine
+         */
+        RandomNumberGenerator() : engine_(default_engine_) {}
+
         /// @{
         /**
          * @brief Disallow copy-assignment
@@ -35,6 +159,94 @@ namespace allpix {
          */
         RandomNumberGenerator& operator=(RandomNumberGenerator&&) = delete;
 
+        /**
+         * @brief Set the engine used by generators constructed afterwards
+         * @param engine Default engine
+         */
+        static void setDefaultEngine(Engine engine) { default_engine_ = engine; }
+
+        /**
+         * @brief Get the engine used by newly constructed generators
+         * @return Default engine
+         */
+        static Engine getDefaultEngine() { return default_engine_; }
+
+        /**
+         * @brief Change the engine of this generator, the generator needs to be seeded afterwards
+         * @param engine Engine to use
+         */
+        void setEngine(Engine engine) { engine_ = engine; }
+
+        /**
+         * @brief Get the engine of this generator
+         * @return Engine in use
+         */
+        Engine getEngine() const { return engine_; }
+
+        /**
+         * Redefine seeding function to only seed the engine in use. Technically we are shadowing the base class function.
+         *
+         * @param value Seed for the engine
+         */
+        void seed(result_type value = default_seed) {
+            if(engine_ == Engine::PHILOX) {
+                philox_.seed(value);
+            } else {
+                std::mt19937_64::seed(value);
+            }
+        }
+
+        /**
+         * Redefine discarding function to skip ahead in constant time with the counter-based engine. Technically we are
+         * shadowing the base class function.
+         *
+         * @param count Number of values to skip
+         */
+        void discard(unsigned long long count) {
+            if(engine_ == Engine::PHILOX) {
+                philox_.discard(count);
+            } else {
+                std::mt19937_64::discard(count);
+            }
+        }
+
+        /**
+         * @brief Binary copy of the internal state of the generator
+         */
+        struct Snapshot {
+            Engine engine{Engine::MERSENNE_TWISTER};
+            std::mt19937_64 mersenne_twister;
+            PhiloxEngine philox;
+        };
+
+        /**
+         * @brief Store the current state of the generator in a binary snapshot
+         * @param snapshot Snapshot the state is copied to
+         *
+         * The state words are copied directly instead of being formatted as text by the stream operators of the engine.
+         */
+        void saveState(Snapshot& snapshot) const {
+            snapshot.engine = engine_;
+            if(engine_ == Engine::PHILOX) {
+                snapshot.philox = philox_;
+            } else {
+                snapshot.mersenne_twister = *this;
+            }
+        }
+
+        /**
+         * @brief Restore the state of the generator from a binary snapshot
+         * @param snapshot Snapshot previously filled by \ref saveState
+         */
+        void restoreState(const Snapshot& snapshot) {
+            engine_ = snapshot.engine;
+            if(engine_ == Engine::PHILOX) {
+                philox_ = snapshot.philox;
+            } else {
+                std::mt19937_64::operator=(snapshot.mersenne_twister);
+            }
+        }
+
         /**
          * Redefine function operator to retrieve pseudo-random numbers. This allows us to log the number at retrieval.
          * Technically we are shadowing the base class operator since it is non-virtual and explicitly call it from within.
@@ -44,14 +256,107 @@ namespace allpix {
         std::uint_fast64_t operator()() {
             // Only copy if we want to log it
             IFLOG(PRNG) {
-                auto prn = std::mt19937_64::operator()();
+                auto prn = next();
                 LOG(PRNG) << "Using random number " << prn;
                 return prn;
             }
             else {
-                return std::mt19937_64::operator()();
+                return next();
+            }
+        }
+
+        /**
+         * @brief Fill an array with pseudo-random numbers in a single call
+         * @param out   Array to fill
+         * @param count Number of values to generate
+         */
+        void fill(std::uint64_t* out, std::size_t count) {
+            if(engine_ == Engine::PHILOX) {
+                philox_.fill(out, count);
+                LOG(PRNG) << "Using block of " << count << " random numbers";
+            } else {
+                for(std::size_t n = 0; n < count; ++n) {
+                    out[n] = (*this)();
+                }
+            }
+        }
+
+        /**
+         * @brief Fill an array with uniformly distributed numbers in a single call
+         * @param out   Array to fill
+         * @param count Number of values to generate
+         *
+         * The values are uniformly distributed in the interval [0, 1). With the counter-based engine, the block is generated
+         * at once with a resolution of 53 bits. With the Mersenne Twister, the values are drawn one by one from the uniform
+         * distribution to reproduce the sequence of earlier versions.
+         */
+        void fillUniform(double* out, std::size_t count) {
+            if(engine_ != Engine::PHILOX) {
+                allpix::uniform_real_distribution<double> distribution(0, 1);
+                for(std::size_t n = 0; n < count; ++n) {
+                    out[n] = distribution(*this);
+                }
+                return;
+            }
+
+            static_assert(sizeof(double) == sizeof(std::uint64_t));
+            auto* bits = reinterpret_cast<std::uint64_t*>(out); // NOLINT
+            fill(bits, count);
+            for(std::size_t n = 0; n < count; ++n) {
+                out[n] = static_cast<double>(bits[n] >> 11) * 0x1.0p-53;
             }
         }
+
+        /**
+         * @brief Fill an array with normally distributed numbers in a single call
+         * @param out    Array to fill
+         * @param count  Number of values to generate
+         * @param mean   Mean of the distribution
+         * @param stddev Standard deviation of the distribution
+         *
+         * With the counter-based engine, pairs of uniformly distributed numbers are transformed to pairs of normally
+         * distributed numbers using the Box-Muller transform, and the second number of the last pair is dropped for an odd
+         * count. With the Mersenne Twister, the values are drawn one by one from the normal distribution to reproduce the
+         * sequence of earlier versions.
+         */
+        void fillNormal(double* out, std::size_t count, double mean = 0., double stddev = 1.) {
+            if(engine_ != Engine::PHILOX) {
+                allpix::normal_distribution<double> distribution(mean, stddev);
+                for(std::size_t n = 0; n < count; ++n) {
+                    out[n] = distribution(*this);
+                }
+                return;
+            }
+
+            fillUniform(out, count);
+            for(std::size_t n = 0; n < count; n += 2) {
+                auto u1 = 1. - out[n];
+                auto u2 = (n + 1 < count ? out[n + 1] : uniform());
+                auto radius = stddev * std::sqrt(-2. * std::log(u1));
+                auto angle = 2. * M_PI * u2;
+                out[n] = mean + radius * std::cos(angle);
+                if(n + 1 < count) {
+                    out[n + 1] = mean + radius * std::sin(angle);
+                }
+            }
+        }
+
+    private:
+        /**
+         * @brief Retrieve the next number from the engine in use
+         * @return 64-bit pseudo-random number
+         */
+        std::uint_fast64_t next() { return engine_ == Engine::PHILOX ? philox_() : std::mt19937_64::operator()(); }
+
+        /**
+         * @brief Retrieve a single uniformly distributed number in the interval [0, 1)
+         * @return Uniformly distributed number
+         */
+        double uniform() { return static_cast<double>(next() >> 11) * 0x1.0p-53; }
+
+        Engine engine_;
+        PhiloxEngine philox_;
+        static inline Engine default_engine_{Engine::MERSENNE_TWISTER};
     };
 } // namespace allpix
 
@@ -385,13 +385,13 @@ void CSADigitizerModule::run(Event* event) {
 
     if(!pulses.empty()) {
         // Create and dispatch hit message
-        auto pulses_message = std::make_shared<PixelPulseMessage>(std::move(pulses), getDetector());
+        auto pulses_message = event->makeShared<PixelPulseMessage>(std::move(pulses), getDetector());
         messenger_->dispatchMessage(this, pulses_message, event);
     }
 
     if(!hits.empty()) {
         // Create and dispatch hit message
-        auto hits_message = std::make_shared<PixelHitMessage>(std::move(hits), getDetector());
+        auto hits_message = event->makeShared<PixelHitMessage>(std::move(hits), getDetector());
         messenger_->dispatchMessage(this, hits_message, event);
     }
 }
@@ -413,7 +413,7 @@ void CapacitiveTransferModule::run(Event* event) {
     total_transferred_charges_ += transferred_charges_count;
 
     // Dispatch message of pixel charges
-    auto pixel_message = std::make_shared<PixelChargeMessage>(pixel_charges, detector_);
+    auto pixel_message = event->makeShared<PixelChargeMessage>(pixel_charges, detector_);
     messenger_->dispatchMessage(this, pixel_message, event);
 }
 
@@ -34,14 +34,17 @@ CorryvreckanWriterModule::CorryvreckanWriterModule(Configuration& config, Messen
     config_.setDefault("geometry_file", "corryvreckanGeometry.conf");
     config_.setDefault("global_timing", false);
     config_.setDefault("output_mctruth", true);
+
+    // Check if MC data to be saved
+    output_mc_truth_ = config_.get<bool>("output_mctruth");
+    if(output_mc_truth_) {
+        require_history(HistoryMode::PARTICLES);
+    }
 }
 
 // Set up the output trees
 void CorryvreckanWriterModule::initialize() {
 
-    // Check if MC data to be saved
-    output_mc_truth_ = config_.get<bool>("output_mctruth");
-
     reference_ = config_.get<std::string>("reference");
     if(!geometryManager_->hasDetector(reference_)) {
         throw InvalidValueError(config_, "reference", "detector not defined");
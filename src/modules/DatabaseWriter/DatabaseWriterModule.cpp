@@ -34,6 +34,8 @@ DatabaseWriterModule::DatabaseWriterModule(Configuration& config, Messenger* mes
     : SequentialModule(config), messenger_(messenger) {
     // Enable multithreading of this module if multithreading is enabled
     allow_multithreading();
+    // Storing the objects requires all relations between them
+    require_history(HistoryMode::FULL);
     // Bind to all messages with filter
     messenger_->registerFilter(this, &DatabaseWriterModule::filter);
 
@@ -29,6 +29,9 @@ DefaultDigitizerModule::DefaultDigitizerModule(Configuration& config,
     // Enable multithreading of this module if multithreading is enabled
     allow_multithreading();
 
+    // Enable processing of multiple events at once, sharing the pixel selection
+    allow_batch_processing();
+
     if(config_.has("gain") && config_.has("gain_function")) {
         throw InvalidCombinationError(
             config_, {"gain", "gain_function"}, "Gain and Gain Function cannot be simultaneously configured.");
@@ -217,6 +220,18 @@ void DefaultDigitizerModule::initialize() {
 }
 
 void DefaultDigitizerModule::run(Event* event) {
+    digitize(event, sample_all_channels_ ? getDetector()->getModel()->getPixels() : std::set<Pixel::Index>());
+}
+
+void DefaultDigitizerModule::runBatch(const std::vector<Event*>& events) {
+    // Only look up the full pixel matrix once for all events of the batch
+    const auto all_pixels = (sample_all_channels_ ? getDetector()->getModel()->getPixels() : std::set<Pixel::Index>());
+    for(auto* event : events) {
+        digitize(event, all_pixels);
+    }
+}
+
+void DefaultDigitizerModule::digitize(Event* event, const std::set<Pixel::Index>& all_pixels) {
 
     // We might not have a pixel charge message available:
     std::shared_ptr<PixelChargeMessage> pixel_message{nullptr};
@@ -230,17 +245,14 @@ void DefaultDigitizerModule::run(Event* event) {
     const std::vector<PixelCharge>& dummy = std::vector<PixelCharge>();
     const auto& pixel_charges = (pixel_message ? pixel_message->getData() : dummy);
 
-    // Select what to iterate over:
-    std::set<Pixel::Index> pixels;
-    if(sample_all_channels_) {
-        // Loop through all pixels of the matrix
-        pixels = getDetector()->getModel()->getPixels();
-    } else {
-        // Loop only over pixels with a PixelCharge entry
+    // Select what to iterate over, either all pixels of the matrix or only pixels with a PixelCharge entry
+    std::set<Pixel::Index> charged_pixels;
+    if(!sample_all_channels_) {
         for(const auto& px : pixel_charges) {
-            pixels.emplace(px.getIndex());
+            charged_pixels.emplace(px.getIndex());
         }
     }
+    const auto& pixels = (sample_all_channels_ ? all_pixels : charged_pixels);
 
     std::vector<PixelHit> hits;
     // Loop over selected channels:
@@ -384,7 +396,7 @@ void DefaultDigitizerModule::run(Event* event) {
 
     if(!hits.empty()) {
         // Create and dispatch hit message
-        auto hits_message = std::make_shared<PixelHitMessage>(std::move(hits), getDetector());
+        auto hits_message = event->makeShared<PixelHitMessage>(std::move(hits), getDetector());
         messenger_->dispatchMessage(this, hits_message, event);
     }
 }
@@ -13,7 +13,9 @@
 #define ALLPIX_DEFAULT_DIGITIZER_MODULE_H
 
 #include <memory>
+#include <set>
 #include <string>
+#include <vector>
 
 #include "core/config/Configuration.hpp"
 #include "core/messenger/Messenger.hpp"
@@ -58,6 +60,11 @@ namespace allpix {
          */
         void run(Event*) override;
 
+        /**
+         * @brief Simulate digitization process for a batch of events
+         */
+        void runBatch(const std::vector<Event*>& events) override;
+
         /**
          * @brief Finalize and write optional histograms
          */
@@ -66,6 +73,13 @@ namespace allpix {
     private:
         Messenger* messenger_;
 
+        /**
+         * @brief Helper function to digitize the pixel charges of a single event
+         * @param event        Event to digitize
+         * @param all_pixels   Set of all pixels of the matrix, only used if all channels are sampled
+         */
+        void digitize(Event* event, const std::set<Pixel::Index>& all_pixels);
+
         /**
          * @brief Helper function to calculate time of crossing the threshold
          * @param  pixel_charge PixelCharge object to calculate the threshold crossing for
@@ -224,7 +224,7 @@ void SensitiveDetectorActionG4::dispatchMessages(Module* module, Messenger* mess
     }
 
     // Send the mc particle information
-    auto mc_particle_message = std::make_shared<MCParticleMessage>(std::move(mc_particles), detector_);
+    auto mc_particle_message = event->makeShared<MCParticleMessage>(std::move(mc_particles), detector_);
     messenger->dispatchMessage(module, mc_particle_message, event);
 
     // Send a deposit message if we have any deposits
@@ -268,7 +268,7 @@ void SensitiveDetectorActionG4::dispatchMessages(Module* module, Messenger* mess
         LOG(INFO) << "Deposited " << charges << " charges in sensor of detector " << detector_->getName();
 
         // Create a new charge deposit message
-        auto deposit_message = std::make_shared<DepositedChargeMessage>(std::move(deposits), detector_);
+        auto deposit_message = event->makeShared<DepositedChargeMessage>(std::move(deposits), detector_);
 
         // Dispatch the message
         messenger->dispatchMessage(module, std::move(deposit_message), event);
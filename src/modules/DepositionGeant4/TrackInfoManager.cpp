@@ -68,7 +68,7 @@ void TrackInfoManager::dispatchMessage(Module* module, Messenger* messenger, Eve
                        << " and terminates at: " << Units::display(mc_track.getEndPoint(), {"mm", "um"});
         }
     }
-    auto mc_track_message = std::make_shared<MCTrackMessage>(std::move(stored_tracks_));
+    auto mc_track_message = event->makeShared<MCTrackMessage>(std::move(stored_tracks_));
     messenger->dispatchMessage(module, std::move(mc_track_message), event);
 }
 
@@ -405,12 +405,12 @@ void DepositionLaserModule::run(Event* event) {
     // Dispatch messages
     for(auto& [detector, data] : mc_particles) {
         LOG(INFO) << "    " << detector->getName() << ": " << data.size() << " hits";
-        auto mcparticle_message = std::make_shared<MCParticleMessage>(std::move(data), detector);
+        auto mcparticle_message = event->makeShared<MCParticleMessage>(std::move(data), detector);
         messenger_->dispatchMessage(this, std::move(mcparticle_message), event);
     }
 
     for(auto& [detector, data] : deposited_charges) {
-        auto charge_message = std::make_shared<DepositedChargeMessage>(std::move(data), detector);
+        auto charge_message = event->makeShared<DepositedChargeMessage>(std::move(data), detector);
         messenger_->dispatchMessage(this, std::move(charge_message), event);
     }
 }
@@ -328,10 +328,10 @@ void DepositionPointChargeModule::DepositPoint(Event* event, const ROOT::Math::X
                << Units::display(position_global, {"um", "mm"}) << " in detector " << detector_->getName();
 
     // Dispatch the messages to the framework
-    auto mcparticle_message = std::make_shared<MCParticleMessage>(std::move(mcparticles), detector_);
+    auto mcparticle_message = event->makeShared<MCParticleMessage>(std::move(mcparticles), detector_);
     messenger_->dispatchMessage(this, std::move(mcparticle_message), event);
 
-    auto deposit_message = std::make_shared<DepositedChargeMessage>(std::move(charges), detector_);
+    auto deposit_message = event->makeShared<DepositedChargeMessage>(std::move(charges), detector_);
     messenger_->dispatchMessage(this, std::move(deposit_message), event);
 }
 
@@ -391,10 +391,10 @@ void DepositionPointChargeModule::DepositLine(Event* event, const ROOT::Math::XY
     }
 
     // Dispatch the messages to the framework
-    auto mcparticle_message = std::make_shared<MCParticleMessage>(std::move(mcparticles), detector_);
+    auto mcparticle_message = event->makeShared<MCParticleMessage>(std::move(mcparticles), detector_);
     messenger_->dispatchMessage(this, std::move(mcparticle_message), event);
 
-    auto deposit_message = std::make_shared<DepositedChargeMessage>(std::move(charges), detector_);
+    auto deposit_message = event->makeShared<DepositedChargeMessage>(std::move(charges), detector_);
     messenger_->dispatchMessage(this, std::move(deposit_message), event);
 }
 
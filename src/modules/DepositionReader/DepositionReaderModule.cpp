@@ -368,7 +368,7 @@ void DepositionReaderModule::run(Event* event) {
 
         // Send the mc particle information if available
         bool has_mcparticles = !mc_particles.empty();
-        auto mc_particle_message = std::make_shared<MCParticleMessage>(std::move(mc_particles), detector);
+        auto mc_particle_message = event->makeShared<MCParticleMessage>(std::move(mc_particles), detector);
         if(has_mcparticles) {
             messenger_->dispatchMessage(this, mc_particle_message, event);
         }
@@ -404,7 +404,7 @@ void DepositionReaderModule::run(Event* event) {
 
             // Create a new charge deposit message
             LOG(DEBUG) << "Detector " << detector->getName() << " has " << deposits[detector].size() << " deposits";
-            auto deposit_message = std::make_shared<DepositedChargeMessage>(std::move(deposits[detector]), detector);
+            auto deposit_message = event->makeShared<DepositedChargeMessage>(std::move(deposits[detector]), detector);
 
             // Dispatch the message
             messenger_->dispatchMessage(this, deposit_message, event);
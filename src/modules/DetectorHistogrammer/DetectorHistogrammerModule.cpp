@@ -35,6 +35,9 @@ DetectorHistogrammerModule::DetectorHistogrammerModule(Configuration& config,
     // Enable multithreading of this module if multithreading is enabled
     allow_multithreading();
 
+    // Requires the Monte-Carlo particles of the pixel hits
+    require_history(HistoryMode::PARTICLES);
+
     // Bind messages
     messenger_->bindSingle<PixelHitMessage>(this);
     messenger_->bindSingle<MCParticleMessage>(this, MsgFlags::REQUIRED);
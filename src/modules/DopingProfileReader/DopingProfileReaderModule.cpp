@@ -46,7 +46,17 @@ void DopingProfileReaderModule::initialize() {
         auto field_mapping = config_.get<FieldMapping>("field_mapping");
         LOG(DEBUG) << "Doping concentration maps to " << magic_enum::enum_name(field_mapping);
 
-        auto field_data = read_field();
+        // Read interpolation between the field bins
+        auto interpolation = config_.get<FieldInterpolation>("interpolation", FieldInterpolation::NEAREST);
+        LOG(DEBUG) << "Doping profile uses " << magic_enum::enum_name(interpolation) << " interpolation";
+
+        // Read memory layout of the field grid
+        auto layout = config_.get<FieldLayout>("field_layout", FieldLayout::FLAT);
+        LOG(DEBUG) << "Doping profile is stored in " << magic_enum::enum_name(layout) << " layout";
+
+        // Read precision in which the field grid is stored
+        auto precision = config_.get<FieldPrecision>("field_precision", FieldPrecision::DOUBLE);
+        LOG(DEBUG) << "Doping profile is stored in " << magic_enum::enum_name(precision) << " precision";
 
         // By default, set field scale from physical extent read from field file:
         std::array<double, 2> field_scale{{1.0, 1.0}};
@@ -69,13 +79,23 @@ void DopingProfileReaderModule::initialize() {
         }
         LOG(DEBUG) << "Doping profile has offset of " << offset << " fractions of the field size";
 
-        detector_->setDopingProfileGrid(field_data.getData(),
-                                        field_data.getDimensions(),
-                                        field_data.getSize(),
-                                        field_mapping,
-                                        field_scale,
-                                        {{offset.x(), offset.y()}},
-                                        thickness_domain);
+        // Read the field in the requested precision and apply it to the detector
+        auto set_field_grid = [&](const auto& field_data) {
+            detector_->setDopingProfileGrid(field_data.getData(),
+                                            field_data.getDimensions(),
+                                            field_data.getSize(),
+                                            field_mapping,
+                                            field_scale,
+                                            {{offset.x(), offset.y()}},
+                                            thickness_domain,
+                                            interpolation,
+                                            layout);
+        };
+        if(precision == FieldPrecision::FLOAT) {
+            set_field_grid(read_field(float_field_parser_));
+        } else {
+            set_field_grid(read_field(field_parser_));
+        }
 
     } else if(field_model == DopingProfile::CONSTANT) {
         LOG(TRACE) << "Adding constant doping concentration";
@@ -115,6 +135,10 @@ void DopingProfileReaderModule::initialize() {
         detector_->setDopingProfileFunction(std::move(function), FieldType::CUSTOM1D);
     }
 
+    // Report the doping concentration at the center of the first pixel for reference
+    LOG(DEBUG) << "Doping concentration at the center of the first pixel is "
+               << Units::display(detector_->getDopingConcentration(model->getPixelCenter(0, 0)), {"/cm/cm/cm"});
+
     // Produce doping_concentration_histograms if needed
     if(config_.get<bool>("output_plots", false)) {
         create_output_plots();
@@ -125,16 +149,19 @@ void DopingProfileReaderModule::initialize() {
  * The field read from the INIT format are shared between module instantiations using the static FieldParser.
  */
 FieldParser<double> DopingProfileReaderModule::field_parser_(FieldQuantity::SCALAR);
-FieldData<double> DopingProfileReaderModule::read_field() {
+FieldParser<float> DopingProfileReaderModule::float_field_parser_(FieldQuantity::SCALAR);
+template <typename T> FieldData<T> DopingProfileReaderModule::read_field(FieldParser<T>& field_parser) {
 
     try {
         LOG(TRACE) << "Fetching doping concentration map from mesh file";
 
         // Get field from file
-        auto field_data = field_parser_.getByFileName(config_.getPath("file_name", true), "/cm/cm/cm");
+        auto field_data = field_parser.getByFileName(config_.getPath("file_name", true), "/cm/cm/cm");
 
         LOG(INFO) << "Set doping concentration map with " << field_data.getDimensions().at(0) << "x"
                   << field_data.getDimensions().at(1) << "x" << field_data.getDimensions().at(2) << " cells";
+        LOG(DEBUG) << "Doping concentration map occupies " << field_data.getData()->size() * sizeof(T) / 1024
+                   << " kB of memory";
 
         // Return the field data
         return field_data;
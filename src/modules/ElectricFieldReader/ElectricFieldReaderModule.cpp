@@ -76,7 +76,21 @@ void ElectricFieldReaderModule::initialize() {
         // Read field mapping from configuration
         auto field_mapping = config_.get<FieldMapping>("field_mapping");
         LOG(DEBUG) << "Electric field maps to " << magic_enum::enum_name(field_mapping);
-        auto field_data = read_field();
+
+        // Read interpolation between the field bins, tricubic interpolation is only available for scalar fields
+        auto interpolation = config_.get<FieldInterpolation>("interpolation", FieldInterpolation::NEAREST);
+        if(interpolation == FieldInterpolation::CUBIC) {
+            throw InvalidValueError(config_, "interpolation", "cubic interpolation is not available for vector fields");
+        }
+        LOG(DEBUG) << "Electric field uses " << magic_enum::enum_name(interpolation) << " interpolation";
+
+        // Read memory layout of the field grid
+        auto layout = config_.get<FieldLayout>("field_layout", FieldLayout::FLAT);
+        LOG(DEBUG) << "Electric field is stored in " << magic_enum::enum_name(layout) << " layout";
+
+        // Read precision in which the field grid is stored
+        auto precision = config_.get<FieldPrecision>("field_precision", FieldPrecision::DOUBLE);
+        LOG(DEBUG) << "Electric field is stored in " << magic_enum::enum_name(precision) << " precision";
 
         // By default, set field scale from physical extent read from field file:
         std::array<double, 2> field_scale{{1.0, 1.0}};
@@ -99,13 +113,23 @@ void ElectricFieldReaderModule::initialize() {
         }
         LOG(DEBUG) << "Electric field has offset of " << offset << " fractions of the field size";
 
-        detector_->setElectricFieldGrid(field_data.getData(),
-                                        field_data.getDimensions(),
-                                        field_data.getSize(),
-                                        field_mapping,
-                                        field_scale,
-                                        {{offset.x(), offset.y()}},
-                                        thickness_domain);
+        // Read the field in the requested precision and apply it to the detector
+        auto set_field_grid = [&](const auto& field_data) {
+            detector_->setElectricFieldGrid(field_data.getData(),
+                                            field_data.getDimensions(),
+                                            field_data.getSize(),
+                                            field_mapping,
+                                            field_scale,
+                                            {{offset.x(), offset.y()}},
+                                            thickness_domain,
+                                            interpolation,
+                                            layout);
+        };
+        if(precision == FieldPrecision::FLOAT) {
+            set_field_grid(read_field(float_field_parser_));
+        } else {
+            set_field_grid(read_field(field_parser_));
+        }
     } else if(field_model == ElectricField::CONSTANT) {
         LOG(TRACE) << "Adding constant electric field";
         auto field_z = config_.get<double>("bias_voltage") / getDetector()->getModel()->getSensorSize().z();
@@ -138,6 +162,10 @@ void ElectricFieldReaderModule::initialize() {
         detector_->setElectricFieldFunction(field_function, thickness_domain, field_type);
     }
 
+    // Report the field at the center of the first pixel for reference
+    LOG(DEBUG) << "Electric field magnitude at the center of the first pixel is "
+               << Units::display(detector_->getElectricField(model->getPixelCenter(0, 0)).R(), "V/cm");
+
     // Produce histograms if needed
     if(config_.get<bool>("output_plots", false)) {
         create_output_plots();
@@ -274,14 +302,15 @@ std::pair<FieldFunction<ROOT::Math::XYZVector>, FieldType> ElectricFieldReaderMo
  * FieldParser's getByFileName method.
  */
 FieldParser<double> ElectricFieldReaderModule::field_parser_(FieldQuantity::VECTOR);
-FieldData<double> ElectricFieldReaderModule::read_field() {
+FieldParser<float> ElectricFieldReaderModule::float_field_parser_(FieldQuantity::VECTOR);
+template <typename T> FieldData<T> ElectricFieldReaderModule::read_field(FieldParser<T>& field_parser) {
 
     try {
         LOG(TRACE) << "Fetching electric field from mesh file";
 
         // Get field from file
         auto field_data =
-            field_parser_.getByFileName(config_.getPath("file_name", true), config_.get<std::string>("file_units"));
+            field_parser.getByFileName(config_.getPath("file_name", true), config_.get<std::string>("file_units"));
 
         // Warn at field values larger than 1MV/cm / 10 MV/mm. Simple lookup per vector component, not total field magnitude
         auto max_field = *std::max_element(std::begin(*field_data.getData()), std::end(*field_data.getData()));
@@ -292,6 +321,7 @@ FieldData<double> ElectricFieldReaderModule::read_field() {
 
         LOG(INFO) << "Set electric field with " << field_data.getDimensions().at(0) << "x"
                   << field_data.getDimensions().at(1) << "x" << field_data.getDimensions().at(2) << " cells";
+        LOG(DEBUG) << "Electric field occupies " << field_data.getData()->size() * sizeof(T) / 1024 << " kB of memory";
 
         // Return the field data
         return field_data;
@@ -82,10 +82,12 @@ namespace allpix {
 
         /**
          * @brief Read field from a file in init or apf format
+         * @param field_parser Parser reading the field in the precision it is stored in
          * @return Data of the field read from file
          */
-        FieldData<double> read_field();
+        template <typename T> FieldData<T> read_field(FieldParser<T>& field_parser);
         static FieldParser<double> field_parser_;
+        static FieldParser<float> float_field_parser_;
 
         /**
          * @brief Create output plots of the electric field profile
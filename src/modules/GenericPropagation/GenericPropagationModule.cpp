@@ -12,13 +12,17 @@
 
 #include "GenericPropagationModule.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <limits>
 #include <map>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <Eigen/Core>
 
@@ -35,6 +39,7 @@
 
 #include "objects/DepositedCharge.hpp"
 #include "objects/PropagatedCharge.hpp"
+#include "objects/PropagatedChargeArray.hpp"
 
 using namespace allpix;
 
@@ -100,6 +105,18 @@ GenericPropagationModule::GenericPropagationModule(Configuration& config,
     config_.setDefault<double>("multiplication_threshold", 1e-2);
     config_.setDefault<unsigned int>("max_multiplication_level", 5);
 
+    // Dispatch propagated charges as objects by default
+    config_.setDefault<bool>("compact_output", false);
+
+    // Propagate one set of charge carriers after the other by default
+    config_.setDefault<Engine>("engine", Engine::SCALAR);
+    config_.setDefault<size_t>("batch_size", 64);
+    config_.setDefault<Integrator>("integrator", Integrator::RUNGE_KUTTA_FEHLBERG);
+    config_.setDefault<ROOT::Math::DisplacementVector3D<ROOT::Math::Cartesian3D<int>>>("drift_table_bins", {10, 10, 50});
+
+    // Use the specialized geometry for rectangular pixels where available
+    config_.setDefault<bool>("specialized_geometry", true);
+
     // Copy some variables from configuration to avoid lookups:
     temperature_ = config_.get<double>("temperature");
     timestep_min_ = config_.get<double>("timestep_min");
@@ -119,6 +136,11 @@ GenericPropagationModule::GenericPropagationModule(Configuration& config,
     charge_per_step_ = config_.get<unsigned int>("charge_per_step");
     max_charge_groups_ = config_.get<unsigned int>("max_charge_groups");
     max_multiplication_level_ = config.get<unsigned int>("max_multiplication_level");
+    compact_output_ = config_.get<bool>("compact_output");
+    engine_ = config_.get<Engine>("engine");
+    batch_size_ = config_.get<size_t>("batch_size");
+    integrator_ = config_.get<Integrator>("integrator");
+    drift_table_bins_ = config_.get<ROOT::Math::DisplacementVector3D<ROOT::Math::Cartesian3D<int>>>("drift_table_bins");
     output_max_gain_histo_ = config.get<unsigned int>("output_max_gain_histo");
 
     // Avoids wrong gain histogram inputs
@@ -126,6 +148,22 @@ GenericPropagationModule::GenericPropagationModule(Configuration& config,
         throw InvalidValueError(config, "output_max_gain_histo", "value must be >= 2");
     }
 
+    if(engine_ == Engine::BATCHED && batch_size_ == 0) {
+        throw InvalidValueError(config_, "batch_size", "batch size needs to be at least one");
+    }
+    if(engine_ == Engine::TABULATED &&
+       (drift_table_bins_.x() < 1 || drift_table_bins_.y() < 1 || drift_table_bins_.z() < 1)) {
+        throw InvalidValueError(config_, "drift_table_bins", "number of bins needs to be at least one in every dimension");
+    }
+    if(engine_ != Engine::SCALAR) {
+        if(output_linegraphs_ || output_animations_) {
+            throw InvalidValueError(config_, "engine", "line graphs and animations are only available for scalar engine");
+        }
+        if(integrator_ != Integrator::RUNGE_KUTTA_FEHLBERG) {
+            throw InvalidValueError(config_, "integrator", "Dormand-Prince integrator is only available for scalar engine");
+        }
+    }
+
     // Enable multithreading of this module if multithreading is enabled and no per-event output plots are requested:
     // FIXME: Review if this is really the case or we can still use multithreading
     if(!(output_animations_ || output_linegraphs_)) {
@@ -318,12 +356,24 @@ void GenericPropagationModule::initialize() {
     // Impact ionization model
     multiplication_ = ImpactIonization(config_);
 
+    // Bind the non-virtual geometry kernel if available for this detector model and not disabled
+    if(config_.get<bool>("specialized_geometry")) {
+        geometry_ = RectangularPixelGeometry::create(*model_);
+    }
+    LOG(DEBUG) << "Using " << (geometry_.has_value() ? "specialized rectangular pixel" : "generic detector model")
+               << " geometry for propagation";
+
     // Check multiplication and step size larger than a picosecond:
     if(!multiplication_.is<NoImpactIonization>() && timestep_max_ > 0.001) {
         LOG(WARNING) << "Charge multiplication enabled with maximum timestep larger than 1ps" << std::endl
                      << "This might lead to unphysical gain values.";
     }
 
+    // Secondary charge carriers are only propagated by the scalar engine
+    if(engine_ != Engine::SCALAR && !multiplication_.is<NoImpactIonization>()) {
+        throw InvalidValueError(config_, "engine", "impact ionization is only available for scalar engine");
+    }
+
     // Check for propagating both types of charge carrier
     if(!multiplication_.is<NoImpactIonization>() && (!propagate_electrons_ || !propagate_holes_)) {
         LOG(WARNING) << "Not propagating both types of charge carriers with charge multiplication enabled may lead to "
@@ -335,13 +385,61 @@ void GenericPropagationModule::initialize() {
 
     // Prepare trapping model
     detrapping_ = Detrapping(config_);
+
+    // Tabulate the drift paths within a pixel cell for the propagated carrier types
+    if(engine_ == Engine::TABULATED) {
+        if(!config_.get<bool>("specialized_geometry")) {
+            throw InvalidCombinationError(
+                config_, {"engine", "specialized_geometry"}, "tabulated engine requires the specialized geometry");
+        }
+        if(!geometry_.has_value()) {
+            throw InvalidValueError(config_, "engine", "tabulated engine requires a rectangular pixel detector model");
+        }
+        if(!detector_->hasElectricField()) {
+            throw InvalidValueError(config_, "engine", "tabulated engine requires an electric field");
+        }
+        if(has_magnetic_field_) {
+            throw InvalidValueError(config_, "engine", "tabulated engine is not available with magnetic field");
+        }
+
+        // The drift paths are tabulated for a single pixel cell, the fields have to be replicated for every pixel
+        auto mapped_to_sensor = [](FieldType field_type, FieldMapping mapping) {
+            return (field_type == FieldType::GRID || field_type == FieldType::CUSTOM) && mapping == FieldMapping::SENSOR;
+        };
+        if(mapped_to_sensor(detector_->getElectricFieldType(), detector_->getElectricFieldMapping())) {
+            throw InvalidValueError(
+                config_, "engine", "tabulated engine requires an electric field mapped to every pixel, not to the sensor");
+        }
+        if(detector_->hasDopingProfile() &&
+           mapped_to_sensor(detector_->getDopingProfileType(), detector_->getDopingProfileMapping())) {
+            throw InvalidValueError(
+                config_, "engine", "tabulated engine requires a doping profile mapped to every pixel, not to the sensor");
+        }
+
+        drift_table_origin_ = ROOT::Math::XYZVector(-model_->getPixelSize().x() / 2,
+                                                    -model_->getPixelSize().y() / 2,
+                                                    model_->getSensorCenter().z() - model_->getSensorSize().z() / 2);
+        drift_table_bin_size_ = ROOT::Math::XYZVector(model_->getPixelSize().x() / drift_table_bins_.x(),
+                                                      model_->getPixelSize().y() / drift_table_bins_.y(),
+                                                      model_->getSensorSize().z() / drift_table_bins_.z());
+        if(propagate_electrons_) {
+            drift_tables_[0] = build_drift_table(CarrierType::ELECTRON);
+        }
+        if(propagate_holes_) {
+            drift_tables_[1] = build_drift_table(CarrierType::HOLE);
+        }
+        LOG(INFO) << "Tabulated drift paths on grid of " << drift_table_bins_.x() << "x" << drift_table_bins_.y() << "x"
+                  << drift_table_bins_.z() << " points within the pixel cell";
+    }
 }
 
 void GenericPropagationModule::run(Event* event) {
     auto deposits_message = messenger_->fetchMessage<DepositedChargeMessage>(this, event);
 
-    // Create vector of propagated charges to output
-    std::vector<PropagatedCharge> propagated_charges;
+    // Create output of propagated charges, stored as objects unless compact output is requested
+    const auto& deposits = deposits_message->getData();
+    PropagatedChargeOutput propagated_charges;
+    propagated_charges.compact = compact_output_;
 
     // List of points to plot to plot for output plots
     LineGraph::OutputPlotPoints output_plot_points;
@@ -352,8 +450,11 @@ void GenericPropagationModule::run(Event* event) {
     unsigned int recombined_charges_count = 0;
     unsigned int trapped_charges_count = 0;
     unsigned int step_count = 0;
+    unsigned int integration_step_count = 0;
+    unsigned int field_lookup_count = 0;
     long double total_time = 0;
-    for(const auto& deposit : deposits_message->getData()) {
+    std::vector<CarrierGroup> groups;
+    for(const auto& deposit : deposits) {
 
         if((deposit.getType() == CarrierType::ELECTRON && !propagate_electrons_) ||
            (deposit.getType() == CarrierType::HOLE && !propagate_holes_)) {
@@ -371,6 +472,7 @@ void GenericPropagationModule::run(Event* event) {
         }
 
         total_deposits_++;
+        auto deposit_index = static_cast<uint32_t>(&deposit - deposits.data());
 
         // Loop over all charges in the deposit
         unsigned int charges_remaining = deposit.getCharge();
@@ -393,29 +495,67 @@ void GenericPropagationModule::run(Event* event) {
             }
             charges_remaining -= charge_per_step;
 
+            // Queue the set of charges if all sets are propagated together
+            if(engine_ == Engine::BATCHED) {
+                groups.push_back({&deposit, deposit_index, charge_per_step});
+                continue;
+            }
+
             // Propagate a single charge deposit
-            auto [recombined, trapped, propagated, steps, time] = propagate(event,
-                                                                            deposit,
-                                                                            deposit.getLocalPosition(),
-                                                                            deposit.getType(),
-                                                                            charge_per_step,
-                                                                            deposit.getLocalTime(),
-                                                                            deposit.getGlobalTime(),
-                                                                            0,
-                                                                            propagated_charges,
-                                                                            output_plot_points);
+            auto propagate_deposit = [&](const auto& geometry) {
+                auto propagate_with = [&](const auto& rk_tableau) {
+                    return propagate(geometry,
+                                     rk_tableau,
+                                     event,
+                                     deposit,
+                                     deposit_index,
+                                     deposit.getLocalPosition(),
+                                     deposit.getType(),
+                                     charge_per_step,
+                                     deposit.getLocalTime(),
+                                     deposit.getGlobalTime(),
+                                     0,
+                                     propagated_charges,
+                                     output_plot_points);
+                };
+                return (integrator_ == Integrator::DORMAND_PRINCE ? propagate_with(tableau::DP5)
+                                                                  : propagate_with(tableau::RK5));
+            };
+            auto [recombined, trapped, propagated, steps, time, integration_steps, field_lookups] =
+                (engine_ == Engine::TABULATED
+                     ? propagate_tabulated(event, deposit, deposit_index, charge_per_step, propagated_charges)
+                     : (geometry_.has_value() ? propagate_deposit(geometry_.value()) : propagate_deposit(*model_)));
 
             // Update statistical information
             recombined_charges_count += recombined;
             trapped_charges_count += trapped;
             propagated_charges_count += propagated;
             step_count += steps;
+            integration_step_count += integration_steps;
+            field_lookup_count += field_lookups;
             total_time += time;
             LOG(DEBUG) << "Propagated charges: " << propagated << ", recombined charges: " << recombined
                        << ", trapped charges : " << trapped;
         }
     }
 
+    // Propagate all queued sets of charges
+    if(!groups.empty()) {
+        auto propagate_groups = [&](const auto& geometry) {
+            return propagate_batched(geometry, event, groups, propagated_charges);
+        };
+        auto [recombined, trapped, propagated, steps, time, integration_steps, field_lookups] =
+            (geometry_.has_value() ? propagate_groups(geometry_.value()) : propagate_groups(*model_));
+
+        recombined_charges_count += recombined;
+        trapped_charges_count += trapped;
+        propagated_charges_count += propagated;
+        step_count += steps;
+        integration_step_count += integration_steps;
+        field_lookup_count += field_lookups;
+        total_time += time;
+    }
+
     // Output plots if required
     if(output_linegraphs_) {
         LineGraph::Create(event->number, this, config_, output_plot_points, CarrierState::UNKNOWN);
@@ -441,6 +581,8 @@ void GenericPropagationModule::run(Event* event) {
               << "Trapped " << trapped_charges_count << " charges during transport";
     total_propagated_charges_ += propagated_charges_count;
     total_steps_ += step_count;
+    total_integration_steps_ += integration_step_count;
+    total_field_lookups_ += field_lookup_count;
     total_time_picoseconds_ += static_cast<long unsigned int>(total_time * 1e3);
 
     if(output_plots_) {
@@ -449,11 +591,134 @@ void GenericPropagationModule::run(Event* event) {
         trapped_histo_->Fill(static_cast<double>(trapped_charges_count) / (total == 0 ? 1 : total));
     }
 
-    // Create a new message with propagated charges
-    auto propagated_charge_message = std::make_shared<PropagatedChargeMessage>(std::move(propagated_charges), detector_);
+    // Create a new message with propagated charges, only creating the objects on request for compact output
+    if(compact_output_) {
+        auto propagated_charge_message = event->makeShared<PropagatedChargeArrayMessage>(
+            std::move(propagated_charges.array), deposits_message, detector_);
+        messenger_->dispatchMessage(this, std::move(propagated_charge_message), event);
+    } else {
+        auto propagated_charge_message =
+            event->makeShared<PropagatedChargeMessage>(std::move(propagated_charges.objects), detector_);
+        messenger_->dispatchMessage(this, std::move(propagated_charge_message), event);
+    }
+}
+
+void GenericPropagationModule::PropagatedChargeOutput::add(const ROOT::Math::XYZPoint& local_position,
+                                                           const ROOT::Math::XYZPoint& global_position,
+                                                           CarrierType type,
+                                                           unsigned int charge,
+                                                           double local_time,
+                                                           double global_time,
+                                                           CarrierState state,
+                                                           const DepositedCharge& deposit,
+                                                           uint32_t deposit_index) {
+    if(compact) {
+        array.push_back(local_position, global_position, type, charge, local_time, global_time, state, deposit_index);
+    } else {
+        objects.emplace_back(local_position, global_position, type, charge, local_time, global_time, state, &deposit);
+    }
+}
+
+Eigen::Vector3d GenericPropagationModule::drift_velocity(CarrierType type, const FieldSample& fields) const {
+    Eigen::Vector3d efield(fields.electric_field.x(), fields.electric_field.y(), fields.electric_field.z());
+
+    auto mob = mobility_(type, efield.norm(), fields.doping_concentration);
+    if(!has_magnetic_field_) {
+        return static_cast<int>(type) * mob * efield;
+    }
+
+    Eigen::Vector3d bfield(fields.magnetic_field.x(), fields.magnetic_field.y(), fields.magnetic_field.z());
+    auto exb = efield.cross(bfield);
+
+    Eigen::Vector3d term1;
+    double hallFactor = (type == CarrierType::ELECTRON ? electron_Hall_ : hole_Hall_);
+    term1 = static_cast<int>(type) * mob * hallFactor * exb;
+
+    Eigen::Vector3d term2 = mob * mob * hallFactor * hallFactor * efield.dot(bfield) * bfield;
+
+    auto rnorm = 1 + mob * mob * hallFactor * hallFactor * bfield.dot(bfield);
+    return static_cast<int>(type) * mob * (efield + term1 + term2) / rnorm;
+}
+
+Eigen::Vector3d GenericPropagationModule::carrier_diffusion(
+    Event* event, CarrierType type, double efield_mag, double doping_concentration, double timestep) const {
+    double diffusion_constant = boltzmann_kT_ * mobility_(type, efield_mag, doping_concentration);
+    double diffusion_std_dev = std::sqrt(2. * diffusion_constant * timestep);
+
+    // Compute the independent diffusion in three
+    std::array<double, 3> diffusion{};
+    event->getRandomEngine().fillNormal(diffusion.data(), diffusion.size(), 0., diffusion_std_dev);
+    return {diffusion[0], diffusion[1], diffusion[2]};
+}
+
+std::pair<CarrierState, double> GenericPropagationModule::carrier_lifetime(Event* event,
+                                                                           CarrierType type,
+                                                                           unsigned int charge,
+                                                                           double doping_concentration,
+                                                                           double efield_mag,
+                                                                           double timestep,
+                                                                           double initial_time,
+                                                                           double time) const {
+    // Survival or detrap probability of the charge carrier package
+    allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
+
+    // Check if charge carrier is still alive:
+    if(recombination_(type, doping_concentration, uniform_distribution(event->getRandomEngine()), timestep)) {
+        return {CarrierState::RECOMBINED, 0.};
+    }
+
+    // Check if the charge carrier has been trapped:
+    if(!trapping_(type, uniform_distribution(event->getRandomEngine()), timestep, efield_mag)) {
+        return {CarrierState::MOTION, 0.};
+    }
+    LOG(TRACE) << "Trapping charge " << charge << " at time " << Units::display(time, {"ps", "ns", "us"});
+    if(output_plots_) {
+        trapping_time_histo_->Fill(static_cast<double>(Units::convert(time, "ns")), charge);
+    }
+
+    auto detrap_time = detrapping_(type, uniform_distribution(event->getRandomEngine()), efield_mag);
+    if((initial_time + time + detrap_time) < integration_time_) {
+        LOG(DEBUG) << "De-trapping charge carrier after " << Units::display(detrap_time, {"ns", "us"});
+        if(output_plots_) {
+            detrapping_time_histo_->Fill(static_cast<double>(Units::convert(detrap_time, "ns")), charge);
+        }
+        // De-trap and advance in time if still below integration time
+        return {CarrierState::MOTION, detrap_time};
+    }
 
-    // Dispatch the message with propagated charges
-    messenger_->dispatchMessage(this, std::move(propagated_charge_message), event);
+    // Mark as trapped otherwise
+    return {CarrierState::TRAPPED, 0.};
+}
+
+/**
+ * The step size controller of integrators with step rejection owns the time step. When reaching the sensor edge, its time
+ * step is limited such that the next step covers at most half of the remaining distance, while the time step of the other
+ * integrators is lowered by a fixed factor.
+ */
+double GenericPropagationModule::adapt_timestep(double timestep,
+                                                double uncertainty,
+                                                double edge_distance,
+                                                double step_z,
+                                                std::optional<double> controlled_timestep) const {
+    auto reaching_edge = (std::fabs(edge_distance) < 2 * step_z);
+    if(controlled_timestep.has_value()) {
+        timestep = (reaching_edge ? std::min(controlled_timestep.value(), timestep * std::fabs(edge_distance) / (2 * step_z))
+                                  : controlled_timestep.value());
+    } else if(reaching_edge) {
+        timestep *= 0.75;
+    } else if(uncertainty > target_spatial_precision_) {
+        timestep *= 0.75;
+    } else if(2 * uncertainty < target_spatial_precision_) {
+        timestep *= 1.5;
+    }
+
+    // Limit the timestep to certain minimum and maximum step sizes
+    if(timestep > timestep_max_) {
+        timestep = timestep_max_;
+    } else if(timestep < timestep_min_) {
+        timestep = timestep_min_;
+    }
+    return timestep;
 }
 
 /**
@@ -461,16 +726,20 @@ void GenericPropagationModule::run(Event* event) {
  * velocity at every point with help of the electric field map of the detector. A Runge-Kutta integration is applied in
  * multiple steps, adding a random diffusion to the propagating charge every step.
  */
-std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double>
-GenericPropagationModule::propagate(Event* event,
+template <typename Geometry, size_t S>
+std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double, unsigned int, unsigned int>
+GenericPropagationModule::propagate(const Geometry& geometry,
+                                    const ButcherTableau<double, S>& rk_tableau,
+                                    Event* event,
                                     const DepositedCharge& deposit,
+                                    const uint32_t deposit_index,
                                     const ROOT::Math::XYZPoint& pos,
                                     const CarrierType& type,
                                     unsigned int charge,
                                     const double initial_time_local,
                                     const double initial_time_global,
                                     const unsigned int level,
-                                    std::vector<PropagatedCharge>& propagated_charges,
+                                    PropagatedChargeOutput& propagated_charges,
                                     LineGraph::OutputPlotPoints& output_plot_points) const {
 
     if(level > max_multiplication_level_) {
@@ -486,6 +755,8 @@ GenericPropagationModule::propagate(Event* event,
     unsigned int recombined_charges_count = 0;
     unsigned int trapped_charges_count = 0;
     unsigned int steps = 0;
+    unsigned int integration_steps = 0;
+    unsigned int field_lookups = 0;
     long double total_time = 0;
 
     // Add point of deposition to the output plots if requested
@@ -498,65 +769,33 @@ GenericPropagationModule::propagate(Event* event,
     // Store initial charge
     const unsigned int initial_charge = charge;
 
-    // Define a function to compute the diffusion
-    auto carrier_diffusion = [&](double efield_mag, double doping_concentration, double timestep) -> Eigen::Vector3d {
-        double diffusion_constant = boltzmann_kT_ * mobility_(type, efield_mag, doping_concentration);
-        double diffusion_std_dev = std::sqrt(2. * diffusion_constant * timestep);
-
-        // Compute the independent diffusion in three
-        allpix::normal_distribution<double> gauss_distribution(0, diffusion_std_dev);
-        auto x = gauss_distribution(event->getRandomEngine());
-        auto y = gauss_distribution(event->getRandomEngine());
-        auto z = gauss_distribution(event->getRandomEngine());
-        return {x, y, z};
-    };
-
-    // Survival or detrap probability of this charge carrier package, evaluated at every step
+    // Probability of secondary charge carriers from impact ionization, evaluated at every step
     allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
 
-    // Define lambda functions to compute the charge carrier velocity with or without magnetic field
-    std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_noB =
-        [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-
-        return static_cast<int>(type) * mobility_(type, efield.norm(), doping) * efield;
+    // Define a function to compute the charge carrier velocity with or without magnetic field
+    auto carrier_velocity = [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
+        ++field_lookups;
+        return drift_velocity(type, detector_->getFieldSample(static_cast<ROOT::Math::XYZPoint>(cur_pos)));
     };
 
-    std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_withB =
-        [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
-
-        auto magnetic_field = detector_->getMagneticField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-        Eigen::Vector3d bfield(magnetic_field.x(), magnetic_field.y(), magnetic_field.z());
-
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-
-        auto mob = mobility_(type, efield.norm(), doping);
-        auto exb = efield.cross(bfield);
-
-        Eigen::Vector3d term1;
-        double hallFactor = (type == CarrierType::ELECTRON ? electron_Hall_ : hole_Hall_);
-        term1 = static_cast<int>(type) * mob * hallFactor * exb;
-
-        Eigen::Vector3d term2 = mob * mob * hallFactor * hallFactor * efield.dot(bfield) * bfield;
+    // Create the Runge-Kutta solver with the selected tableau
+    auto runge_kutta = make_runge_kutta(rk_tableau, carrier_velocity, timestep_start_, position);
 
-        auto rnorm = 1 + mob * mob * hallFactor * hallFactor * bfield.dot(bfield);
-        return static_cast<int>(type) * mob * (efield + term1 + term2) / rnorm;
-    };
-
-    // Create the Runge-Kutta solver with an RKF5 tableau, using different velocity calculators depending on the magnetic
-    // field
-    auto runge_kutta = make_runge_kutta(
-        tableau::RK5, (has_magnetic_field_ ? carrier_velocity_withB : carrier_velocity_noB), timestep_start_, position);
+    // Control the step size from the embedded error estimate if steps can be rejected
+    std::optional<StepSizeController<double>> step_controller;
+    if(integrator_ == Integrator::DORMAND_PRINCE) {
+        step_controller.emplace(target_spatial_precision_, timestep_min_, timestep_max_, 5);
+    }
 
     // Continue propagation until the deposit is outside the sensor
     Eigen::Vector3d last_position = position;
     ROOT::Math::XYZVector efield{}, last_efield{};
+    // Fields at the current position, carried over from the end of the previous step
+    auto fields = detector_->getFieldSample(static_cast<ROOT::Math::XYZPoint>(position));
+    ++field_lookups;
     // Initialize last_efield for first pass through the while loop
-    last_efield = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(last_position));
+    last_efield = fields.electric_field;
+    runge_kutta.setValue(position, drift_velocity(type, fields));
     double last_time = 0;
     size_t next_idx = 0;
     auto state = CarrierState::MOTION;
@@ -575,11 +814,23 @@ GenericPropagationModule::propagate(Event* event,
         last_time = runge_kutta.getTime();
 
         // Get electric field at current (pre-step) position
-        efield = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(position));
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position));
+        efield = fields.electric_field;
+        auto doping = fields.doping_concentration;
 
         // Execute a Runge-Kutta step
         auto step = runge_kutta.step();
+        ++integration_steps;
+
+        // Repeat the step with a smaller timestep as long as the error exceeds the target precision
+        auto controlled_timestep = runge_kutta.getTimeStep();
+        if(step_controller.has_value()) {
+            while(!step_controller->adapt(step.error.norm(), controlled_timestep)) {
+                runge_kutta.rejectStep(step);
+                runge_kutta.setTimeStep(controlled_timestep);
+                step = runge_kutta.step();
+                ++integration_steps;
+            }
+        }
 
         // Get the current result and timestep
         auto timestep = runge_kutta.getTimeStep();
@@ -588,49 +839,32 @@ GenericPropagationModule::propagate(Event* event,
                    << Units::display(static_cast<ROOT::Math::XYZPoint>(position), {"um"});
 
         // Apply diffusion step
-        auto diffusion = carrier_diffusion(std::sqrt(efield.Mag2()), doping, timestep);
+        auto diffusion = carrier_diffusion(event, type, std::sqrt(efield.Mag2()), doping, timestep);
         position += diffusion;
-        runge_kutta.setValue(position);
+
+        // Get the fields at the new position, used for the physics effects of this step and as pre-step fields of the next
+        fields = detector_->getFieldSample(static_cast<ROOT::Math::XYZPoint>(position));
+        ++field_lookups;
+        runge_kutta.setValue(position, drift_velocity(type, fields));
 
         // Check if we are still in the sensor and not in an implant:
-        if(!model_->isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position)) ||
-           model_->isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position))) {
+        if(!geometry.isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position)) ||
+           geometry.isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position))) {
             state = CarrierState::HALTED;
         }
 
-        // Physics effects:
-
-        // Check if charge carrier is still alive:
-        if(state == CarrierState::MOTION &&
-           recombination_(type,
-                          detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position)),
-                          uniform_distribution(event->getRandomEngine()),
-                          timestep)) {
-            state = CarrierState::RECOMBINED;
-        }
-
-        // Check if the charge carrier has been trapped:
-        if(state == CarrierState::MOTION &&
-           trapping_(type, uniform_distribution(event->getRandomEngine()), timestep, std::sqrt(efield.Mag2()))) {
-            LOG(TRACE) << "Trapping charge " << charge << " at " << position.x() << "," << position.y() << ","
-                       << position.z() << " and time " << runge_kutta.getTime();
-            if(output_plots_) {
-                trapping_time_histo_->Fill(static_cast<double>(Units::convert(runge_kutta.getTime(), "ns")), charge);
-            }
-
-            auto detrap_time = detrapping_(type, uniform_distribution(event->getRandomEngine()), std::sqrt(efield.Mag2()));
-            if((initial_time_local + runge_kutta.getTime() + detrap_time) < integration_time_) {
-                LOG(DEBUG) << "De-trapping charge carrier after " << Units::display(detrap_time, {"ns", "us"});
-                // De-trap and advance in time if still below integration time
-                runge_kutta.advanceTime(detrap_time);
-
-                if(output_plots_) {
-                    detrapping_time_histo_->Fill(static_cast<double>(Units::convert(detrap_time, "ns")), charge);
-                }
-            } else {
-                // Mark as trapped otherwise
-                state = CarrierState::TRAPPED;
-            }
+        // Physics effects: recombination, trapping and detrapping of the charge carrier
+        if(state == CarrierState::MOTION) {
+            auto [lifetime_state, detrap_time] = carrier_lifetime(event,
+                                                                  type,
+                                                                  charge,
+                                                                  fields.doping_concentration,
+                                                                  std::sqrt(efield.Mag2()),
+                                                                  timestep,
+                                                                  initial_time_local,
+                                                                  runge_kutta.getTime());
+            state = lifetime_state;
+            runge_kutta.advanceTime(detrap_time);
         }
 
         LOG(TRACE) << "Step from " << Units::display(static_cast<ROOT::Math::XYZPoint>(last_position), {"um", "mm"})
@@ -677,9 +911,12 @@ GenericPropagationModule::propagate(Event* event,
                     multiplication_depth_histo_->Fill(carrier_pos.z(), n_secondaries);
                 }
 
-                auto [recombined, trapped, propagated, psteps, ptime] =
-                    propagate(event,
+                auto [recombined, trapped, propagated, psteps, ptime, pintegration_steps, pfield_lookups] =
+                    propagate(geometry,
+                              rk_tableau,
+                              event,
                               deposit,
+                              deposit_index,
                               carrier_pos,
                               inverted_type,
                               n_secondaries,
@@ -694,6 +931,8 @@ GenericPropagationModule::propagate(Event* event,
                 trapped_charges_count += trapped;
                 propagated_charges_count += propagated;
                 steps += psteps;
+                integration_steps += pintegration_steps;
+                field_lookups += pfield_lookups;
                 total_time += ptime * charge;
 
                 LOG(DEBUG) << "Continuing propagation of charge carrier set (" << type << ") at "
@@ -714,26 +953,13 @@ GenericPropagationModule::propagate(Event* event,
             uncertainty_histo_->Fill(static_cast<double>(Units::convert(step.error.norm(), "nm")));
         }
 
-        // Adapt step size to match target precision
-        double uncertainty = step.error.norm();
-
-        // Lower timestep when reaching the sensor edge
-        if(std::fabs(model_->getSensorSize().z() / 2.0 - position.z()) < 2 * step.value.z()) {
-            timestep *= 0.75;
-        } else {
-            if(uncertainty > target_spatial_precision_) {
-                timestep *= 0.75;
-            } else if(2 * uncertainty < target_spatial_precision_) {
-                timestep *= 1.5;
-            }
-        }
-        // Limit the timestep to certain minimum and maximum step sizes
-        if(timestep > timestep_max_) {
-            timestep = timestep_max_;
-        } else if(timestep < timestep_min_) {
-            timestep = timestep_min_;
-        }
-        runge_kutta.setTimeStep(timestep);
+        // Adapt step size to match target precision, or use the step size of the controller if available
+        runge_kutta.setTimeStep(
+            adapt_timestep(timestep,
+                           step.error.norm(),
+                           geometry.getSensorSize().z() / 2.0 - position.z(),
+                           step.value.z(),
+                           step_controller.has_value() ? std::optional<double>(controlled_timestep) : std::nullopt));
 
         charge += n_secondaries;
 
@@ -743,7 +969,7 @@ GenericPropagationModule::propagate(Event* event,
 
     // Find proper final position in the sensor
     auto time = runge_kutta.getTime();
-    if(state == CarrierState::HALTED && !model_->isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position))) {
+    if(state == CarrierState::HALTED && !geometry.isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position))) {
         auto intercept = model_->getSensorIntercept(static_cast<ROOT::Math::XYZPoint>(last_position),
                                                     static_cast<ROOT::Math::XYZPoint>(position));
         position = Eigen::Vector3d(intercept.x(), intercept.y(), intercept.z());
@@ -752,8 +978,8 @@ GenericPropagationModule::propagate(Event* event,
     // Set final state of charge carrier for plotting:
     if(output_linegraphs_) {
         // If drift time is larger than integration time or the charge carriers have been collected at the backside, reset:
-        if(!model_->isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position)) &&
-           (time >= integration_time_ || last_position.z() < -model_->getSensorSize().z() * 0.45)) {
+        if(!geometry.isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position)) &&
+           (time >= integration_time_ || last_position.z() < -geometry.getSensorSize().z() * 0.45)) {
             std::get<3>(output_plot_points.at(output_plot_index).first) = CarrierState::UNKNOWN;
         } else {
             std::get<3>(output_plot_points.at(output_plot_index).first) = state;
@@ -812,18 +1038,17 @@ GenericPropagationModule::propagate(Event* event,
     LOG(DEBUG) << " Propagated " << charge << " to " << Units::display(local_position, {"mm", "um"}) << " in "
                << Units::display(time, "ns") << " time, gain " << gain << ", final state: " << allpix::to_string(state);
 
-    // Create a new propagated charge and add it to the list
+    // Add the propagated set of charges to the list
     auto global_position = detector_->getGlobalPosition(local_position);
-    PropagatedCharge propagated_charge(local_position,
-                                       global_position,
-                                       deposit.getType(),
-                                       charge,
-                                       deposit.getLocalTime() + time,
-                                       deposit.getGlobalTime() + time,
-                                       state,
-                                       &deposit);
-
-    propagated_charges.push_back(std::move(propagated_charge));
+    propagated_charges.add(local_position,
+                           global_position,
+                           deposit.getType(),
+                           charge,
+                           deposit.getLocalTime() + time,
+                           deposit.getGlobalTime() + time,
+                           state,
+                           deposit,
+                           deposit_index);
 
     if(output_plots_) {
         drift_time_histo_->Fill(static_cast<double>(Units::convert(time, "ns")), charge);
@@ -831,7 +1056,561 @@ GenericPropagationModule::propagate(Event* event,
     }
 
     // Return statistics counters about this and all daughter propagated charge carrier groups and their final states
-    return std::make_tuple(recombined_charges_count, trapped_charges_count, propagated_charges_count, steps, total_time);
+    return std::make_tuple(recombined_charges_count,
+                           trapped_charges_count,
+                           propagated_charges_count,
+                           steps,
+                           total_time,
+                           integration_steps,
+                           field_lookups);
+}
+
+/**
+ * The batched engine performs the same drift-diffusion steps as the scalar engine, but advances all lanes of the batch
+ * through every stage of the Runge-Kutta-Fehlberg method before moving on to the next stage. Stage positions and step
+ * results are computed in loops over contiguous arrays of the lanes in motion, while fields and mobility are evaluated per
+ * lane since they are looked up through the detector and the configured models. As for the scalar engine, the first stage
+ * of a step reuses the fields looked up at the position after diffusion. Once no queued set of charges is left to refill a
+ * lane, the last lane in motion takes its place.
+ */
+template <typename Geometry>
+std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double, unsigned int, unsigned int>
+GenericPropagationModule::propagate_batched(const Geometry& geometry,
+                                            Event* event,
+                                            const std::vector<CarrierGroup>& groups,
+                                            PropagatedChargeOutput& propagated_charges) const {
+    const auto& rk_tableau = tableau::RK5;
+    constexpr size_t stages = tableau::RK5.b.size();
+
+    unsigned int propagated_charges_count = 0;
+    unsigned int recombined_charges_count = 0;
+    unsigned int trapped_charges_count = 0;
+    unsigned int steps = 0;
+    unsigned int integration_steps = 0;
+    unsigned int field_lookups = 0;
+    long double total_time = 0;
+
+    // State of all lanes, every quantity stored as separate array indexed by the lane
+    const auto lanes = std::min(batch_size_, groups.size());
+    using LaneVector = std::vector<double>;
+    using LanePoint = std::array<LaneVector, 3>;
+    LanePoint position, last_position, stage_position, step_value, step_error;
+    std::array<LanePoint, stages> k;
+    for(auto* point : {&position, &last_position, &stage_position, &step_value, &step_error}) {
+        point->fill(LaneVector(lanes, 0.));
+    }
+    for(auto& point : k) {
+        point.fill(LaneVector(lanes, 0.));
+    }
+    LaneVector timestep(lanes), time(lanes), efield_mag(lanes), doping(lanes);
+    std::vector<CarrierState> state(lanes);
+    std::vector<size_t> lane_group(lanes);
+    LOG(DEBUG) << "Propagating " << groups.size() << " sets of charge carriers in " << lanes << " lanes";
+
+    // Final positions, times and states of all sets of charges
+    struct Result {
+        ROOT::Math::XYZPoint position;
+        double time;
+        CarrierState state;
+    };
+    std::vector<Result> results(groups.size());
+
+    // Store the result of the set of charges in a lane
+    auto finish_lane = [&](size_t lane) {
+        const auto& group = groups[lane_group[lane]];
+        auto local_position = ROOT::Math::XYZPoint(position[0][lane], position[1][lane], position[2][lane]);
+
+        // Find proper final position in the sensor
+        if(state[lane] == CarrierState::HALTED && !geometry.isWithinSensor(local_position)) {
+            local_position = model_->getSensorIntercept(
+                ROOT::Math::XYZPoint(last_position[0][lane], last_position[1][lane], last_position[2][lane]),
+                local_position);
+        }
+        results[lane_group[lane]] = {local_position, time[lane], state[lane]};
+
+        if(state[lane] == CarrierState::RECOMBINED) {
+            recombined_charges_count += group.charge;
+            if(output_plots_) {
+                recombination_time_histo_->Fill(static_cast<double>(Units::convert(time[lane], "ns")), group.charge);
+            }
+        } else if(state[lane] == CarrierState::TRAPPED) {
+            trapped_charges_count += group.charge;
+        }
+        propagated_charges_count += group.charge;
+        ++steps;
+        total_time += time[lane] * group.charge;
+
+        LOG(DEBUG) << " Propagated " << group.charge << " to " << Units::display(local_position, {"mm", "um"}) << " in "
+                   << Units::display(time[lane], "ns") << " time, final state: " << allpix::to_string(state[lane]);
+
+        if(output_plots_) {
+            drift_time_histo_->Fill(static_cast<double>(Units::convert(time[lane], "ns")), group.charge);
+            group_size_histo_->Fill(group.charge);
+        }
+    };
+
+    // Store the drift velocity at the start of the next step of a lane as its first stage
+    auto set_first_stage = [&](size_t lane, const Eigen::Vector3d& velocity) {
+        for(size_t axis = 0; axis < 3; ++axis) {
+            k[0][axis][lane] = velocity[static_cast<Eigen::Index>(axis)];
+        }
+    };
+
+    // Load the next queued set of charges into a lane, returns false if none is left
+    size_t next_group = 0;
+    auto refill_lane = [&](size_t lane) {
+        while(next_group < groups.size()) {
+            const auto& deposit = *groups[next_group].deposit;
+            auto pos = deposit.getLocalPosition();
+            position[0][lane] = pos.x();
+            position[1][lane] = pos.y();
+            position[2][lane] = pos.z();
+            timestep[lane] = timestep_start_;
+            time[lane] = 0;
+            state[lane] = CarrierState::MOTION;
+            lane_group[lane] = next_group++;
+
+            auto fields = detector_->getFieldSample(pos);
+            ++field_lookups;
+            efield_mag[lane] = std::sqrt(fields.electric_field.Mag2());
+            doping[lane] = fields.doping_concentration;
+            set_first_stage(lane, drift_velocity(deposit.getType(), fields));
+
+            if(deposit.getLocalTime() < integration_time_) {
+                return true;
+            }
+            finish_lane(lane);
+        }
+        return false;
+    };
+
+    // Move the set of charges of a lane to another one, including the results of its current step
+    auto move_lane = [&](size_t from, size_t to) {
+        for(size_t axis = 0; axis < 3; ++axis) {
+            position[axis][to] = position[axis][from];
+            k[0][axis][to] = k[0][axis][from];
+            step_value[axis][to] = step_value[axis][from];
+            step_error[axis][to] = step_error[axis][from];
+        }
+        timestep[to] = timestep[from];
+        time[to] = time[from];
+        efield_mag[to] = efield_mag[from];
+        doping[to] = doping[from];
+        state[to] = state[from];
+        lane_group[to] = lane_group[from];
+    };
+
+    // The lanes of sets of charges in motion are kept contiguous at the front of the batch
+    size_t active_lanes = 0;
+    while(active_lanes < lanes && refill_lane(active_lanes)) {
+        ++active_lanes;
+    }
+
+    while(active_lanes > 0) {
+        // Execute a Runge-Kutta step for all lanes, one stage after the other, the first stage is known from the fields at
+        // the start of the step
+        integration_steps += static_cast<unsigned int>(active_lanes);
+        for(size_t i = 1; i < stages; ++i) {
+            for(size_t axis = 0; axis < 3; ++axis) {
+                std::copy_n(position[axis].begin(), active_lanes, stage_position[axis].begin());
+                for(size_t j = 0; j < i; ++j) {
+                    const auto coefficient = rk_tableau.a[i][j];
+                    for(size_t lane = 0; lane < active_lanes; ++lane) {
+                        stage_position[axis][lane] += timestep[lane] * coefficient * k[j][axis][lane];
+                    }
+                }
+            }
+            field_lookups += static_cast<unsigned int>(active_lanes);
+            for(size_t lane = 0; lane < active_lanes; ++lane) {
+                auto fields = detector_->getFieldSample(
+                    ROOT::Math::XYZPoint(stage_position[0][lane], stage_position[1][lane], stage_position[2][lane]));
+                auto velocity = drift_velocity(groups[lane_group[lane]].deposit->getType(), fields);
+                for(size_t axis = 0; axis < 3; ++axis) {
+                    k[i][axis][lane] = velocity[static_cast<Eigen::Index>(axis)];
+                }
+            }
+        }
+
+        // Combine the stages to the step and its error estimate
+        for(size_t axis = 0; axis < 3; ++axis) {
+            std::fill_n(step_value[axis].begin(), active_lanes, 0.);
+            std::fill_n(step_error[axis].begin(), active_lanes, 0.);
+            for(size_t i = 0; i < stages; ++i) {
+                const auto weight = rk_tableau.b[i];
+                const auto error_weight = rk_tableau.b[i] - rk_tableau.b_error[i];
+                for(size_t lane = 0; lane < active_lanes; ++lane) {
+                    step_value[axis][lane] += timestep[lane] * weight * k[i][axis][lane];
+                    step_error[axis][lane] += timestep[lane] * error_weight * k[i][axis][lane];
+                }
+            }
+        }
+
+        // Apply diffusion and physics effects to every lane
+        for(size_t lane = 0; lane < active_lanes;) {
+            const auto& group = groups[lane_group[lane]];
+            const auto type = group.deposit->getType();
+
+            // Apply drift and diffusion step, using the fields at the pre-step position
+            auto diffusion = carrier_diffusion(event, type, efield_mag[lane], doping[lane], timestep[lane]);
+            for(size_t axis = 0; axis < 3; ++axis) {
+                last_position[axis][lane] = position[axis][lane];
+                position[axis][lane] += step_value[axis][lane] + diffusion[static_cast<Eigen::Index>(axis)];
+            }
+            time[lane] += timestep[lane];
+            auto local_position = ROOT::Math::XYZPoint(position[0][lane], position[1][lane], position[2][lane]);
+
+            // Get the fields at the new position, used for the physics effects of this step and as pre-step fields of
+            // the next
+            auto fields = detector_->getFieldSample(local_position);
+            ++field_lookups;
+            auto step_efield_mag = efield_mag[lane];
+            efield_mag[lane] = std::sqrt(fields.electric_field.Mag2());
+            doping[lane] = fields.doping_concentration;
+            set_first_stage(lane, drift_velocity(type, fields));
+
+            // Check if we are still in the sensor and not in an implant:
+            if(!geometry.isWithinSensor(local_position) || geometry.isWithinImplant(local_position)) {
+                state[lane] = CarrierState::HALTED;
+            }
+
+            // Physics effects: recombination, trapping and detrapping of the charge carrier
+            if(state[lane] == CarrierState::MOTION) {
+                auto [lifetime_state, detrap_time] = carrier_lifetime(event,
+                                                                      type,
+                                                                      group.charge,
+                                                                      fields.doping_concentration,
+                                                                      step_efield_mag,
+                                                                      timestep[lane],
+                                                                      group.deposit->getLocalTime(),
+                                                                      time[lane]);
+                state[lane] = lifetime_state;
+                time[lane] += detrap_time;
+            }
+
+            // Update step length histogram
+            auto uncertainty = std::sqrt(step_error[0][lane] * step_error[0][lane] +
+                                         step_error[1][lane] * step_error[1][lane] +
+                                         step_error[2][lane] * step_error[2][lane]);
+            if(output_plots_) {
+                auto step_length = std::sqrt(step_value[0][lane] * step_value[0][lane] +
+                                             step_value[1][lane] * step_value[1][lane] +
+                                             step_value[2][lane] * step_value[2][lane]);
+                step_length_histo_->Fill(static_cast<double>(Units::convert(step_length, "um")));
+                uncertainty_histo_->Fill(static_cast<double>(Units::convert(uncertainty, "nm")));
+            }
+
+            // Adapt step size to match target precision
+            timestep[lane] = adapt_timestep(
+                timestep[lane], uncertainty, geometry.getSensorSize().z() / 2.0 - position[2][lane], step_value[2][lane]);
+
+            // Replace the set of charges once it stopped moving, or fill its lane with the last one in motion
+            if(state[lane] != CarrierState::MOTION || (group.deposit->getLocalTime() + time[lane]) >= integration_time_) {
+                finish_lane(lane);
+                if(!refill_lane(lane)) {
+                    move_lane(--active_lanes, lane);
+                    continue;
+                }
+            }
+            ++lane;
+        }
+    }
+
+    // Add the propagated sets of charges to the list in the order of the groups
+    for(size_t n = 0; n < groups.size(); ++n) {
+        const auto& deposit = *groups[n].deposit;
+        const auto& result = results[n];
+        propagated_charges.add(result.position,
+                               detector_->getGlobalPosition(result.position),
+                               deposit.getType(),
+                               groups[n].charge,
+                               deposit.getLocalTime() + result.time,
+                               deposit.getGlobalTime() + result.time,
+                               result.state,
+                               deposit,
+                               groups[n].deposit_index);
+    }
+
+    // Return statistics counters about all propagated charge carrier groups and their final states
+    return std::make_tuple(recombined_charges_count,
+                           trapped_charges_count,
+                           propagated_charges_count,
+                           steps,
+                           total_time,
+                           integration_steps,
+                           field_lookups);
+}
+
+/**
+ * The drift paths are integrated without diffusion from the centers of the bins of a grid spanning one pixel cell and the
+ * full sensor thickness, using the same Runge-Kutta-Fehlberg steps as the scalar engine. The cell of a pixel in the center
+ * of the matrix is used to keep the paths away from the sensor edges, and the table is applied to every pixel. For pixels at
+ * the edge of the matrix this is an approximation: paths crossing into a neighboring cell follow the fields of a pixel which
+ * does not exist there, and may end outside of the pixel matrix. Along the path, the variance of the diffusion and the
+ * magnitude of the electric field are accumulated for the corrections applied in the lookup.
+ */
+std::vector<GenericPropagationModule::DriftPath> GenericPropagationModule::build_drift_table(CarrierType type) const {
+    const auto center = model_->getPixelCenter(static_cast<int>(model_->getNPixels().x() / 2),
+                                               static_cast<int>(model_->getNPixels().y() / 2));
+
+    auto carrier_velocity = [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
+        return drift_velocity(type, detector_->getFieldSample(static_cast<ROOT::Math::XYZPoint>(cur_pos)));
+    };
+
+    std::vector<DriftPath> table;
+    table.reserve(static_cast<size_t>(drift_table_bins_.x() * drift_table_bins_.y() * drift_table_bins_.z()));
+    for(int xbin = 0; xbin < drift_table_bins_.x(); ++xbin) {
+        for(int ybin = 0; ybin < drift_table_bins_.y(); ++ybin) {
+            for(int zbin = 0; zbin < drift_table_bins_.z(); ++zbin) {
+                Eigen::Vector3d position(center.x() + drift_table_origin_.x() + (xbin + 0.5) * drift_table_bin_size_.x(),
+                                         center.y() + drift_table_origin_.y() + (ybin + 0.5) * drift_table_bin_size_.y(),
+                                         drift_table_origin_.z() + (zbin + 0.5) * drift_table_bin_size_.z());
+                auto runge_kutta = make_runge_kutta(tableau::RK5, carrier_velocity, timestep_start_, position);
+
+                double diffusion_variance = 0;
+                double field_integral = 0;
+                bool reached_end = false;
+                auto fields = detector_->getFieldSample(static_cast<ROOT::Math::XYZPoint>(position));
+                while(runge_kutta.getTime() < integration_time_) {
+                    auto efield_mag = std::sqrt(fields.electric_field.Mag2());
+                    auto doping = fields.doping_concentration;
+                    Eigen::Vector3d last_position = position;
+
+                    auto step = runge_kutta.step();
+                    auto timestep = runge_kutta.getTimeStep();
+                    position = runge_kutta.getValue();
+                    diffusion_variance += 2. * boltzmann_kT_ * mobility_(type, efield_mag, doping) * timestep;
+                    field_integral += efield_mag * timestep;
+
+                    // Stop at the sensor surface or in an implant
+                    auto point = static_cast<ROOT::Math::XYZPoint>(position);
+                    if(!geometry_->isWithinSensor(point)) {
+                        auto intercept =
+                            model_->getSensorIntercept(static_cast<ROOT::Math::XYZPoint>(last_position), point);
+                        position = Eigen::Vector3d(intercept.x(), intercept.y(), intercept.z());
+                        reached_end = true;
+                        break;
+                    }
+                    if(geometry_->isWithinImplant(point) != nullptr) {
+                        reached_end = true;
+                        break;
+                    }
+                    fields = detector_->getFieldSample(point);
+
+                    // Adapt step size to match target precision
+                    runge_kutta.setTimeStep(adapt_timestep(timestep,
+                                                           step.error.norm(),
+                                                           geometry_->getSensorSize().z() / 2.0 - position.z(),
+                                                           step.value.z()));
+                }
+
+                auto time = runge_kutta.getTime();
+                table.push_back({std::min(time, integration_time_),
+                                 ROOT::Math::XYZPoint(position.x() - center.x(), position.y() - center.y(), position.z()),
+                                 diffusion_variance,
+                                 (time > 0 ? field_integral / time : 0.),
+                                 reached_end});
+            }
+        }
+    }
+    return table;
+}
+
+/**
+ * The position is mapped into the pixel cell of the table and the drift path is interpolated trilinearly between the
+ * paths of the eight surrounding bin centers. Positions closer to the cell boundary than half a bin use the outermost bins,
+ * such that paths of neighboring pixels are never mixed. The interpolated path only reaches its end if all paths
+ * contributing to it do.
+ */
+GenericPropagationModule::DriftPath GenericPropagationModule::lookup_drift_path(CarrierType type,
+                                                                                const ROOT::Math::XYZPoint& position) const {
+    const auto& table = drift_tables_[type == CarrierType::ELECTRON ? 0 : 1];
+    auto [xpixel, ypixel] = geometry_->getPixelIndex(position);
+    auto center = geometry_->getPixelCenter(xpixel, ypixel);
+
+    const std::array<double, 3> offset{position.x() - center.x() - drift_table_origin_.x(),
+                                       position.y() - center.y() - drift_table_origin_.y(),
+                                       position.z() - drift_table_origin_.z()};
+    const std::array<double, 3> bin_size{drift_table_bin_size_.x(), drift_table_bin_size_.y(), drift_table_bin_size_.z()};
+    const std::array<int, 3> bins{drift_table_bins_.x(), drift_table_bins_.y(), drift_table_bins_.z()};
+
+    // Find the surrounding bin centers and the fractional distance to them
+    std::array<std::array<int, 2>, 3> index{};
+    std::array<double, 3> fraction{};
+    for(size_t axis = 0; axis < 3; ++axis) {
+        auto coordinate = std::clamp(offset[axis] / bin_size[axis] - 0.5, 0., static_cast<double>(bins[axis] - 1));
+        index[axis][0] = static_cast<int>(coordinate);
+        index[axis][1] = std::min(index[axis][0] + 1, bins[axis] - 1);
+        fraction[axis] = coordinate - index[axis][0];
+    }
+
+    double time = 0, end_x = 0, end_y = 0, end_z = 0, diffusion_variance = 0, electric_field = 0;
+    bool reached_end = true;
+    for(size_t corner = 0; corner < 8; ++corner) {
+        double weight = 1;
+        std::array<int, 3> node{};
+        for(size_t axis = 0; axis < 3; ++axis) {
+            auto upper = (corner >> axis) & 1u;
+            node[axis] = index[axis][upper];
+            weight *= (upper != 0 ? fraction[axis] : 1 - fraction[axis]);
+        }
+
+        const auto& path = table[static_cast<size_t>((node[0] * bins[1] + node[1]) * bins[2] + node[2])];
+        time += weight * path.time;
+        end_x += weight * path.end.x();
+        end_y += weight * path.end.y();
+        end_z += weight * path.end.z();
+        diffusion_variance += weight * path.diffusion_variance;
+        electric_field += weight * path.electric_field;
+        reached_end = reached_end && (weight == 0 || path.reached_end);
+    }
+    return {time,
+            ROOT::Math::XYZPoint(center.x() + end_x, center.y() + end_y, end_z),
+            diffusion_variance,
+            electric_field,
+            reached_end};
+}
+
+/**
+ * The set of charges moves on a straight line between the start and the end point of the tabulated path, which is exact
+ * for the end point and approximate for intermediate positions. Recombination and trapping are evaluated with the doping
+ * concentration at the start and the average electric field of the path, the time of their first occurrence is found by
+ * bisection of the probability given by the models. The diffusion is applied transverse to the sensor for sets of charges
+ * reaching the end of their path, the longitudinal component changes their arrival time instead.
+ */
+std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double, unsigned int, unsigned int>
+GenericPropagationModule::propagate_tabulated(Event* event,
+                                              const DepositedCharge& deposit,
+                                              const uint32_t deposit_index,
+                                              unsigned int charge,
+                                              PropagatedChargeOutput& propagated_charges) const {
+    const auto type = deposit.getType();
+    const auto initial_time_local = deposit.getLocalTime();
+    auto position = deposit.getLocalPosition();
+    double time = 0;
+    unsigned int field_lookups = 0;
+
+    allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
+
+    // Time of the first occurrence of a process within a duration, or infinity if it does not occur
+    auto occurrence_time = [](double duration, const auto& occurs_within) {
+        if(!occurs_within(duration)) {
+            return std::numeric_limits<double>::infinity();
+        }
+        double lower = 0, upper = duration;
+        for(int i = 0; i < 32; ++i) {
+            auto middle = (lower + upper) / 2;
+            if(occurs_within(middle)) {
+                upper = middle;
+            } else {
+                lower = middle;
+            }
+        }
+        return upper;
+    };
+
+    auto state = CarrierState::MOTION;
+    while(state == CarrierState::MOTION && (initial_time_local + time) < integration_time_) {
+        auto path = lookup_drift_path(type, position);
+        auto doping = detector_->getFieldSample(position).doping_concentration;
+        ++field_lookups;
+        auto duration = std::min(path.time, integration_time_ - initial_time_local - time);
+
+        // Sample the times of recombination and trapping along the path
+        std::array<double, 2> probabilities{};
+        event->getRandomEngine().fillUniform(probabilities.data(), probabilities.size());
+        auto recombination_time = occurrence_time(duration, [&](double dt) {
+            return recombination_(type, doping, probabilities[0], dt);
+        });
+        auto trapping_time = occurrence_time(duration, [&](double dt) {
+            return trapping_(type, probabilities[1], dt, path.electric_field);
+        });
+        auto stop_time = std::min({duration, recombination_time, trapping_time});
+        auto arrived = (path.reached_end && stop_time >= path.time);
+
+        // Move along the path and apply the diffusion accumulated until the stop
+        auto fraction = (path.time > 0 ? stop_time / path.time : 1.);
+        auto diffusion_std_dev = std::sqrt(fraction * path.diffusion_variance);
+        auto drift = path.end - position;
+        auto last_position = position;
+
+        // At the end of the path, the diffusion along the drift delays the arrival instead of moving the charges
+        std::array<double, 3> diffusion{};
+        auto delayed = (arrived && drift.Mag2() > 0);
+        event->getRandomEngine().fillNormal(diffusion.data(), (arrived && !delayed) ? 2 : 3, 0., diffusion_std_dev);
+        position = position + fraction * drift +
+                   ROOT::Math::XYZVector(diffusion[0], diffusion[1], arrived ? 0. : diffusion[2]);
+        if(delayed) {
+            auto arrival_delay = diffusion[2] * path.time / std::sqrt(drift.Mag2());
+            stop_time = std::max(0., stop_time + arrival_delay);
+        }
+        time += stop_time;
+
+        // Find proper final position in the sensor if the diffusion moved the set of charges outside
+        if(!geometry_->isWithinSensor(position)) {
+            position = model_->getSensorIntercept(last_position, position);
+            state = CarrierState::HALTED;
+        } else if(arrived) {
+            state = CarrierState::HALTED;
+        } else if(stop_time == recombination_time) {
+            state = CarrierState::RECOMBINED;
+        } else if(stop_time == trapping_time) {
+            if(output_plots_) {
+                trapping_time_histo_->Fill(static_cast<double>(Units::convert(time, "ns")), charge);
+            }
+
+            auto detrap_time = detrapping_(type, uniform_distribution(event->getRandomEngine()), path.electric_field);
+            if((initial_time_local + time + detrap_time) < integration_time_) {
+                LOG(DEBUG) << "De-trapping charge carrier after " << Units::display(detrap_time, {"ns", "us"});
+                time += detrap_time;
+                if(output_plots_) {
+                    detrapping_time_histo_->Fill(static_cast<double>(Units::convert(detrap_time, "ns")), charge);
+                }
+            } else {
+                state = CarrierState::TRAPPED;
+            }
+        } else {
+            // Integration time reached before the end of the path
+            break;
+        }
+    }
+
+    unsigned int recombined_charges_count = 0;
+    unsigned int trapped_charges_count = 0;
+    if(state == CarrierState::RECOMBINED) {
+        recombined_charges_count = charge;
+        if(output_plots_) {
+            recombination_time_histo_->Fill(static_cast<double>(Units::convert(time, "ns")), charge);
+        }
+    } else if(state == CarrierState::TRAPPED) {
+        trapped_charges_count = charge;
+    }
+
+    LOG(DEBUG) << " Propagated " << charge << " to " << Units::display(position, {"mm", "um"}) << " in "
+               << Units::display(time, "ns") << " time, final state: " << allpix::to_string(state);
+
+    propagated_charges.add(position,
+                           detector_->getGlobalPosition(position),
+                           type,
+                           charge,
+                           deposit.getLocalTime() + time,
+                           deposit.getGlobalTime() + time,
+                           state,
+                           deposit,
+                           deposit_index);
+
+    if(output_plots_) {
+        drift_time_histo_->Fill(static_cast<double>(Units::convert(time, "ns")), charge);
+        group_size_histo_->Fill(charge);
+    }
+
+    // Return statistics counters about the propagated charge carrier group and its final state, no integration steps
+    return std::make_tuple(recombined_charges_count,
+                           trapped_charges_count,
+                           charge,
+                           1u,
+                           static_cast<long double>(time) * charge,
+                           0u,
+                           field_lookups);
 }
 
 void GenericPropagationModule::finalize() {
@@ -867,6 +1646,15 @@ void GenericPropagationModule::finalize() {
                                std::max(1u, static_cast<unsigned int>(total_propagated_charges_));
     LOG(INFO) << "Propagated total of " << total_propagated_charges_ << " charges in " << total_steps_
               << " steps in average time of " << Units::display(average_time, "ns");
+    if(engine_ != Engine::TABULATED) {
+        LOG(INFO) << "Integrated equations of motion with "
+                  << (integrator_ == Integrator::DORMAND_PRINCE ? "Dormand-Prince" : "Runge-Kutta-Fehlberg")
+                  << " method in average of "
+                  << static_cast<double>(total_integration_steps_) / std::max(1u, static_cast<unsigned int>(total_steps_))
+                  << " steps and "
+                  << static_cast<double>(total_field_lookups_) / std::max(1u, static_cast<unsigned int>(total_steps_))
+                  << " field lookups per set of charge carriers";
+    }
     LOG(INFO) << deposits_exceeding_max_groups_ * 100.0 / total_deposits_ << "% of deposits have charge exceeding the "
               << max_charge_groups_ << " charge groups allowed, with a charge_per_step value of " << charge_per_step_ << ".";
 }
@@ -9,24 +9,32 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <array>
 #include <atomic>
 #include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <Eigen/Core>
+
 #include <Math/Point3D.h>
+#include <Math/Vector3D.h>
 #include <TFile.h>
 #include <TH1D.h>
 #include <TProfile.h>
 
 #include "core/config/Configuration.hpp"
 #include "core/geometry/DetectorModel.hpp"
+#include "core/geometry/RectangularPixelGeometry.hpp"
 #include "core/messenger/Messenger.hpp"
 #include "core/module/Event.hpp"
 #include "core/module/Module.hpp"
 
 #include "objects/DepositedCharge.hpp"
 #include "objects/PropagatedCharge.hpp"
+#include "objects/PropagatedChargeArray.hpp"
 
 #include "physics/Detrapping.hpp"
 #include "physics/ImpactIonization.hpp"
@@ -36,6 +44,7 @@
 
 #include "tools/ROOT.h"
 #include "tools/line_graphs.h"
+#include "tools/runge_kutta.h"
 
 namespace allpix {
 
@@ -50,6 +59,23 @@ namespace allpix {
      * each other and are treated fully separate, allowing for a speed-up by propagating the charges in multiple threads.
      */
     class GenericPropagationModule : public Module {
+        /**
+         * @brief Engines available to propagate the sets of charge carriers
+         */
+        enum class Engine {
+            SCALAR,    ///< Propagate one set of charge carriers after the other
+            BATCHED,   ///< Advance a batch of sets of charge carriers in lock-step
+            TABULATED, ///< Look up the drift of the sets of charge carriers in precomputed tables
+        };
+
+        /**
+         * @brief Integrators available for the equations of motion
+         */
+        enum class Integrator {
+            RUNGE_KUTTA_FEHLBERG, ///< Runge-Kutta-Fehlberg method with step size scaling towards the spatial precision
+            DORMAND_PRINCE,       ///< Dormand-Prince method with rejection of steps and controlled step size
+        };
+
     public:
         /**
          * @brief Constructor for this detector-specific module
@@ -79,38 +105,222 @@ namespace allpix {
         std::shared_ptr<const Detector> detector_;
         std::shared_ptr<DetectorModel> model_;
 
+        // Non-virtual geometry kernel used in the step loop if the detector model supports it
+        std::optional<RectangularPixelGeometry> geometry_;
+
+        /**
+         * @brief Output of the propagated sets of charges, as objects or in compact storage
+         */
+        struct PropagatedChargeOutput {
+            /**
+             * @brief Add a propagated set of charges to the output
+             * @param local_position Local position of the propagated set of charges in the sensor
+             * @param global_position Global position of the propagated set of charges in the sensor
+             * @param type Type of the propagated carriers
+             * @param charge Total charge propagated
+             * @param local_time Time of propagation arrival after energy deposition, local reference frame
+             * @param global_time Total time of propagation arrival after event start, global reference frame
+             * @param state State of the charge carrier when reaching its position
+             * @param deposit Related deposited charge
+             * @param deposit_index Position of the related deposited charge in its message
+             */
+            void add(const ROOT::Math::XYZPoint& local_position,
+                     const ROOT::Math::XYZPoint& global_position,
+                     CarrierType type,
+                     unsigned int charge,
+                     double local_time,
+                     double global_time,
+                     CarrierState state,
+                     const DepositedCharge& deposit,
+                     uint32_t deposit_index);
+
+            bool compact{};
+            std::vector<PropagatedCharge> objects;
+            PropagatedChargeArray array;
+        };
+
+        /**
+         * @brief Compute the drift velocity of a charge carrier from the fields at its position
+         * @param type   Type of the charge carrier
+         * @param fields Fields and doping concentration at the position of the charge carrier
+         * @return Drift velocity of the charge carrier, including the Hall effect in a magnetic field
+         */
+        Eigen::Vector3d drift_velocity(CarrierType type, const FieldSample& fields) const;
+
+        /**
+         * @brief Sample the diffusion of a set of charge carriers during a step
+         * @param event                Pointer to current event
+         * @param type                 Type of the charge carrier
+         * @param efield_mag           Magnitude of the electric field at the start of the step
+         * @param doping_concentration Doping concentration at the start of the step
+         * @param timestep             Time step
+         * @return Displacement from the diffusion in the three dimensions
+         */
+        Eigen::Vector3d carrier_diffusion(
+            Event* event, CarrierType type, double efield_mag, double doping_concentration, double timestep) const;
+
+        /**
+         * @brief Apply recombination, trapping and detrapping to a set of charge carriers after a step
+         * @param event                Pointer to current event
+         * @param type                 Type of the charge carrier
+         * @param charge               Charge of the set of charge carriers
+         * @param doping_concentration Doping concentration at the end of the step
+         * @param efield_mag           Magnitude of the electric field at the start of the step
+         * @param timestep             Time step
+         * @param initial_time         Local time at the start of the propagation of the set of charge carriers
+         * @param time                 Propagation time at the end of the step
+         * @return State of the set of charge carriers after the step and the time it was trapped before being released
+         */
+        std::pair<CarrierState, double> carrier_lifetime(Event* event,
+                                                         CarrierType type,
+                                                         unsigned int charge,
+                                                         double doping_concentration,
+                                                         double efield_mag,
+                                                         double timestep,
+                                                         double initial_time,
+                                                         double time) const;
+
+        /**
+         * @brief Adapt the time step of the next integration step
+         * @param timestep            Time step of the last step
+         * @param uncertainty         Norm of the error estimate of the last step
+         * @param edge_distance       Distance between the position after the last step and the upper sensor surface
+         * @param step_z              Drift along the sensor thickness during the last step
+         * @param controlled_timestep Time step proposed by a step size controller, if it controls the step size
+         * @return Time step of the next step
+         *
+         * Without step size controller, the time step is scaled towards the spatial precision. The time step is lowered
+         * when reaching the sensor edge, limiting the time step proposed by a step size controller.
+         */
+        double adapt_timestep(double timestep,
+                              double uncertainty,
+                              double edge_distance,
+                              double step_z,
+                              std::optional<double> controlled_timestep = std::nullopt) const;
+
         /**
          * @brief Propagate a single set of charges through the sensor
+         * @param geometry            Geometry used for the sensor and implant checks of every step
+         * @param rk_tableau          Tableau of the Runge-Kutta method to integrate the equations of motion with
          * @param event               Pointer to current event
          * @param deposit             Reference to the original deposited charge object
+         * @param deposit_index       Position of the deposited charge object in its message
          * @param pos                 Position of the deposit in the sensor
          * @param type                Type of the carrier to propagate
          * @param charge              Total charge of the observed charge carrier set
          * @param initial_time_local  Initial local time with respect to the start of the event
          * @param initial_time_global Initial global time with respect to the start of the event
          * @param level               Current level depth of the generated shower
-         * @param propagated_charges  Reference to vector with all produced final PropagatedCharge objects
+         * @param propagated_charges  Reference to the output of all produced final propagated charges
          * @param output_plot_points Reference to vector to hold points for line graph output plots
          *
-         * @return Total recombined, trapped and propagated charge for statistics purposes
+         * @return Total recombined, trapped and propagated charge, sets of charges, propagation time, integration steps and
+         * field lookups for statistics purposes
          */
-        std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double>
-        propagate(Event* event,
+        template <typename Geometry, size_t S>
+        std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double, unsigned int, unsigned int>
+        propagate(const Geometry& geometry,
+                  const ButcherTableau<double, S>& rk_tableau,
+                  Event* event,
                   const DepositedCharge& deposit,
+                  const uint32_t deposit_index,
                   const ROOT::Math::XYZPoint& pos,
                   const CarrierType& type,
                   unsigned int charge,
                   const double initial_time_local,
                   const double initial_time_global,
                   const unsigned int level,
-                  std::vector<PropagatedCharge>& propagated_charges,
+                  PropagatedChargeOutput& propagated_charges,
                   LineGraph::OutputPlotPoints& output_plot_points) const;
 
+        /**
+         * @brief Set of charge carriers of a deposit queued for batched propagation
+         */
+        struct CarrierGroup {
+            const DepositedCharge* deposit;
+            uint32_t deposit_index;
+            unsigned int charge;
+        };
+
+        /**
+         * @brief Propagate sets of charges through the sensor, advancing a batch of them in lock-step
+         * @param geometry            Geometry used for the sensor and implant checks of every step
+         * @param event               Pointer to current event
+         * @param groups              Sets of charge carriers to propagate
+         * @param propagated_charges  Reference to the output of all produced final propagated charges
+         *
+         * @return Total recombined, trapped and propagated charge, sets of charges, propagation time, integration steps and
+         * field lookups for statistics purposes
+         *
+         * The sets of charge carriers occupy the lanes of the batch, with positions, time steps and states stored as
+         * separate arrays. Lanes of sets which stopped moving are refilled with the next queued set. The final propagated
+         * charges are stored in the order of the groups.
+         */
+        template <typename Geometry>
+        std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double, unsigned int, unsigned int>
+        propagate_batched(const Geometry& geometry,
+                          Event* event,
+                          const std::vector<CarrierGroup>& groups,
+                          PropagatedChargeOutput& propagated_charges) const;
+
+        /**
+         * @brief Deterministic drift path from a starting point, without diffusion
+         */
+        struct DriftPath {
+            double time;               ///< Drift time until the path ends or the integration time is reached
+            ROOT::Math::XYZPoint end;  ///< End point, in x and y relative to the center of the starting pixel
+            double diffusion_variance; ///< Variance of the diffusion per axis accumulated along the path
+            double electric_field;     ///< Time-averaged magnitude of the electric field along the path
+            bool reached_end;          ///< If the path ends at the sensor surface or in an implant before the time limit
+        };
+
+        /**
+         * @brief Tabulate the drift paths of a carrier type on the grid within a pixel cell
+         * @param type Type of the carrier to tabulate
+         * @return Drift paths of all grid points
+         */
+        std::vector<DriftPath> build_drift_table(CarrierType type) const;
+
+        /**
+         * @brief Interpolate the drift path from a position in the sensor between the points of the table
+         * @param type Type of the carrier to look up
+         * @param position Starting position in local coordinates
+         * @return Drift path with its end point in local coordinates
+         */
+        DriftPath lookup_drift_path(CarrierType type, const ROOT::Math::XYZPoint& position) const;
+
+        /**
+         * @brief Propagate a single set of charges through the sensor using the drift tables
+         * @param event               Pointer to current event
+         * @param deposit             Reference to the original deposited charge object
+         * @param deposit_index       Position of the deposited charge object in its message
+         * @param charge              Total charge of the observed charge carrier set
+         * @param propagated_charges  Reference to the output of all produced final propagated charges
+         *
+         * @return Total recombined, trapped and propagated charge, sets of charges, propagation time, integration steps and
+         * field lookups for statistics purposes
+         *
+         * The deterministic drift is taken from the tables and smeared by the diffusion accumulated along the path. The
+         * times of recombination and trapping are sampled for the full path, a trapped set of charges continues from its
+         * trapping position with a new table lookup once it is released.
+         */
+        std::tuple<unsigned int, unsigned int, unsigned int, unsigned int, long double, unsigned int, unsigned int>
+        propagate_tabulated(Event* event,
+                            const DepositedCharge& deposit,
+                            const uint32_t deposit_index,
+                            unsigned int charge,
+                            PropagatedChargeOutput& propagated_charges) const;
+
         // Local copies of configuration parameters to avoid costly lookup:
         double temperature_{}, timestep_min_{}, timestep_max_{}, timestep_start_{}, integration_time_{},
             target_spatial_precision_{}, output_plots_step_{};
         bool output_plots_{}, output_linegraphs_{}, output_linegraphs_collected_{}, output_linegraphs_recombined_{},
             output_linegraphs_trapped_{}, output_animations_{};
+        bool compact_output_{};
+        Engine engine_{};
+        Integrator integrator_{};
+        size_t batch_size_{};
+        ROOT::Math::DisplacementVector3D<ROOT::Math::Cartesian3D<int>> drift_table_bins_{};
         bool propagate_electrons_{}, propagate_holes_{};
         unsigned int charge_per_step_{};
         unsigned int max_charge_groups_{};
@@ -133,9 +343,16 @@ namespace allpix {
         // Magnetic field
         bool has_magnetic_field_;
 
+        // Drift tables for electrons and holes, with the lower edge and the size of their bins
+        std::array<std::vector<DriftPath>, 2> drift_tables_;
+        ROOT::Math::XYZVector drift_table_origin_;
+        ROOT::Math::XYZVector drift_table_bin_size_;
+
         // Statistical information
         std::atomic<unsigned int> total_propagated_charges_{};
         std::atomic<unsigned int> total_steps_{};
+        std::atomic<unsigned long> total_integration_steps_{};
+        std::atomic<unsigned long> total_field_lookups_{};
         std::atomic<long unsigned int> total_time_picoseconds_{};
         std::atomic<unsigned int> total_deposits_{}, deposits_exceeding_max_groups_{};
         Histogram<TH1D> step_length_histo_;
@@ -26,6 +26,9 @@ InducedTransferModule::InducedTransferModule(Configuration& config, Messenger* m
     // Enable multithreading of this module if multithreading is enabled
     allow_multithreading();
 
+    // Requires the deposited charges the propagated charges originate from
+    require_history(HistoryMode::FULL);
+
     // Save detector model
     model_ = detector_->getModel();
 
@@ -125,6 +128,6 @@ void InducedTransferModule::run(Event* event) {
     }
 
     // Dispatch message of pixel charges
-    auto pixel_message = std::make_shared<PixelChargeMessage>(pixel_charges, detector_);
+    auto pixel_message = event->makeShared<PixelChargeMessage>(pixel_charges, detector_);
     messenger_->dispatchMessage(this, pixel_message, event);
 }
@@ -117,6 +117,7 @@ LCIOWriterModule::LCIOWriterModule(Configuration& config, Messenger* messenger,
     messenger_->bindMulti<MCParticleMessage>(this, MsgFlags::REQUIRED);
     if(dump_mc_truth_) {
         messenger_->bindSingle<MCTrackMessage>(this, MsgFlags::REQUIRED);
+        require_history(HistoryMode::PARTICLES);
     }
 
     if(has_short_config && has_long_config) {
@@ -15,6 +15,8 @@
 #include "objects/PixelCharge.hpp"
 #include "objects/exceptions.h"
 
+#include <map>
+#include <memory_resource>
 #include <set>
 #include <string>
 #include <utility>
@@ -100,10 +102,11 @@ void PulseTransferModule::run(Event* event) {
     auto propagated_message = messenger_->fetchMessage<PropagatedChargeMessage>(this, event);
 
     // Create map for all pixels: pulse and propagated charges
-    std::map<Pixel::Index, Pulse> pixel_pulse_map;
-    std::map<Pixel::Index, std::set<const PropagatedCharge*>> pixel_charge_map;
+    std::pmr::map<Pixel::Index, Pulse> pixel_pulse_map(event->getMemoryResource());
+    std::pmr::map<Pixel::Index, std::pmr::set<const PropagatedCharge*>> pixel_charge_map(event->getMemoryResource());
 
     LOG(DEBUG) << "Received " << propagated_message->getData().size() << " propagated charge objects.";
+    bool without_pulses = false;
     for(const auto& propagated_charge : propagated_message->getData()) {
 
         // Skip charge carriers requested from configuration:
@@ -112,82 +115,97 @@ void PulseTransferModule::run(Event* event) {
             continue;
         }
 
-        auto pulses = propagated_charge.getPulses();
+        // Charge carriers without pulse information are collected per pixel below
+        if(!propagated_charge.hasPulses()) {
+            without_pulses = true;
+            continue;
+        }
 
-        if(pulses.empty()) {
-            LOG_ONCE(INFO) << "No pulse information available - producing pseudo-pulse from arrival time of charge carriers";
+        LOG(TRACE) << "Found pulse information";
+        LOG_ONCE(INFO) << "Pulses available - settings \"timestep\", \"max_depth_distance\" and "
+                          "\"collect_from_implant\" have no effect";
 
-            auto model = detector_->getModel();
-            auto position = propagated_charge.getLocalPosition();
+        for(auto& [pixel_index, pulse] : propagated_charge.getPulses()) {
+            // Accumulate all pulses from input message data:
+            pixel_pulse_map[pixel_index] += pulse;
 
-            if(collect_from_implant_) {
-                std::call_once(first_event_flag_, [&]() {
-                    if(model->getImplants().empty()) {
-                        throw InvalidValueError(
-                            config_,
-                            "collect_from_implant",
-                            "Detector model does not have implants defined, but collection requested from implants");
-                    }
-                    if(detector_->getElectricFieldType() == FieldType::LINEAR) {
-                        throw ModuleError(
-                            "Charge collection from implant region should not be used with linear electric fields.");
-                    }
-                });
+            // For each pulse, store the corresponding propagated charges to preserve history:
+            pixel_charge_map[pixel_index].emplace(&propagated_charge);
+        }
+    }
 
-                // Ignore if outside the implant region:
-                if(!model->isWithinImplant(position)) {
-                    LOG(TRACE) << "Skipping set of " << propagated_charge.getCharge() << " propagated charges at "
-                               << Units::display(propagated_charge.getLocalPosition(), {"mm", "um"})
-                               << " because their local position is outside the pixel implant";
-                    continue;
+    if(without_pulses) {
+        LOG_ONCE(INFO) << "No pulse information available - producing pseudo-pulse from arrival time of charge carriers";
+
+        auto model = detector_->getModel();
+        if(collect_from_implant_) {
+            std::call_once(first_event_flag_, [&]() {
+                if(model->getImplants().empty()) {
+                    throw InvalidValueError(
+                        config_,
+                        "collect_from_implant",
+                        "Detector model does not have implants defined, but collection requested from implants");
                 }
-            } else if(std::fabs(position.z() - (model->getSensorCenter().z() + model->getSensorSize().z() / 2.0)) >
-                      max_depth_distance_) {
-                // Ignore if not close to the sensor surface:
-                LOG(TRACE) << "Skipping set of " << propagated_charge.getCharge() << " propagated charges at "
-                           << Units::display(propagated_charge.getLocalPosition(), {"mm", "um"})
-                           << " because their local position is not near sensor surface";
-                continue;
-            }
-
-            // Find the nearest pixel
-            auto [xpixel, ypixel] = model->getPixelIndex(position);
+                if(detector_->getElectricFieldType() == FieldType::LINEAR) {
+                    throw ModuleError(
+                        "Charge collection from implant region should not be used with linear electric fields.");
+                }
+            });
+        }
 
-            // Ignore if out of pixel grid
-            if(!detector_->getModel()->isWithinMatrix(xpixel, ypixel)) {
-                LOG(TRACE) << "Skipping set of " << propagated_charge.getCharge() << " propagated charges at "
-                           << Units::display(propagated_charge.getLocalPosition(), {"mm", "um"})
-                           << " because their nearest pixel (" << xpixel << "," << ypixel << ") is outside the grid";
-                continue;
+        // Use the propagated charges grouped by their nearest pixel, shared with other modules receiving the same message
+        auto skip = [this](const PropagatedCharge* propagated_charge) {
+            return (skip_charge_carriers_ && propagated_charge->getType() == skip_carrier_) ||
+                   propagated_charge->hasPulses();
+        };
+        const auto& pixel_index_map = propagated_message->getPixelIndex();
+        for(const auto* propagated_charge : pixel_index_map.outside()) {
+            if(!skip(propagated_charge)) {
+                LOG(TRACE) << "Skipping set of " << propagated_charge->getCharge() << " propagated charges at "
+                           << Units::display(propagated_charge->getLocalPosition(), {"mm", "um"})
+                           << " because their nearest pixel is outside the grid";
             }
+        }
 
-            Pixel::Index pixel_index(xpixel, ypixel);
-
-            // Generate pseudo-pulse:
-            Pulse pulse(timestep_);
-            try {
-                pulse.addCharge(static_cast<double>(propagated_charge.getSign() * propagated_charge.getCharge()),
-                                propagated_charge.getLocalTime());
-            } catch(const PulseBadAllocException& e) {
-                LOG(ERROR) << e.what() << std::endl
-                           << "Ignoring pulse contribution at time "
-                           << Units::display(propagated_charge.getLocalTime(), {"ms", "us", "ns"});
-            }
-            pixel_pulse_map[pixel_index] += pulse;
+        for(size_t n = 0; n < pixel_index_map.size(); ++n) {
+            const auto& pixel_index = pixel_index_map.pixel(n);
+            for(const auto* propagated_charge : pixel_index_map.objects(n)) {
+                if(skip(propagated_charge)) {
+                    continue;
+                }
 
-            // For each pulse, store the corresponding propagated charges to preserve history:
-            pixel_charge_map[pixel_index].emplace(&propagated_charge);
-        } else {
-            LOG(TRACE) << "Found pulse information";
-            LOG_ONCE(INFO) << "Pulses available - settings \"timestep\", \"max_depth_distance\" and "
-                              "\"collect_from_implant\" have no effect";
+                auto position = propagated_charge->getLocalPosition();
+                if(collect_from_implant_) {
+                    // Ignore if outside the implant region:
+                    if(!model->isWithinImplant(position)) {
+                        LOG(TRACE) << "Skipping set of " << propagated_charge->getCharge() << " propagated charges at "
+                                   << Units::display(propagated_charge->getLocalPosition(), {"mm", "um"})
+                                   << " because their local position is outside the pixel implant";
+                        continue;
+                    }
+                } else if(std::fabs(position.z() - (model->getSensorCenter().z() + model->getSensorSize().z() / 2.0)) >
+                          max_depth_distance_) {
+                    // Ignore if not close to the sensor surface:
+                    LOG(TRACE) << "Skipping set of " << propagated_charge->getCharge() << " propagated charges at "
+                               << Units::display(propagated_charge->getLocalPosition(), {"mm", "um"})
+                               << " because their local position is not near sensor surface";
+                    continue;
+                }
 
-            for(auto& [pixel_index, pulse] : pulses) {
-                // Accumulate all pulses from input message data:
+                // Generate pseudo-pulse:
+                Pulse pulse(timestep_);
+                try {
+                    pulse.addCharge(static_cast<double>(propagated_charge->getSign() * propagated_charge->getCharge()),
+                                    propagated_charge->getLocalTime());
+                } catch(const PulseBadAllocException& e) {
+                    LOG(ERROR) << e.what() << std::endl
+                               << "Ignoring pulse contribution at time "
+                               << Units::display(propagated_charge->getLocalTime(), {"ms", "us", "ns"});
+                }
                 pixel_pulse_map[pixel_index] += pulse;
 
                 // For each pulse, store the corresponding propagated charges to preserve history:
-                pixel_charge_map[pixel_index].emplace(&propagated_charge);
+                pixel_charge_map[pixel_index].emplace(propagated_charge);
             }
         }
     }
@@ -251,7 +269,7 @@ void PulseTransferModule::run(Event* event) {
     }
 
     // Create a new message with pixel pulses and dispatch:
-    auto pixel_charge_message = std::make_shared<PixelChargeMessage>(std::move(pixel_charges), detector_);
+    auto pixel_charge_message = event->makeShared<PixelChargeMessage>(std::move(pixel_charges), detector_);
     messenger_->dispatchMessage(this, pixel_charge_message, event);
 
     // Fill pixel charge histogram
@@ -37,6 +37,9 @@ ROOTObjectReaderModule::ROOTObjectReaderModule(Configuration& config, Messenger*
     : Module(config), messenger_(messenger), geo_mgr_(geo_mgr) {
     // Enable multithreading of this module if multithreading is enabled
     allow_multithreading();
+
+    // Messages are dispatched with the names they have been stored with
+    allow_named_dispatch();
 }
 
 /**
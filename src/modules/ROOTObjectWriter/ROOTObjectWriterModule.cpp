@@ -35,6 +35,9 @@ ROOTObjectWriterModule::ROOTObjectWriterModule(Configuration& config, Messenger*
     // Enable multithreading of this module if multithreading is enabled
     allow_multithreading();
 
+    // Storing the objects requires all relations between them
+    require_history(HistoryMode::FULL);
+
     // Bind to all messages with filter
     messenger_->registerFilter(this, &ROOTObjectWriterModule::filter);
 
@@ -110,13 +113,8 @@ bool ROOTObjectWriterModule::filter(const std::shared_ptr<BaseMessage>& message,
         }
         LOG(TRACE) << "ROOT object writer received " << allpix::demangle(typeid(*inst).name()) << name_str;
 
-        // Read the object
-        auto object_array = message->getObjectArray();
-        if(object_array.empty()) {
-            return false;
-        }
-        const Object& first_object = object_array[0];
-        std::string class_name = allpix::demangle(typeid(first_object).name());
+        // Check the type of the objects first, objects of some messages are only created when requested
+        std::string class_name = allpix::demangle(message->getObjectType().name());
 
         // Check if this message should be kept
         if((!include_.empty() && include_.find(class_name) == include_.cend()) ||
@@ -125,6 +123,12 @@ bool ROOTObjectWriterModule::filter(const std::shared_ptr<BaseMessage>& message,
                        << " because it has been excluded or not explicitly included";
             return false;
         }
+
+        // Read the object
+        auto object_array = message->getObjectArray();
+        if(object_array.empty()) {
+            return false;
+        }
     } catch(MessageWithoutObjectException& e) {
         const BaseMessage* inst = message.get();
         LOG(WARNING) << "ROOT object writer cannot process message of type" << allpix::demangle(typeid(*inst).name())
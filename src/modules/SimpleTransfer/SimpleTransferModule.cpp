@@ -15,11 +15,14 @@
 #include <limits>
 #include <memory>
 #include <new>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "core/config/exceptions.h"
+#include "core/messenger/exceptions.h"
 #include "core/utils/log.h"
 #include "core/utils/unit.h"
 #include "tools/ROOT.h"
@@ -54,8 +57,9 @@ SimpleTransferModule::SimpleTransferModule(Configuration& config, Messenger* mes
     // Cache flag for output plots:
     output_plots_ = config_.get<bool>("output_plots");
 
-    // Require propagated deposits for single detector
-    messenger_->bindSingle<PropagatedChargeMessage>(this, MsgFlags::REQUIRED);
+    // Require propagated deposits for single detector either as objects or in compact storage
+    messenger_->bindSingle<PropagatedChargeMessage>(this, MsgFlags::REQUIRED_ANY);
+    messenger_->bindSingle<PropagatedChargeArrayMessage>(this, MsgFlags::REQUIRED_ANY);
 }
 
 void SimpleTransferModule::initialize() {
@@ -85,93 +89,187 @@ void SimpleTransferModule::initialize() {
                                                  0.,
                                                  config_.get<double>("output_plots_range"));
     }
+
+    // Pixel charges only keep their propagated charges with the full history, which is only kept if a module requires it,
+    // e.g. a writer storing the objects. Only then the objects are needed.
+    link_propagated_charges_ = (Object::getHistoryMode() == HistoryMode::FULL);
 }
 
 void SimpleTransferModule::run(Event* event) {
-    auto propagated_message = messenger_->fetchMessage<PropagatedChargeMessage>(this, event);
+    // Propagated charges are received either as objects or in compact storage, depending on the propagation module
+    std::shared_ptr<PropagatedChargeMessage> propagated_message;
+    std::shared_ptr<PropagatedChargeArrayMessage> propagated_array_message;
+    try {
+        propagated_message = messenger_->fetchMessage<PropagatedChargeMessage>(this, event);
+    } catch(const MessageNotFoundException&) {
+    }
+    try {
+        propagated_array_message = messenger_->fetchMessage<PropagatedChargeArrayMessage>(this, event);
+    } catch(const MessageNotFoundException&) {
+    }
+
+    if(propagated_message != nullptr && propagated_array_message != nullptr) {
+        throw ModuleError("Received propagated charges both as objects and in compact storage, cannot combine them");
+    }
 
     // Find corresponding pixels for all propagated charges
     LOG(TRACE) << "Transferring charges to pixels";
+    std::vector<PixelCharge> pixel_charges;
+    auto transferred_charges_count = (propagated_message != nullptr ? transfer(*propagated_message, pixel_charges)
+                                                                    : transfer(*propagated_array_message, pixel_charges));
+
+    // Writing summary and update statistics
+    LOG(INFO) << "Transferred " << transferred_charges_count << " charges to " << pixel_charges.size() << " pixels";
+    total_transferred_charges_ += transferred_charges_count;
+
+    // Dispatch message of pixel charges
+    auto pixel_message = event->makeShared<PixelChargeMessage>(pixel_charges, detector_);
+    messenger_->dispatchMessage(this, pixel_message, event);
+}
+
+unsigned int SimpleTransferModule::transfer(const PropagatedChargeMessage& propagated_message,
+                                            std::vector<PixelCharge>& pixel_charges) {
+    // Use the propagated charges grouped by their nearest pixel, shared with other modules receiving the same message
+    const auto& pixel_index_map = propagated_message.getPixelIndex();
+    for(const auto* propagated_charge : pixel_index_map.outside()) {
+        LOG(TRACE) << "Skipping set of " << propagated_charge->getCharge() << " propagated charges at "
+                   << Units::display(propagated_charge->getLocalPosition(), {"mm", "um"})
+                   << " because their nearest pixel is outside the grid";
+    }
+
     unsigned int transferred_charges_count = 0;
-    std::map<Pixel::Index, std::vector<const PropagatedCharge*>> pixel_map;
-    for(const auto& propagated_charge : propagated_message->getData()) {
-        auto position = propagated_charge.getLocalPosition();
-
-        if(collect_from_implant_) {
-            // Ignore if outside the implant region:
-            auto implant = model_->isWithinImplant(position);
-            if(!implant.has_value()) {
-                LOG(TRACE) << "Skipping set of " << propagated_charge.getCharge() << " propagated charges at "
-                           << Units::display(propagated_charge.getLocalPosition(), {"mm", "um"})
-                           << " because their local position is outside the pixel implant";
-                continue;
-            }
-            if(implant->getType() != DetectorModel::Implant::Type::FRONTSIDE) {
-                LOG(TRACE) << "Skipping set of " << propagated_charge.getCharge() << " propagated charges at "
-                           << Units::display(propagated_charge.getLocalPosition(), {"mm", "um"})
-                           << " because the pixel implant is located at " << allpix::to_string(implant->getType());
+    for(size_t n = 0; n < pixel_index_map.size(); ++n) {
+        const auto& pixel_index = pixel_index_map.pixel(n);
+
+        long charge = 0;
+        std::vector<const PropagatedCharge*> pixel_propagated_charges;
+        for(const auto* propagated_charge : pixel_index_map.objects(n)) {
+            if(!is_collected(propagated_charge->getLocalPosition(), propagated_charge->getCharge())) {
                 continue;
             }
-        } else if(std::fabs(position.z() - (model_->getSensorCenter().z() + model_->getSensorSize().z() / 2.0)) >
-                  max_depth_distance_) {
-            // Ignore if not close to the sensor surface:
-            LOG(TRACE) << "Skipping set of " << propagated_charge.getCharge() << " propagated charges at "
-                       << Units::display(propagated_charge.getLocalPosition(), {"mm", "um"})
-                       << " because their local position is not near sensor surface";
-            continue;
-        }
 
-        // Find the nearest pixel
-        auto [xpixel, ypixel] = model_->getPixelIndex(position);
+            // Update statistics
+            transferred_charges_count += propagated_charge->getCharge();
 
-        // Ignore if out of pixel grid
-        if(!model_->isWithinMatrix(xpixel, ypixel)) {
-            LOG(TRACE) << "Skipping set of " << propagated_charge.getCharge() << " propagated charges at "
-                       << Units::display(propagated_charge.getLocalPosition(), {"mm", "um"})
-                       << " because their nearest pixel (" << xpixel << "," << ypixel << ") is outside the grid";
-            continue;
-        }
+            if(output_plots_) {
+                drift_time_histo->Fill(propagated_charge->getGlobalTime(), propagated_charge->getCharge());
+            }
 
-        Pixel::Index pixel_index(xpixel, ypixel);
+            LOG(TRACE) << "Set of " << propagated_charge->getCharge() << " propagated charges at "
+                       << Units::display(propagated_charge->getLocalPosition(), {"mm", "um"}) << " brought to pixel "
+                       << pixel_index;
 
-        // Update statistics
-        transferred_charges_count += propagated_charge.getCharge();
+            // Add the charge to the hit pixel
+            charge += propagated_charge->getSign() * propagated_charge->getCharge();
+            pixel_propagated_charges.emplace_back(propagated_charge);
+        }
 
-        if(output_plots_) {
-            drift_time_histo->Fill(propagated_charge.getGlobalTime(), propagated_charge.getCharge());
+        // Skip pixels without any charge transferred
+        if(pixel_propagated_charges.empty()) {
+            continue;
         }
 
-        LOG(TRACE) << "Set of " << propagated_charge.getCharge() << " propagated charges at "
-                   << Units::display(propagated_charge.getLocalPosition(), {"mm", "um"}) << " brought to pixel "
-                   << pixel_index;
+        // Create pixel charge from the pixel object of the detector
+        auto pixel = detector_->getPixel(pixel_index.x(), pixel_index.y());
+        pixel_charges.emplace_back(pixel, charge, std::move(pixel_propagated_charges));
+        LOG(DEBUG) << "Set of " << charge << " charges combined at " << pixel.getIndex() << " from "
+                   << pixel_charges.back().getPropagatedCharges().size() << " linked propagated charges";
+    }
+    return transferred_charges_count;
+}
 
-        // Add the pixel the list of hit pixels
-        pixel_map[pixel_index].emplace_back(&propagated_charge);
+/**
+ * The properties of the propagated charges are read from the compact storage. The propagated charge objects are only created
+ * to link them to the pixel charges if the full history of objects is required by a module, otherwise the pixel charges only
+ * refer to the Monte-Carlo particles of the propagated charges.
+ */
+unsigned int SimpleTransferModule::transfer(PropagatedChargeArrayMessage& propagated_message,
+                                            std::vector<PixelCharge>& pixel_charges) {
+    const auto& propagated_charges = propagated_message.getData();
+    auto objects_message = (link_propagated_charges_ ? propagated_message.getMessage() : nullptr);
+
+    // Use the propagated charges grouped by their nearest pixel, shared with other modules receiving the same message
+    const auto& pixel_groups = propagated_message.getPixelGroups();
+    for(auto entry : pixel_groups.outside) {
+        LOG(TRACE) << "Skipping set of " << propagated_charges.getCharge(entry) << " propagated charges at "
+                   << Units::display(propagated_charges.getLocalPosition(entry), {"mm", "um"})
+                   << " because their nearest pixel is outside the grid";
     }
 
-    // Create pixel charges
-    LOG(TRACE) << "Combining charges at same pixel";
-    std::vector<PixelCharge> pixel_charges;
-    for(auto& pixel_index_charge : pixel_map) {
+    unsigned int transferred_charges_count = 0;
+    for(size_t n = 0; n < pixel_groups.pixels.size(); ++n) {
+        const auto& pixel_index = pixel_groups.pixels[n];
+
         long charge = 0;
-        for(auto& propagated_charge : pixel_index_charge.second) {
-            charge += propagated_charge->getSign() * propagated_charge->getCharge();
+        bool collected = false;
+        std::vector<const PropagatedCharge*> pixel_propagated_charges;
+        std::set<const MCParticle*> mc_particles;
+        for(size_t offset = pixel_groups.offsets[n]; offset < pixel_groups.offsets[n + 1]; ++offset) {
+            auto entry = pixel_groups.entries[offset];
+            if(!is_collected(propagated_charges.getLocalPosition(entry), propagated_charges.getCharge(entry))) {
+                continue;
+            }
+
+            // Update statistics
+            transferred_charges_count += propagated_charges.getCharge(entry);
+
+            if(output_plots_) {
+                drift_time_histo->Fill(propagated_charges.getGlobalTime(entry), propagated_charges.getCharge(entry));
+            }
+
+            LOG(TRACE) << "Set of " << propagated_charges.getCharge(entry) << " propagated charges at "
+                       << Units::display(propagated_charges.getLocalPosition(entry), {"mm", "um"}) << " brought to pixel "
+                       << pixel_index;
+
+            // Add the charge to the hit pixel
+            charge += propagated_charges.getSignedCharge(entry);
+            collected = true;
+            mc_particles.insert(propagated_message.getMCParticle(entry));
+            if(objects_message != nullptr) {
+                pixel_propagated_charges.emplace_back(&objects_message->getData()[entry]);
+            }
         }
 
-        // Get pixel object from detector
-        auto pixel = detector_->getPixel(pixel_index_charge.first.x(), pixel_index_charge.first.y());
+        // Skip pixels without any charge transferred
+        if(!collected) {
+            continue;
+        }
 
-        pixel_charges.emplace_back(pixel, charge, pixel_index_charge.second);
-        LOG(DEBUG) << "Set of " << charge << " charges combined at " << pixel.getIndex();
+        // Create pixel charge from the pixel object of the detector
+        auto pixel = detector_->getPixel(pixel_index.x(), pixel_index.y());
+        pixel_charges.emplace_back(pixel, charge, pixel_propagated_charges, mc_particles);
+        LOG(DEBUG) << "Set of " << charge << " charges combined at " << pixel.getIndex() << " from "
+                   << pixel_charges.back().getPropagatedCharges().size() << " linked propagated charges";
     }
+    LOG(DEBUG) << "Transferred charges from compact storage "
+               << (propagated_message.isMaterialized() ? "with" : "without") << " creating propagated charge objects";
+    return transferred_charges_count;
+}
 
-    // Writing summary and update statistics
-    LOG(INFO) << "Transferred " << transferred_charges_count << " charges to " << pixel_map.size() << " pixels";
-    total_transferred_charges_ += transferred_charges_count;
-
-    // Dispatch message of pixel charges
-    auto pixel_message = std::make_shared<PixelChargeMessage>(pixel_charges, detector_);
-    messenger_->dispatchMessage(this, pixel_message, event);
+bool SimpleTransferModule::is_collected(const ROOT::Math::XYZPoint& position, unsigned int charge) const {
+    if(collect_from_implant_) {
+        // Ignore if outside the implant region:
+        auto implant = model_->isWithinImplant(position);
+        if(!implant.has_value()) {
+            LOG(TRACE) << "Skipping set of " << charge << " propagated charges at "
+                       << Units::display(position, {"mm", "um"})
+                       << " because their local position is outside the pixel implant";
+            return false;
+        }
+        if(implant->getType() != DetectorModel::Implant::Type::FRONTSIDE) {
+            LOG(TRACE) << "Skipping set of " << charge << " propagated charges at "
+                       << Units::display(position, {"mm", "um"}) << " because the pixel implant is located at "
+                       << allpix::to_string(implant->getType());
+            return false;
+        }
+    } else if(std::fabs(position.z() - (model_->getSensorCenter().z() + model_->getSensorSize().z() / 2.0)) >
+              max_depth_distance_) {
+        // Ignore if not close to the sensor surface:
+        LOG(TRACE) << "Skipping set of " << charge << " propagated charges at " << Units::display(position, {"mm", "um"})
+                   << " because their local position is not near sensor surface";
+        return false;
+    }
+    return true;
 }
 
 void SimpleTransferModule::finalize() {
@@ -25,6 +25,7 @@
 #include "objects/Pixel.hpp"
 #include "objects/PixelCharge.hpp"
 #include "objects/PropagatedCharge.hpp"
+#include "objects/PropagatedChargeArray.hpp"
 
 #include "tools/ROOT.h"
 
@@ -71,10 +72,37 @@ namespace allpix {
 
         Histogram<TH1D> drift_time_histo;
 
+        /**
+         * @brief Transfer propagated charge objects to the pixels
+         * @param propagated_message Message with the propagated charges
+         * @param pixel_charges List to add the charges at the pixels to
+         * @return Number of transferred charges
+         */
+        unsigned int transfer(const PropagatedChargeMessage& propagated_message, std::vector<PixelCharge>& pixel_charges);
+
+        /**
+         * @brief Transfer propagated charges in compact storage to the pixels
+         * @param propagated_message Message with the propagated charges
+         * @param pixel_charges List to add the charges at the pixels to
+         * @return Number of transferred charges
+         */
+        unsigned int transfer(PropagatedChargeArrayMessage& propagated_message, std::vector<PixelCharge>& pixel_charges);
+
+        /**
+         * @brief Check if a set of propagated charges is close enough to the collection side to be transferred
+         * @param position Local position of the set of charges
+         * @param charge Number of charges in the set, for logging
+         * @return True if the charges are transferred to their nearest pixel
+         */
+        bool is_collected(const ROOT::Math::XYZPoint& position, unsigned int charge) const;
+
         // Configuration parameters:
         double max_depth_distance_{};
         bool collect_from_implant_{};
 
+        // Flag whether to link the pixel charges to the propagated charge objects
+        bool link_propagated_charges_{};
+
         // Flag whether to store output plots:
         bool output_plots_{};
 
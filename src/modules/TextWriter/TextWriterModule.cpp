@@ -32,6 +32,9 @@ TextWriterModule::TextWriterModule(Configuration& config, Messenger* messenger,
     // Enable multithreading of this module if multithreading is enabled
     allow_multithreading();
 
+    // Printing the objects includes their relations to other objects
+    require_history(HistoryMode::FULL);
+
     // Bind to all messages with filter
     messenger_->registerFilter(this, &TextWriterModule::filter);
 }
@@ -11,6 +11,9 @@
 
 #include "TransientPropagationModule.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <map>
 #include <memory>
 #include <string>
@@ -53,11 +56,16 @@ TransientPropagationModule::TransientPropagationModule(Configuration& config,
     config_.setDefault<unsigned int>("distance", 1);
     config_.setDefault<bool>("ignore_magnetic_field", false);
     config_.setDefault<double>("surface_reflectivity", 0.0);
+    config_.setDefault<bool>("specialized_geometry", true);
 
     // Set defaults for charge carrier multiplication
     config_.setDefault<double>("multiplication_threshold", 1e-2);
     config_.setDefault<unsigned int>("max_multiplication_level", 5);
     config_.setDefault<std::string>("multiplication_model", "none");
+    config_.setDefault<bool>("merge_charge_groups", false);
+    config_.setDefault<double>("merging_cell_size", Units::get(1, "um"));
+    config_.setDefault<double>("merging_time_bin", Units::get(0.1, "ns"));
+    config_.setDefault<unsigned int>("max_live_groups", 0);
 
     config_.setDefault<bool>("output_linegraphs", false);
     config_.setDefault<bool>("output_linegraphs_collected", false);
@@ -85,6 +93,22 @@ TransientPropagationModule::TransientPropagationModule(Configuration& config,
     surface_reflectivity_ = config_.get<double>("surface_reflectivity");
 
     max_multiplication_level_ = config.get<unsigned int>("max_multiplication_level");
+    merge_charge_groups_ = config_.get<bool>("merge_charge_groups");
+    merging_cell_size_ = config_.get<double>("merging_cell_size");
+    merging_time_bin_ = config_.get<double>("merging_time_bin");
+    max_live_groups_ = config_.get<unsigned int>("max_live_groups");
+
+    if(merge_charge_groups_) {
+        if(merging_cell_size_ <= 0) {
+            throw InvalidValueError(config_, "merging_cell_size", "cell size needs to be positive");
+        }
+        if(merging_time_bin_ <= 0) {
+            throw InvalidValueError(config_, "merging_time_bin", "time bin needs to be positive");
+        }
+    } else if(max_live_groups_ > 0) {
+        throw InvalidValueError(
+            config_, "max_live_groups", "limiting the live sets of charges requires merge_charge_groups to be enabled");
+    }
 
     output_plots_ = config_.get<bool>("output_plots");
     output_linegraphs_ = config_.get<bool>("output_linegraphs");
@@ -143,6 +167,13 @@ void TransientPropagationModule::initialize() {
     // Impact ionization model
     multiplication_ = ImpactIonization(config_);
 
+    // Bind the non-virtual geometry kernel if available for this detector model and not disabled
+    if(config_.get<bool>("specialized_geometry")) {
+        geometry_ = RectangularPixelGeometry::create(*model_);
+    }
+    LOG(DEBUG) << "Using " << (geometry_.has_value() ? "specialized rectangular pixel" : "generic detector model")
+               << " geometry for propagation";
+
     // Check multiplication and step size larger than a picosecond:
     if(!multiplication_.is<NoImpactIonization>() && timestep_ > 0.001) {
         LOG(WARNING) << "Charge multiplication enabled with maximum timestep larger than 1ps" << std::endl
@@ -396,6 +427,22 @@ void TransientPropagationModule::initialize() {
                                                      -model_->getSensorSize().z() / 2.,
                                                      model_->getSensorSize().z() / 2.);
         }
+
+        if(merge_charge_groups_) {
+            auto max_live_groups = (max_live_groups_ > 0 ? static_cast<int>(max_live_groups_) + 1 : 1000);
+            live_groups_histo_ = CreateHistogram<TH1D>(
+                "live_groups_histo",
+                "Sets of secondary charge carriers per generation;sets of charge carriers;generations",
+                std::min(max_live_groups, 1000),
+                0,
+                max_live_groups);
+            merged_groups_histo_ =
+                CreateHistogram<TH1D>("merged_groups_histo",
+                                      "Merged sets of secondary charge carriers per event;merged sets;events",
+                                      1000,
+                                      0,
+                                      10000);
+        }
     }
 }
 
@@ -408,6 +455,10 @@ void TransientPropagationModule::run(Event* event) {
     unsigned int recombined_charges_count = 0;
     unsigned int trapped_charges_count = 0;
 
+    // Queue of secondary charge carriers if they are merged before propagation
+    SecondaryQueue secondary_queue;
+    auto* secondaries = (merge_charge_groups_ ? &secondary_queue : nullptr);
+
     // List of points to plot to plot for output plots
     LineGraph::OutputPlotPoints output_plot_points;
 
@@ -447,16 +498,22 @@ void TransientPropagationModule::run(Event* event) {
             charges_remaining -= charge_per_step;
 
             // Get position and propagate through sensor
-            auto [recombined, trapped, propagated] = propagate(event,
-                                                               deposit,
-                                                               deposit.getLocalPosition(),
-                                                               deposit.getType(),
-                                                               charge_per_step,
-                                                               deposit.getLocalTime(),
-                                                               deposit.getGlobalTime(),
-                                                               0,
-                                                               propagated_charges,
-                                                               output_plot_points);
+            auto propagate_deposit = [&](const auto& geometry) {
+                return propagate(geometry,
+                                 event,
+                                 deposit,
+                                 deposit.getLocalPosition(),
+                                 deposit.getType(),
+                                 charge_per_step,
+                                 deposit.getLocalTime(),
+                                 deposit.getGlobalTime(),
+                                 0,
+                                 propagated_charges,
+                                 output_plot_points,
+                                 secondaries);
+            };
+            auto [recombined, trapped, propagated] =
+                (geometry_.has_value() ? propagate_deposit(geometry_.value()) : propagate_deposit(*model_));
 
             // Update statistics:
             recombined_charges_count += recombined;
@@ -467,6 +524,57 @@ void TransientPropagationModule::run(Event* event) {
         }
     }
 
+    // Propagate the queued secondary charge carriers one generation after the other
+    size_t max_generation_size = 0;
+    while(!secondary_queue.groups.empty()) {
+        std::vector<SecondaryGroup> generation;
+        generation.reserve(secondary_queue.groups.size());
+        for(const auto& [key, group] : secondary_queue.groups) {
+            generation.push_back(group);
+        }
+        secondary_queue.groups.clear();
+
+        if(max_live_groups_ > 0 && generation.size() > max_live_groups_) {
+            secondary_queue.merged += limit_live_groups(event, generation);
+        }
+        if(output_plots_) {
+            live_groups_histo_->Fill(static_cast<double>(generation.size()));
+        }
+        LOG(DEBUG) << "Propagating generation of " << generation.size() << " sets of secondary charge carriers";
+        max_generation_size = std::max(max_generation_size, generation.size());
+
+        for(const auto& group : generation) {
+            auto propagate_group = [&](const auto& geometry) {
+                return propagate(geometry,
+                                 event,
+                                 *group.deposit,
+                                 group.position,
+                                 group.type,
+                                 group.charge,
+                                 group.initial_time_local,
+                                 group.initial_time_global,
+                                 group.level,
+                                 propagated_charges,
+                                 output_plot_points,
+                                 secondaries);
+            };
+            auto [recombined, trapped, propagated] =
+                (geometry_.has_value() ? propagate_group(geometry_.value()) : propagate_group(*model_));
+
+            recombined_charges_count += recombined;
+            trapped_charges_count += trapped;
+            propagated_charges_count += propagated;
+        }
+    }
+    if(merge_charge_groups_) {
+        LOG(DEBUG) << "Merged " << secondary_queue.merged << " sets of secondary charge carriers, propagated at most "
+                   << max_generation_size << " sets per generation";
+        total_merged_groups_ += secondary_queue.merged;
+        if(output_plots_) {
+            merged_groups_histo_->Fill(static_cast<double>(secondary_queue.merged));
+        }
+    }
+
     // Output plots if required
     if(output_linegraphs_) {
         LineGraph::Create(event->number, this, config_, output_plot_points, CarrierState::UNKNOWN);
@@ -495,7 +603,7 @@ void TransientPropagationModule::run(Event* event) {
     }
 
     // Create a new message with propagated charges
-    auto propagated_charge_message = std::make_shared<PropagatedChargeMessage>(std::move(propagated_charges), detector_);
+    auto propagated_charge_message = event->makeShared<PropagatedChargeMessage>(std::move(propagated_charges), detector_);
 
     // Dispatch the message with propagated charges
     messenger_->dispatchMessage(this, std::move(propagated_charge_message), event);
@@ -506,8 +614,10 @@ void TransientPropagationModule::run(Event* event) {
  * velocity at every point with help of the electric field map of the detector. A Runge-Kutta integration is applied in
  * multiple steps, adding a random diffusion to the propagating charge every step.
  */
+template <typename Geometry>
 std::tuple<unsigned int, unsigned int, unsigned int>
-TransientPropagationModule::propagate(Event* event,
+TransientPropagationModule::propagate(const Geometry& geometry,
+                                      Event* event,
                                       const DepositedCharge& deposit,
                                       const ROOT::Math::XYZPoint& pos,
                                       const CarrierType& type,
@@ -516,7 +626,8 @@ TransientPropagationModule::propagate(Event* event,
                                       const double initial_time_global,
                                       const unsigned int level,
                                       std::vector<PropagatedCharge>& propagated_charges,
-                                      LineGraph::OutputPlotPoints& output_plot_points) const {
+                                      LineGraph::OutputPlotPoints& output_plot_points,
+                                      SecondaryQueue* secondaries) const {
 
     if(level > max_multiplication_level_) {
         LOG(WARNING) << "Found impact ionization shower with level larger than " << max_multiplication_level_
@@ -547,38 +658,25 @@ TransientPropagationModule::propagate(Event* event,
         double diffusion_std_dev = std::sqrt(2. * diffusion_constant * timestep);
 
         // Compute the independent diffusion in three
-        allpix::normal_distribution<double> gauss_distribution(0, diffusion_std_dev);
-        auto x = gauss_distribution(event->getRandomEngine());
-        auto y = gauss_distribution(event->getRandomEngine());
-        auto z = gauss_distribution(event->getRandomEngine());
-        return {x, y, z};
+        std::array<double, 3> diffusion{};
+        event->getRandomEngine().fillNormal(diffusion.data(), diffusion.size(), 0., diffusion_std_dev);
+        return {diffusion[0], diffusion[1], diffusion[2]};
     };
 
     // Survival probability of this charge carrier package, evaluated at every step
     allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
 
-    // Define lambda functions to compute the charge carrier velocity with or without magnetic field
-    std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_noB =
-        [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
-
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-
-        return static_cast<int>(type) * mobility_(type, efield.norm(), doping) * efield;
-    };
-
-    std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)> carrier_velocity_withB =
-        [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
-        auto raw_field = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-        Eigen::Vector3d efield(raw_field.x(), raw_field.y(), raw_field.z());
+    // Define a function to compute the charge carrier velocity with or without magnetic field
+    auto carrier_velocity = [&](double, const Eigen::Vector3d& cur_pos) -> Eigen::Vector3d {
+        auto fields = detector_->getFieldSample(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        Eigen::Vector3d efield(fields.electric_field.x(), fields.electric_field.y(), fields.electric_field.z());
 
-        auto magnetic_field = detector_->getMagneticField(static_cast<ROOT::Math::XYZPoint>(cur_pos));
-        Eigen::Vector3d bfield(magnetic_field.x(), magnetic_field.y(), magnetic_field.z());
-
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(cur_pos));
+        auto mob = mobility_(type, efield.norm(), fields.doping_concentration);
+        if(!has_magnetic_field_) {
+            return static_cast<int>(type) * mob * efield;
+        }
 
-        auto mob = mobility_(type, efield.norm(), doping);
+        Eigen::Vector3d bfield(fields.magnetic_field.x(), fields.magnetic_field.y(), fields.magnetic_field.z());
         auto exb = efield.cross(bfield);
 
         Eigen::Vector3d term1;
@@ -592,8 +690,7 @@ TransientPropagationModule::propagate(Event* event,
     };
 
     // Create the Runge-Kutta solver with an RK4 tableau, no error estimation required since we're not adapting step size
-    auto runge_kutta = make_runge_kutta(
-        tableau::RK4, (has_magnetic_field_ ? carrier_velocity_withB : carrier_velocity_noB), timestep_, position);
+    auto runge_kutta = make_runge_kutta(tableau::RK4, carrier_velocity, timestep_, position);
 
     // Continue propagation until the deposit is outside the sensor
     Eigen::Vector3d last_position = position;
@@ -612,9 +709,10 @@ TransientPropagationModule::propagate(Event* event,
             }
         }
 
-        // Get electric field at current (pre-step) position
-        efield = detector_->getElectricField(static_cast<ROOT::Math::XYZPoint>(position));
-        auto doping = detector_->getDopingConcentration(static_cast<ROOT::Math::XYZPoint>(position));
+        // Get electric field and doping concentration at current (pre-step) position
+        auto fields = detector_->getFieldSample(static_cast<ROOT::Math::XYZPoint>(position));
+        efield = fields.electric_field;
+        auto doping = fields.doping_concentration;
 
         // Execute a Runge-Kutta step
         auto step = runge_kutta.step();
@@ -627,9 +725,9 @@ TransientPropagationModule::propagate(Event* event,
         position += diffusion;
 
         // If charge carrier reaches implant, interpolate surface position for higher accuracy:
-        if(auto implant = model_->isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position))) {
+        if(auto implant = geometry.isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position))) {
             LOG(TRACE) << "Carrier in implant: " << Units::display(static_cast<ROOT::Math::XYZPoint>(position), {"nm"});
-            auto new_position = model_->getImplantIntercept(implant.value(),
+            auto new_position = model_->getImplantIntercept(*implant,
                                                             static_cast<ROOT::Math::XYZPoint>(last_position),
                                                             static_cast<ROOT::Math::XYZPoint>(position));
             position = Eigen::Vector3d(new_position.x(), new_position.y(), new_position.z());
@@ -637,7 +735,7 @@ TransientPropagationModule::propagate(Event* event,
         }
 
         // Check for overshooting outside the sensor and correct for it:
-        if(!model_->isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position))) {
+        if(!geometry.isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position))) {
             // Reflect off the sensor surface with a certain probability, otherwise halt motion:
             if(uniform_distribution(event->getRandomEngine()) > surface_reflectivity_) {
                 LOG(TRACE) << "Carrier outside sensor: "
@@ -657,13 +755,13 @@ TransientPropagationModule::propagate(Event* event,
                            << Units::display(static_cast<ROOT::Math::XYZPoint>(position), {"um", "nm"});
 
                 // Re-check if we ended in an implant - corner case.
-                if(model_->isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position))) {
+                if(geometry.isWithinImplant(static_cast<ROOT::Math::XYZPoint>(position))) {
                     LOG(TRACE) << "Ended in implant after reflection - halting";
                     state = CarrierState::HALTED;
                 }
 
                 // Re-check if we are within the sensor - reflection at sensor side walls:
-                if(!model_->isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position))) {
+                if(!geometry.isWithinSensor(static_cast<ROOT::Math::XYZPoint>(position))) {
                     position = Eigen::Vector3d(intercept.x(), intercept.y(), intercept.z());
                     state = CarrierState::HALTED;
                 }
@@ -744,24 +842,38 @@ TransientPropagationModule::propagate(Event* event,
                     multiplication_depth_histo_->Fill(carrier_pos.z(), n_secondaries);
                 }
 
-                auto [recombined, trapped, propagated] = propagate(event,
-                                                                   deposit,
-                                                                   carrier_pos,
-                                                                   inverted_type,
-                                                                   n_secondaries,
-                                                                   initial_time_local + runge_kutta.getTime(),
-                                                                   initial_time_global + runge_kutta.getTime(),
-                                                                   level + 1,
-                                                                   propagated_charges,
-                                                                   output_plot_points);
-
-                // Update statistics:
-                recombined_charges_count += recombined;
-                trapped_charges_count += trapped;
-                propagated_charges_count += propagated;
-
-                LOG(DEBUG) << "Continuing propagation of charge carrier set (" << type << ") at "
-                           << Units::display(carrier_pos, {"mm", "um"});
+                if(secondaries != nullptr) {
+                    // Queue the secondaries to be merged with co-located sets before they are propagated
+                    queue_secondaries(*secondaries,
+                                      {&deposit,
+                                       carrier_pos,
+                                       inverted_type,
+                                       n_secondaries,
+                                       initial_time_local + runge_kutta.getTime(),
+                                       initial_time_global + runge_kutta.getTime(),
+                                       level + 1});
+                } else {
+                    auto [recombined, trapped, propagated] = propagate(geometry,
+                                                                       event,
+                                                                       deposit,
+                                                                       carrier_pos,
+                                                                       inverted_type,
+                                                                       n_secondaries,
+                                                                       initial_time_local + runge_kutta.getTime(),
+                                                                       initial_time_global + runge_kutta.getTime(),
+                                                                       level + 1,
+                                                                       propagated_charges,
+                                                                       output_plot_points,
+                                                                       nullptr);
+
+                    // Update statistics:
+                    recombined_charges_count += recombined;
+                    trapped_charges_count += trapped;
+                    propagated_charges_count += propagated;
+
+                    LOG(DEBUG) << "Continuing propagation of charge carrier set (" << type << ") at "
+                               << Units::display(carrier_pos, {"mm", "um"});
+                }
             }
 
             auto gain = static_cast<double>(charge + n_secondaries) / initial_charge;
@@ -775,8 +887,8 @@ TransientPropagationModule::propagate(Event* event,
         // Signal calculation:
 
         // Find the nearest pixel - before and after the step
-        auto [xpixel, ypixel] = model_->getPixelIndex(static_cast<ROOT::Math::XYZPoint>(position));
-        auto [last_xpixel, last_ypixel] = model_->getPixelIndex(static_cast<ROOT::Math::XYZPoint>(last_position));
+        auto [xpixel, ypixel] = geometry.getPixelIndex(static_cast<ROOT::Math::XYZPoint>(position));
+        auto [last_xpixel, last_ypixel] = geometry.getPixelIndex(static_cast<ROOT::Math::XYZPoint>(last_position));
         auto idx = Pixel::Index(xpixel, ypixel);
         auto neighbors = model_->getNeighbors(idx, distance_);
 
@@ -815,8 +927,8 @@ TransientPropagationModule::propagate(Event* event,
             }
 
             if(output_plots_) {
-                auto inPixel_um_x = (position.x() - model_->getPixelCenter(xpixel, ypixel).x()) * 1e3;
-                auto inPixel_um_y = (position.y() - model_->getPixelCenter(xpixel, ypixel).y()) * 1e3;
+                auto inPixel_um_x = (position.x() - geometry.getPixelCenter(xpixel, ypixel).x()) * 1e3;
+                auto inPixel_um_y = (position.y() - geometry.getPixelCenter(xpixel, ypixel).y()) * 1e3;
 
                 potential_difference_->Fill(std::fabs(ramo - last_ramo));
                 induced_charge_histo_->Fill(initial_time_local + runge_kutta.getTime(), induced);
@@ -887,7 +999,7 @@ TransientPropagationModule::propagate(Event* event,
     // Set final state of charge carrier for plotting:
     if(output_linegraphs_) {
         // If drift time is larger than integration time or the charge carriers have been collected at the backside, reset:
-        if(runge_kutta.getTime() >= integration_time_ || last_position.z() < -model_->getSensorSize().z() * 0.45) {
+        if(runge_kutta.getTime() >= integration_time_ || last_position.z() < -geometry.getSensorSize().z() * 0.45) {
             std::get<3>(output_plot_points.at(output_plot_index).first) = CarrierState::UNKNOWN;
         } else {
             std::get<3>(output_plot_points.at(output_plot_index).first) = state;
@@ -934,9 +1046,88 @@ TransientPropagationModule::propagate(Event* event,
     return std::make_tuple(recombined_charges_count, trapped_charges_count, propagated_charges_count);
 }
 
+/**
+ * Sets of the same carrier type and level are merged if their positions fall into the same cell of a grid with the
+ * configured cell size and their start times into the same time bin. The merged set starts at the charge-weighted mean of
+ * the positions and times of its constituents, and refers to the deposit of the constituent with the largest charge.
+ */
+void TransientPropagationModule::queue_secondaries(SecondaryQueue& queue, const SecondaryGroup& group) const {
+    auto cell = [&](double coordinate, double size) { return static_cast<long>(std::floor(coordinate / size)); };
+    auto key = std::make_tuple(group.type,
+                               group.level,
+                               cell(group.initial_time_local, merging_time_bin_),
+                               cell(group.position.x(), merging_cell_size_),
+                               cell(group.position.y(), merging_cell_size_),
+                               cell(group.position.z(), merging_cell_size_));
+
+    auto [iterator, inserted] = queue.groups.emplace(key, group);
+    if(inserted) {
+        return;
+    }
+
+    auto& queued = iterator->second;
+    auto total = static_cast<double>(queued.charge) + group.charge;
+    auto queued_weight = queued.charge / total;
+    auto group_weight = group.charge / total;
+    queued.position = ROOT::Math::XYZPoint(queued_weight * queued.position.x() + group_weight * group.position.x(),
+                                           queued_weight * queued.position.y() + group_weight * group.position.y(),
+                                           queued_weight * queued.position.z() + group_weight * group.position.z());
+    queued.initial_time_local = queued_weight * queued.initial_time_local + group_weight * group.initial_time_local;
+    queued.initial_time_global = queued_weight * queued.initial_time_global + group_weight * group.initial_time_global;
+    if(group.charge > queued.charge) {
+        queued.deposit = group.deposit;
+    }
+    queued.charge += group.charge;
+    ++queue.merged;
+}
+
+unsigned int TransientPropagationModule::limit_live_groups(Event* event, std::vector<SecondaryGroup>& groups) const {
+    // Keep the sets of each carrier type in a heap with the smallest charge on top
+    auto larger_charge = [](const SecondaryGroup& lhs, const SecondaryGroup& rhs) { return lhs.charge > rhs.charge; };
+    std::array<std::vector<SecondaryGroup>, 2> heaps;
+    for(const auto& group : groups) {
+        (group.type == CarrierType::ELECTRON ? heaps[0] : heaps[1]).push_back(group);
+    }
+    for(auto& heap : heaps) {
+        std::make_heap(heap.begin(), heap.end(), larger_charge);
+    }
+
+    allpix::uniform_real_distribution<double> uniform_distribution(0, 1);
+    unsigned int merged = 0;
+    while(heaps[0].size() + heaps[1].size() > max_live_groups_) {
+        // Merge within the carrier type with more sets, sets of different type cannot be merged
+        auto& heap = (heaps[0].size() >= heaps[1].size() ? heaps[0] : heaps[1]);
+        if(heap.size() < 2) {
+            break;
+        }
+
+        std::pop_heap(heap.begin(), heap.end(), larger_charge);
+        auto first = heap.back();
+        heap.pop_back();
+        std::pop_heap(heap.begin(), heap.end(), larger_charge);
+        auto second = heap.back();
+        heap.pop_back();
+
+        // Keep one of the sets with a probability proportional to its charge, carrying the charge of both
+        auto total = first.charge + second.charge;
+        auto kept = (uniform_distribution(event->getRandomEngine()) * total < first.charge ? first : second);
+        kept.charge = total;
+        heap.push_back(kept);
+        std::push_heap(heap.begin(), heap.end(), larger_charge);
+        ++merged;
+    }
+
+    groups = std::move(heaps[0]);
+    groups.insert(groups.end(), heaps[1].begin(), heaps[1].end());
+    return merged;
+}
+
 void TransientPropagationModule::finalize() {
     LOG(INFO) << deposits_exceeding_max_groups_ * 100.0 / total_deposits_ << "% of deposits have charge exceeding the "
               << max_charge_groups_ << " charge groups allowed, with a charge_per_step value of " << charge_per_step_ << ".";
+    if(merge_charge_groups_) {
+        LOG(INFO) << "Merged total of " << total_merged_groups_ << " sets of secondary charge carriers";
+    }
     if(output_plots_) {
         group_size_histo_->Get()->GetXaxis()->SetRange(1, group_size_histo_->Get()->GetNbinsX() + 1);
 
@@ -979,5 +1170,9 @@ void TransientPropagationModule::finalize() {
             gain_h_vs_y_->Write();
             gain_h_vs_z_->Write();
         }
+        if(merge_charge_groups_) {
+            live_groups_histo_->Write();
+            merged_groups_histo_->Write();
+        }
     }
 }
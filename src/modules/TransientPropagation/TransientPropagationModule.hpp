@@ -9,7 +9,12 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include <atomic>
+#include <map>
+#include <optional>
 #include <string>
+#include <tuple>
+#include <vector>
 
 #include <Math/DisplacementVector2D.h>
 #include <Math/Point3D.h>
@@ -18,6 +23,7 @@
 
 #include "core/config/Configuration.hpp"
 #include "core/geometry/DetectorModel.hpp"
+#include "core/geometry/RectangularPixelGeometry.hpp"
 #include "core/messenger/Messenger.hpp"
 #include "core/module/Event.hpp"
 #include "core/module/Module.hpp"
@@ -77,8 +83,54 @@ namespace allpix {
         std::shared_ptr<const Detector> detector_;
         std::shared_ptr<DetectorModel> model_;
 
+        // Non-virtual geometry kernel used in the step loop if the detector model supports it
+        std::optional<RectangularPixelGeometry> geometry_;
+
+        /**
+         * @brief Set of secondary charge carriers from impact ionization waiting to be propagated
+         */
+        struct SecondaryGroup {
+            const DepositedCharge* deposit;
+            ROOT::Math::XYZPoint position;
+            CarrierType type;
+            unsigned int charge;
+            double initial_time_local;
+            double initial_time_global;
+            unsigned int level;
+        };
+
+        /**
+         * @brief Queue of secondary charge carriers, merging sets of the same type and level in the same grid cell
+         *
+         * The key consists of carrier type, level, time bin and the cell indices along x, y and z. The number of merged
+         * sets is counted for the statistics of the event.
+         */
+        struct SecondaryQueue {
+            std::map<std::tuple<CarrierType, unsigned int, long, long, long, long>, SecondaryGroup> groups;
+            unsigned int merged{};
+        };
+
+        /**
+         * @brief Add a set of secondary charge carriers to the queue, merging it with a queued set in the same grid cell
+         * @param queue Queue of secondary charge carriers of the current event
+         * @param group Set of secondary charge carriers to add
+         */
+        void queue_secondaries(SecondaryQueue& queue, const SecondaryGroup& group) const;
+
+        /**
+         * @brief Merge the smallest sets of charge carriers of the same type until the number of live sets is at its limit
+         * @param event  Pointer to current event
+         * @param groups Sets of charge carriers of one generation
+         * @return Number of merged sets
+         *
+         * Of two merged sets, one is kept with a probability proportional to its charge and carries the charge of both. This
+         * conserves the total charge and leaves the expected induced current unchanged.
+         */
+        unsigned int limit_live_groups(Event* event, std::vector<SecondaryGroup>& groups) const;
+
         /**
          * @brief Propagate a single set of charges through the sensor
+         * @param geometry            Geometry used for the sensor, implant and pixel lookups of every step
          * @param event               Pointer to current event
          * @param deposit             Reference to the original deposited charge object
          * @param pos                 Position of the deposit in the sensor
@@ -89,11 +141,14 @@ namespace allpix {
          * @param level               Current level depth of the generated shower
          * @param propagated_charges  Reference to vector with all produced final PropagatedCharge objects
          * @param output_plot_points Reference to vector to hold points for line graph output plots
+         * @param secondaries         Queue for secondary charge carriers, propagated recursively if a null pointer
          *
          * @return Total recombined, trapped and propagated charge for statistics purposes
          */
+        template <typename Geometry>
         std::tuple<unsigned int, unsigned int, unsigned int>
-        propagate(Event* event,
+        propagate(const Geometry& geometry,
+                  Event* event,
                   const DepositedCharge& deposit,
                   const ROOT::Math::XYZPoint& pos,
                   const CarrierType& type,
@@ -102,7 +157,8 @@ namespace allpix {
                   const double initial_time_global,
                   const unsigned int level,
                   std::vector<PropagatedCharge>& propagated_charges,
-                  LineGraph::OutputPlotPoints& output_plot_points) const;
+                  LineGraph::OutputPlotPoints& output_plot_points,
+                  SecondaryQueue* secondaries) const;
 
         // Local copies of configuration parameters to avoid costly lookup:
         double temperature_{}, timestep_{}, integration_time_{}, output_plots_step_{};
@@ -115,6 +171,11 @@ namespace allpix {
         unsigned int max_multiplication_level_{};
         unsigned int output_max_gain_histo_{};
 
+        // Merging of secondary charge carriers
+        bool merge_charge_groups_{};
+        double merging_cell_size_{}, merging_time_bin_{};
+        unsigned int max_live_groups_{};
+
         // Models for electron and hole mobility and lifetime
         Mobility mobility_;
         Recombination recombination_;
@@ -137,6 +198,7 @@ namespace allpix {
 
         // Deposit statistics
         std::atomic<unsigned int> total_deposits_{}, deposits_exceeding_max_groups_{};
+        std::atomic<unsigned int> total_merged_groups_{};
 
         // Output plots
         Histogram<TH1D> potential_difference_, induced_charge_histo_, induced_charge_e_histo_, induced_charge_h_histo_;
@@ -160,5 +222,6 @@ namespace allpix {
         Histogram<TH1D> induced_charge_primary_histo_, induced_charge_primary_e_histo_, induced_charge_primary_h_histo_;
         Histogram<TH1D> induced_charge_secondary_histo_, induced_charge_secondary_e_histo_,
             induced_charge_secondary_h_histo_;
+        Histogram<TH1D> live_groups_histo_, merged_groups_histo_;
     };
 } // namespace allpix
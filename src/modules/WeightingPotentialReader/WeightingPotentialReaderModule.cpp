@@ -62,7 +62,18 @@ void WeightingPotentialReaderModule::initialize() {
                 config_, "field_mapping", "the weighting potential needs to be centered around an electrode");
         }
         LOG(DEBUG) << "Weighting potential maps to " << magic_enum::enum_name(field_mapping);
-        auto field_data = read_field();
+
+        // Read interpolation between the field bins
+        auto interpolation = config_.get<FieldInterpolation>("interpolation", FieldInterpolation::NEAREST);
+        LOG(DEBUG) << "Weighting potential uses " << magic_enum::enum_name(interpolation) << " interpolation";
+
+        // Read memory layout of the field grid
+        auto layout = config_.get<FieldLayout>("field_layout", FieldLayout::FLAT);
+        LOG(DEBUG) << "Weighting potential is stored in " << magic_enum::enum_name(layout) << " layout";
+
+        // Read precision in which the field grid is stored
+        auto precision = config_.get<FieldPrecision>("field_precision", FieldPrecision::DOUBLE);
+        LOG(DEBUG) << "Weighting potential is stored in " << magic_enum::enum_name(precision) << " precision";
 
         // By default, set field scale from physical extent read from field file:
         std::array<double, 2> field_scale{{1.0, 1.0}};
@@ -74,14 +85,24 @@ void WeightingPotentialReaderModule::initialize() {
             field_scale = {{scales.x(), scales.y()}};
         }
 
-        // Set the field grid, provide scale factors as fraction of the pixel pitch for correct scaling:
-        detector_->setWeightingPotentialGrid(field_data.getData(),
-                                             field_data.getDimensions(),
-                                             field_data.getSize(),
-                                             field_mapping,
-                                             field_scale,
-                                             {0.0, 0.0},
-                                             thickness_domain);
+        // Read the field in the requested precision and set the field grid, provide scale factors as fraction of the pixel
+        // pitch for correct scaling:
+        auto set_field_grid = [&](const auto& field_data) {
+            detector_->setWeightingPotentialGrid(field_data.getData(),
+                                                 field_data.getDimensions(),
+                                                 field_data.getSize(),
+                                                 field_mapping,
+                                                 field_scale,
+                                                 {0.0, 0.0},
+                                                 thickness_domain,
+                                                 interpolation,
+                                                 layout);
+        };
+        if(precision == FieldPrecision::FLOAT) {
+            set_field_grid(read_field(float_field_parser_));
+        } else {
+            set_field_grid(read_field(field_parser_));
+        }
     } else if(field_model == WeightingPotential::PAD) {
         LOG(TRACE) << "Adding weighting potential from pad in plane condenser";
 
@@ -267,14 +288,15 @@ void WeightingPotentialReaderModule::create_output_plots() {
  * using the static FieldParser's getByFileName method.
  */
 FieldParser<double> WeightingPotentialReaderModule::field_parser_(FieldQuantity::SCALAR);
-FieldData<double> WeightingPotentialReaderModule::read_field() {
+FieldParser<float> WeightingPotentialReaderModule::float_field_parser_(FieldQuantity::SCALAR);
+template <typename T> FieldData<T> WeightingPotentialReaderModule::read_field(FieldParser<T>& field_parser) {
     using namespace ROOT::Math;
 
     try {
         LOG(TRACE) << "Fetching weighting potential from init file";
 
         // Get field from file
-        auto field_data = field_parser_.getByFileName(config_.getPath("file_name", true));
+        auto field_data = field_parser.getByFileName(config_.getPath("file_name", true));
 
         // Check maximum/minimum values of the potential:
         auto elements = std::minmax_element(field_data.getData()->begin(), field_data.getData()->end());
@@ -304,6 +326,7 @@ FieldData<double> WeightingPotentialReaderModule::read_field() {
 
         LOG(INFO) << "Set weighting field with " << field_data.getDimensions()[0] << "x" << field_data.getDimensions()[1]
                   << "x" << field_data.getDimensions()[2] << " cells";
+        LOG(DEBUG) << "Weighting field occupies " << field_data.getData()->size() * sizeof(T) / 1024 << " kB of memory";
 
         // Return the field data
         return field_data;
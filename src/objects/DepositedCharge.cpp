@@ -39,6 +39,8 @@ const MCParticle* DepositedCharge::getMCParticle() const {
     return mc_particle;
 }
 
+bool DepositedCharge::hasMCParticle() const { return mc_particle_.get() != nullptr; }
+
 void DepositedCharge::setMCParticle(const MCParticle* mc_particle) {
     mc_particle_ = PointerWrapper<MCParticle>(mc_particle);
 }
@@ -50,6 +50,12 @@ namespace allpix {
          */
         const MCParticle* getMCParticle() const;
 
+        /**
+         * @brief Check if the related Monte-Carlo particle is available
+         * @return True if the deposit refers to a Monte-Carlo particle, false otherwise
+         */
+        bool hasMCParticle() const;
+
         /**
          * @brief Set the Monte-Carlo particle
          * @param mc_particle The Monte-Carlo particle
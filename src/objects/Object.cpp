@@ -13,6 +13,12 @@
 
 using namespace allpix;
 
+HistoryMode Object::history_mode_ = HistoryMode::FULL;
+
+void Object::setHistoryMode(HistoryMode mode) { history_mode_ = mode; }
+
+HistoryMode Object::getHistoryMode() { return history_mode_; }
+
 std::ostream& allpix::operator<<(std::ostream& out, const Object& obj) {
     obj.print(out);
     return out;
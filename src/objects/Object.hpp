@@ -27,6 +27,16 @@
 namespace allpix {
     template <typename T> class Message;
 
+    /**
+     * @ingroup Objects
+     * @brief Relations between objects which are kept when creating new objects, ordered by the amount of history
+     */
+    enum class HistoryMode {
+        NONE = 0,  ///< Only the relations required to derive properties of new objects, such as their reference times
+        PARTICLES, ///< Additionally the Monte-Carlo particles all objects originate from
+        FULL,      ///< All relations between objects, required to store the history of objects
+    };
+
     /**
      * @ingroup Objects
      * @brief Base class for internal objects
@@ -79,6 +89,19 @@ namespace allpix {
             this->SetBit(1ull << 14);
         }
 
+        /**
+         * @brief Set the relations to keep when creating new objects
+         * @param mode Mode of the history of objects
+         * @warning Should only be changed before objects are created, i.e. not while events are processed
+         */
+        static void setHistoryMode(HistoryMode mode);
+
+        /**
+         * @brief Get the relations kept when creating new objects
+         * @return Mode of the history of objects, defaults to \ref HistoryMode::FULL
+         */
+        static HistoryMode getHistoryMode();
+
     protected:
         /**
          * @brief Print an ASCII representation of this Object to the given stream
@@ -95,6 +118,16 @@ namespace allpix {
             std::cout << std::endl;
         }
 
+        /**
+         * @brief Check if relations of a certain kind should be kept for new objects
+         * @param mode Minimal mode of the history required for the relation
+         * @return True if the relation should be stored
+         */
+        static bool keep_history(HistoryMode mode) { return history_mode_ >= mode; }
+
+    private:
+        static HistoryMode history_mode_; //! transient value
+
     public:
         template <class T> class BaseWrapper {
         public:
@@ -21,19 +21,48 @@ PixelCharge::PixelCharge(Pixel pixel, long charge, const std::vector<const Propa
     // Unique set of MC particles
     std::set<const MCParticle*> unique_particles;
     // Store all propagated charges and their MC particles
+    auto keep_propagated_charges = keep_history(HistoryMode::FULL);
     for(const auto& propagated_charge : propagated_charges) {
-        propagated_charges_.emplace_back(propagated_charge);
+        if(keep_propagated_charges) {
+            propagated_charges_.emplace_back(propagated_charge);
+        }
         unique_particles.insert(propagated_charge->mc_particle_.get());
     }
-    // Store the MC particle references
-    for(const auto& mc_particle : unique_particles) {
+    set_mc_particles(unique_particles);
+
+    // No pulse provided, set full charge in first bin:
+    pulse_.addCharge(static_cast<double>(charge), 0);
+}
+
+PixelCharge::PixelCharge(Pixel pixel,
+                         long charge,
+                         const std::vector<const PropagatedCharge*>& propagated_charges,
+                         const std::set<const MCParticle*>& mc_particles)
+    : pixel_(std::move(pixel)), charge_(charge) {
+    if(keep_history(HistoryMode::FULL)) {
+        for(const auto& propagated_charge : propagated_charges) {
+            propagated_charges_.emplace_back(propagated_charge);
+        }
+    }
+    set_mc_particles(mc_particles);
+
+    // No pulse provided, set full charge in first bin:
+    pulse_.addCharge(static_cast<double>(charge), 0);
+}
+
+void PixelCharge::set_mc_particles(const std::set<const MCParticle*>& mc_particles) {
+    // Store the MC particle references, the reference time is derived from them regardless of the history mode
+    auto keep_mc_particles = keep_history(HistoryMode::PARTICLES);
+    for(const auto& mc_particle : mc_particles) {
         // Local and global time are set as the earliest time found among the MCParticles:
         if(mc_particle != nullptr) {
             const auto* primary = mc_particle->getPrimary();
             local_time_ = std::min(local_time_, primary->getLocalTime());
             global_time_ = std::min(global_time_, primary->getGlobalTime());
         }
-        mc_particles_.emplace_back(mc_particle);
+        if(keep_mc_particles) {
+            mc_particles_.emplace_back(mc_particle);
+        }
     }
 
     // If no appropriate reference time has been found, set them to zero:
@@ -43,9 +72,6 @@ PixelCharge::PixelCharge(Pixel pixel, long charge, const std::vector<const Propa
     if(global_time_ > std::numeric_limits<double>::max()) {
         global_time_ = 0.;
     }
-
-    // No pulse provided, set full charge in first bin:
-    pulse_.addCharge(static_cast<double>(charge), 0);
 }
 
 // WARNING PixelCharge always returns a positive "collected" charge...
@@ -15,6 +15,7 @@
 #include <Math/DisplacementVector2D.h>
 #include <TRef.h>
 #include <algorithm>
+#include <set>
 
 #include "MCParticle.hpp"
 #include "Object.hpp"
@@ -52,6 +53,21 @@ namespace allpix {
                     Pulse pulse,
                     const std::vector<const PropagatedCharge*>& propagated_charges = std::vector<const PropagatedCharge*>());
 
+        /**
+         * @brief Construct a set of charges at a pixel with explicitly given Monte-Carlo particles
+         * @param pixel Object holding the information of the pixel
+         * @param charge Amount of charge stored at this pixel
+         * @param propagated_charges Pointers to the related propagated charges, may be empty
+         * @param mc_particles Monte-Carlo particles the charges originate from
+         *
+         * Keeps the Monte-Carlo truth if the propagated charges are not available as objects, e.g. when received as
+         * \ref PropagatedChargeArray without any module requesting the objects.
+         */
+        PixelCharge(Pixel pixel,
+                    long charge,
+                    const std::vector<const PropagatedCharge*>& propagated_charges,
+                    const std::set<const MCParticle*>& mc_particles);
+
         /**
          * @brief Get the pixel containing the charges
          * @return Pixel indices in the grid
@@ -141,6 +157,12 @@ namespace allpix {
 
         std::vector<PointerWrapper<PropagatedCharge>> propagated_charges_;
         std::vector<PointerWrapper<MCParticle>> mc_particles_;
+
+        /**
+         * @brief Store the Monte-Carlo particles and take the earliest time of their primaries as reference time
+         * @param mc_particles Unique set of Monte-Carlo particles
+         */
+        void set_mc_particles(const std::set<const MCParticle*>& mc_particles);
     };
 
     /**
@@ -27,9 +27,11 @@ PixelHit::PixelHit(Pixel pixel,
                    const PixelPulse* pixel_pulse)
     : pixel_(std::move(pixel)), local_time_(local_time), global_time_(global_time), signal_(signal) {
 
-    pixel_pulse_ = PointerWrapper<PixelPulse>(pixel_pulse);
-    pixel_charge_ = PointerWrapper<PixelCharge>(pixel_charge);
-    if(pixel_charge != nullptr) {
+    // Relations to the pixel charge and pulse are only kept for the full history
+    auto keep_relations = keep_history(HistoryMode::FULL);
+    pixel_pulse_ = PointerWrapper<PixelPulse>(keep_relations ? pixel_pulse : nullptr);
+    pixel_charge_ = PointerWrapper<PixelCharge>(keep_relations ? pixel_charge : nullptr);
+    if(pixel_charge != nullptr && keep_history(HistoryMode::PARTICLES)) {
         // Get the unique set of MC particles
         std::set<const MCParticle*> unique_particles;
         for(const auto& mc_particle : pixel_charge->mc_particles_) {
@@ -22,7 +22,8 @@ using namespace allpix;
 PixelPulse::PixelPulse(Pixel pixel, const Pulse& pulse, const PixelCharge* pixel_charge)
     : Pulse(pulse), pixel_(std::move(pixel)) {
 
-    pixel_charge_ = PointerWrapper<PixelCharge>(pixel_charge);
+    // The relation to the pixel charge is only kept for the full history
+    pixel_charge_ = PointerWrapper<PixelCharge>(keep_history(HistoryMode::FULL) ? pixel_charge : nullptr);
     if(pixel_charge != nullptr) {
         // Set time reference:
         local_time_ = pixel_charge->getLocalTime();
@@ -34,8 +35,10 @@ PixelPulse::PixelPulse(Pixel pixel, const Pulse& pulse, const PixelCharge* pixel
             unique_particles.insert(mc_particle.get());
         }
         // Store the MC particle references
-        for(const auto& mc_particle : unique_particles) {
-            mc_particles_.emplace_back(mc_particle);
+        if(keep_history(HistoryMode::PARTICLES)) {
+            for(const auto& mc_particle : unique_particles) {
+                mc_particles_.emplace_back(mc_particle);
+            }
         }
     }
 }
@@ -28,7 +28,8 @@ PropagatedCharge::PropagatedCharge(ROOT::Math::XYZPoint local_position,
                                    const DepositedCharge* deposited_charge)
     : SensorCharge(std::move(local_position), std::move(global_position), type, charge, local_time, global_time),
       state_(state) {
-    deposited_charge_ = PointerWrapper<DepositedCharge>(deposited_charge);
+    // The relation to the deposited charge is only kept for the full history
+    deposited_charge_ = PointerWrapper<DepositedCharge>(keep_history(HistoryMode::FULL) ? deposited_charge : nullptr);
     if(deposited_charge != nullptr) {
         mc_particle_ = deposited_charge->mc_particle_;
     }
@@ -86,6 +87,8 @@ const MCParticle* PropagatedCharge::getMCParticle() const {
 
 std::map<Pixel::Index, Pulse> PropagatedCharge::getPulses() const { return pulses_; }
 
+bool PropagatedCharge::hasPulses() const { return !pulses_.empty(); }
+
 CarrierState PropagatedCharge::getState() const { return state_; }
 
 void PropagatedCharge::print(std::ostream& out) const {
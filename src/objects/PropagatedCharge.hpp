@@ -99,6 +99,12 @@ namespace allpix {
          */
         std::map<Pixel::Index, Pulse> getPulses() const;
 
+        /**
+         * @brief Check if pulses induced by this charge carrier are available, without copying them
+         * @return True if at least one pulse is stored
+         */
+        bool hasPulses() const;
+
         /**
          * @brief Get state of the charge carrier
          * @return Charge carrier state
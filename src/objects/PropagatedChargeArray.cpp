@@ -0,0 +1,68 @@
+/**
+ * @file
+ * @brief Implementation of compact storage for propagated charges
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "PropagatedChargeArray.hpp"
+
+using namespace allpix;
+
+void PropagatedChargeArray::reserve(size_t size) {
+    local_x_.reserve(size);
+    local_y_.reserve(size);
+    local_z_.reserve(size);
+    global_x_.reserve(size);
+    global_y_.reserve(size);
+    global_z_.reserve(size);
+    local_time_.reserve(size);
+    global_time_.reserve(size);
+    charge_.reserve(size);
+    parent_.reserve(size);
+    type_.reserve(size);
+    state_.reserve(size);
+}
+
+void PropagatedChargeArray::push_back(const ROOT::Math::XYZPoint& local_position,
+                                      const ROOT::Math::XYZPoint& global_position,
+                                      CarrierType type,
+                                      unsigned int charge,
+                                      double local_time,
+                                      double global_time,
+                                      CarrierState state,
+                                      uint32_t parent) {
+    local_x_.push_back(local_position.x());
+    local_y_.push_back(local_position.y());
+    local_z_.push_back(local_position.z());
+    global_x_.push_back(global_position.x());
+    global_y_.push_back(global_position.y());
+    global_z_.push_back(global_position.z());
+    local_time_.push_back(local_time);
+    global_time_.push_back(global_time);
+    charge_.push_back(charge);
+    parent_.push_back(parent);
+    type_.push_back(type);
+    state_.push_back(state);
+}
+
+std::vector<PropagatedCharge> PropagatedChargeArray::materialize(const std::vector<DepositedCharge>& deposits) const {
+    std::vector<PropagatedCharge> propagated_charges;
+    propagated_charges.reserve(size());
+    for(size_t n = 0; n < size(); ++n) {
+        const auto* deposit = (parent_[n] < deposits.size() ? &deposits[parent_[n]] : nullptr);
+        propagated_charges.emplace_back(getLocalPosition(n),
+                                        getGlobalPosition(n),
+                                        type_[n],
+                                        charge_[n],
+                                        local_time_[n],
+                                        global_time_[n],
+                                        state_[n],
+                                        deposit);
+    }
+    return propagated_charges;
+}
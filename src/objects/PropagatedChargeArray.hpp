@@ -0,0 +1,288 @@
+/**
+ * @file
+ * @brief Definition of compact storage for propagated charges and the message to transport it
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef ALLPIX_PROPAGATED_CHARGE_ARRAY_H
+#define ALLPIX_PROPAGATED_CHARGE_ARRAY_H
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include <Math/Point3D.h>
+
+#include "core/messenger/Message.hpp"
+#include "core/messenger/exceptions.h"
+
+#include "DepositedCharge.hpp"
+#include "PropagatedCharge.hpp"
+
+namespace allpix {
+    /**
+     * @brief Compact storage of sets of propagated charges as structure of arrays
+     *
+     * Every property of the propagated charges is stored in a separate array, and the deposited charge a set of charges
+     * originates from is referenced by its position in the list of deposited charges. Each entry only occupies about a
+     * third of the memory of a \ref PropagatedCharge object and can be processed without touching unrelated properties.
+     * The container is not a ROOT object, \ref materialize creates the equivalent objects when they are needed.
+     */
+    class PropagatedChargeArray {
+    public:
+        /**
+         * @brief Parent value of entries without related deposited charge
+         */
+        static constexpr uint32_t no_parent = std::numeric_limits<uint32_t>::max();
+
+        /**
+         * @brief Reserve memory for a number of entries
+         * @param size Expected number of entries
+         */
+        void reserve(size_t size);
+
+        /**
+         * @brief Add a set of propagated charges
+         * @param local_position Local position of the propagated set of charges in the sensor
+         * @param global_position Global position of the propagated set of charges in the sensor
+         * @param type Type of the propagated carriers
+         * @param charge Total charge propagated
+         * @param local_time Time of propagation arrival after energy deposition, local reference frame
+         * @param global_time Total time of propagation arrival after event start, global reference frame
+         * @param state State of the charge carrier when reaching its position
+         * @param parent Position of the related deposited charge in its message or \ref no_parent
+         */
+        void push_back(const ROOT::Math::XYZPoint& local_position,
+                       const ROOT::Math::XYZPoint& global_position,
+                       CarrierType type,
+                       unsigned int charge,
+                       double local_time,
+                       double global_time,
+                       CarrierState state,
+                       uint32_t parent = no_parent);
+
+        /**
+         * @brief Get the number of stored sets of charges
+         * @return Number of entries
+         */
+        size_t size() const { return charge_.size(); }
+
+        /**
+         * @brief Check if no sets of charges are stored
+         * @return True if the container is empty
+         */
+        bool empty() const { return charge_.empty(); }
+
+        /**
+         * @brief Get the local position of an entry
+         * @param n Position of the entry
+         * @return Local position of the set of charges
+         */
+        ROOT::Math::XYZPoint getLocalPosition(size_t n) const { return {local_x_[n], local_y_[n], local_z_[n]}; }
+
+        /**
+         * @brief Get the global position of an entry
+         * @param n Position of the entry
+         * @return Global position of the set of charges
+         */
+        ROOT::Math::XYZPoint getGlobalPosition(size_t n) const { return {global_x_[n], global_y_[n], global_z_[n]}; }
+
+        /**
+         * @brief Get the carrier type of an entry
+         * @param n Position of the entry
+         * @return Type of the charge carriers
+         */
+        CarrierType getType(size_t n) const { return type_[n]; }
+
+        /**
+         * @brief Get the charge of an entry
+         * @param n Position of the entry
+         * @return Number of charges in the set
+         */
+        unsigned int getCharge(size_t n) const { return charge_[n]; }
+
+        /**
+         * @brief Get the signed charge of an entry
+         * @param n Position of the entry
+         * @return Charge of the set including the sign of the carriers
+         */
+        long getSignedCharge(size_t n) const { return static_cast<int>(type_[n]) * static_cast<long>(charge_[n]); }
+
+        /**
+         * @brief Get the local arrival time of an entry
+         * @param n Position of the entry
+         * @return Time after energy deposition in local reference frame
+         */
+        double getLocalTime(size_t n) const { return local_time_[n]; }
+
+        /**
+         * @brief Get the global arrival time of an entry
+         * @param n Position of the entry
+         * @return Time after event start in global reference frame
+         */
+        double getGlobalTime(size_t n) const { return global_time_[n]; }
+
+        /**
+         * @brief Get the final state of an entry
+         * @param n Position of the entry
+         * @return State of the charge carriers
+         */
+        CarrierState getState(size_t n) const { return state_[n]; }
+
+        /**
+         * @brief Get the related deposited charge of an entry
+         * @param n Position of the entry
+         * @return Position of the deposited charge in its message or \ref no_parent
+         */
+        uint32_t getParent(size_t n) const { return parent_[n]; }
+
+        /**
+         * @brief Create the propagated charge objects of all entries
+         * @param deposits Deposited charges the parents of the entries refer to
+         * @return List of propagated charges in the order of the entries
+         */
+        std::vector<PropagatedCharge> materialize(const std::vector<DepositedCharge>& deposits) const;
+
+    private:
+        std::vector<double> local_x_;
+        std::vector<double> local_y_;
+        std::vector<double> local_z_;
+        std::vector<double> global_x_;
+        std::vector<double> global_y_;
+        std::vector<double> global_z_;
+        std::vector<double> local_time_;
+        std::vector<double> global_time_;
+        std::vector<unsigned int> charge_;
+        std::vector<uint32_t> parent_;
+        std::vector<CarrierType> type_;
+        std::vector<CarrierState> state_;
+    };
+
+    /**
+     * @brief Message transporting propagated charges in compact storage
+     *
+     * The message keeps the deposited charges referenced by its entries alive. Receivers only interested in the properties
+     * of the charges, such as transfer modules, read the arrays directly. The \ref PropagatedCharge objects are only
+     * created on the first request, for example by a writer module storing them, and are then shared by all receivers.
+     */
+    class PropagatedChargeArrayMessage : public BaseMessage {
+    public:
+        /**
+         * @brief Entries of the array grouped by the pixel nearest to their local position
+         */
+        using PixelGroups = allpix::PixelGroups<uint32_t>;
+
+        /**
+         * @brief Construct the message
+         * @param data Compact storage of the propagated charges
+         * @param deposits Message with the deposited charges the entries refer to, may be empty
+         * @param detector Linked detector
+         */
+        PropagatedChargeArrayMessage(PropagatedChargeArray data,
+                                     std::shared_ptr<const DepositedChargeMessage> deposits,
+                                     std::shared_ptr<const Detector> detector)
+            : BaseMessage(std::move(detector)), data_(std::move(data)), deposits_(std::move(deposits)) {}
+
+        /**
+         * @brief Get the compact storage of the propagated charges
+         * @return Array of propagated charges
+         */
+        const PropagatedChargeArray& getData() const { return data_; }
+
+        /**
+         * @brief Get the deposited charge related to an entry
+         * @param n Position of the entry
+         * @return Pointer to the deposited charge or a null pointer if not available
+         */
+        const DepositedCharge* getDepositedCharge(size_t n) const {
+            auto parent = data_.getParent(n);
+            return (deposits_ == nullptr || parent == PropagatedChargeArray::no_parent) ? nullptr
+                                                                                         : &deposits_->getData()[parent];
+        }
+
+        /**
+         * @brief Get the Monte-Carlo particle related to an entry
+         * @param n Position of the entry
+         * @return Pointer to the Monte-Carlo particle or a null pointer if not available
+         */
+        const MCParticle* getMCParticle(size_t n) const {
+            const auto* deposit = getDepositedCharge(n);
+            return (deposit == nullptr || !deposit->hasMCParticle()) ? nullptr : deposit->getMCParticle();
+        }
+
+        /**
+         * @brief Check if the propagated charge objects have already been created
+         * @return True if \ref getMessage has been called before
+         */
+        bool isMaterialized() const { return materialized_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Get a message with the propagated charge objects equivalent to the entries of this message
+         * @return Message of propagated charges, created on the first call
+         */
+        std::shared_ptr<PropagatedChargeMessage> getMessage() {
+            std::call_once(materialize_flag_, [this]() {
+                // Parents need to refer to the deposits of the message, not to a copy of them
+                auto propagated_charges =
+                    (deposits_ == nullptr ? data_.materialize({}) : data_.materialize(deposits_->getData()));
+                objects_ = std::make_shared<PropagatedChargeMessage>(std::move(propagated_charges), getDetector());
+                materialized_.store(true, std::memory_order_release);
+            });
+            return objects_;
+        }
+
+        /**
+         * @brief Get the entries grouped by the pixel nearest to their local position
+         * @return Groups of entries, built on the first call and shared by all receivers
+         * @throws MessageWithoutDetectorException If the message is not bound to a detector
+         */
+        const PixelGroups& getPixelGroups() const {
+            std::call_once(pixel_groups_flag_, [this]() {
+                auto detector = getDetector();
+                if(detector == nullptr) {
+                    throw MessageWithoutDetectorException(typeid(*this));
+                }
+                pixel_groups_ = group_by_pixel<uint32_t>(*detector->getModel(), data_.size(), [this](size_t n) {
+                    return std::make_pair(data_.getLocalPosition(n), static_cast<uint32_t>(n));
+                });
+            });
+            return pixel_groups_;
+        }
+
+        /**
+         * @brief Get the propagated charges as objects, creating them if necessary
+         * @return List of object references
+         */
+        std::vector<std::reference_wrapper<Object>> getObjectArray() override { return getMessage()->getObjectArray(); }
+
+        /**
+         * @brief Get the type of the objects provided by this message without creating them
+         * @return Type information of \ref PropagatedCharge
+         */
+        const std::type_info& getObjectType() const override { return typeid(PropagatedCharge); }
+
+    private:
+        PropagatedChargeArray data_;
+        std::shared_ptr<const DepositedChargeMessage> deposits_;
+
+        // Propagated charge objects, only created on request
+        std::once_flag materialize_flag_;
+        std::atomic<bool> materialized_{false};
+        std::shared_ptr<PropagatedChargeMessage> objects_;
+
+        // Entries grouped by pixel, only built on request
+        mutable std::once_flag pixel_groups_flag_;
+        mutable PixelGroups pixel_groups_;
+    };
+} // namespace allpix
+
+#endif /* ALLPIX_PROPAGATED_CHARGE_ARRAY_H */
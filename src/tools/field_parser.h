@@ -18,6 +18,7 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <type_traits>
 
 #include "core/utils/log.h"
 #include "core/utils/unit.h"
@@ -45,6 +46,14 @@ namespace allpix {
         MAP = 25,    ///< Field with a 5x5 map for each entry
     };
 
+    /**
+     * @brief Precision in which field data is stored in memory
+     */
+    enum class FieldPrecision {
+        DOUBLE = 0, ///< Double-precision floating point values
+        FLOAT,      ///< Single-precision floating point values, using half of the memory
+    };
+
     /**
      * @brief Type of file formats
      */
@@ -59,6 +68,8 @@ namespace allpix {
      * * The actual field data as shared pointer to vector
      * * An array specifying the number of bins in each dimension
      * * An array containing the physical extent of the field in each dimension, as specified in the file
+     *
+     * The physical extent is always stored in double precision, independent of the precision of the field data.
      */
     template <typename T = double> class FieldData {
     public:
@@ -77,7 +88,7 @@ namespace allpix {
          */
         FieldData(std::string header,
                   std::array<size_t, 3> dimensions,
-                  std::array<T, 3> size,
+                  std::array<double, 3> size,
                   std::shared_ptr<std::vector<T>> data,
                   double norm = 1.)
             : header_(std::move(header)), dimensions_(dimensions), size_(size), data_(std::move(data)), norm_(norm){};
@@ -98,7 +109,7 @@ namespace allpix {
          * @brief Member to get the physical extent of the field in each dimension as parsed from the input in internal units
          * @return array with physical size in x, y and z
          */
-        std::array<T, 3> getSize() const { return size_; }
+        std::array<double, 3> getSize() const { return size_; }
 
         /**
          * @brief Member to access the actual field data
@@ -127,7 +138,7 @@ namespace allpix {
     private:
         std::string header_;
         std::array<size_t, 3> dimensions_{};
-        std::array<T, 3> size_{};
+        std::array<double, 3> size_{};
         std::shared_ptr<std::vector<T>> data_;
         double norm_{1.};
 
@@ -271,12 +282,13 @@ namespace allpix {
         /**
          * @brief Function to deserialize FieldData from an APF file, using the cereal library. This does not convert any
          * units, i.e. all values stored in APF files are given framework-internal base units. This includes the field data
-         * itself as well as the field size.
+         * itself as well as the field size. APF files store the field data in double precision, it is converted to the
+         * precision of the parser after reading.
          * @param file_name  File name (as canonical path) of the input file to be parsed
          */
         FieldData<T> parse_apf_file(const std::filesystem::path& file_name) {
             std::ifstream file(file_name, std::ios::binary);
-            FieldData<T> field_data;
+            FieldData<double> field_data;
 
             // Parse the file with cereal, scope ensures flushing:
             try {
@@ -292,7 +304,17 @@ namespace allpix {
                 throw std::runtime_error("invalid data");
             }
 
-            return field_data;
+            if constexpr(std::is_same_v<T, double>) {
+                return field_data;
+            } else {
+                auto data = std::make_shared<std::vector<T>>(field_data.getData()->size());
+                std::transform(field_data.getData()->begin(),
+                               field_data.getData()->end(),
+                               data->begin(),
+                               [](double value) { return static_cast<T>(value); });
+                return FieldData<T>(
+                    field_data.getHeader(), dimensions, field_data.getSize(), std::move(data), field_data.getNorm());
+            }
         }
 
         /**
@@ -360,7 +382,7 @@ namespace allpix {
             if(file.fail()) {
                 throw std::runtime_error("invalid data or unexpected end of file");
             }
-            auto field = std::make_shared<std::vector<double>>();
+            auto field = std::make_shared<std::vector<T>>();
             auto vertices = xsize * ysize * zsize;
             field->resize(vertices * N_);
 
@@ -391,14 +413,15 @@ namespace allpix {
                     file >> input;
 
                     // Set the field at a position
-                    (*field)[xind * ysize * zsize * N_ + yind * zsize * N_ + zind * N_ + j] = Units::get(input, units);
+                    (*field)[xind * ysize * zsize * N_ + yind * zsize * N_ + zind * N_ + j] =
+                        static_cast<T>(Units::get(input, units));
                 }
             }
             LOG_PROGRESS(INFO, "read_init") << "Reading field data: finished.";
 
             return FieldData<T>(header,
                                 std::array<size_t, 3>{{xsize, ysize, zsize}},
-                                std::array<T, 3>{{xpixsz, ypixsz, thickness}},
+                                std::array<double, 3>{{xpixsz, ypixsz, thickness}},
                                 field,
                                 norm);
         }
@@ -29,10 +29,12 @@ void G4LoggingDestination::process_message(LogLevel level, std::string& msg) con
     if(!msg.empty() && level <= allpix::Log::getReportingLevel() && !allpix::Log::getStreams().empty()) {
         // Remove line-break always added to G4String
         msg.pop_back();
-        auto prev_section = Log::getSection();
-        Log::setSection("Geant4");
+        // Reference the section header to keep section headers referenced by the framework intact
+        static const std::string section = "Geant4";
+        const auto* prev_section = Log::getSectionReference();
+        Log::setSectionReference(&section);
         allpix::Log().getStream(level, __FILE_NAME__, std::string(static_cast<const char*>(__func__)), __LINE__) << msg;
-        Log::setSection(prev_section);
+        Log::setSectionReference(prev_section);
     }
 }
 
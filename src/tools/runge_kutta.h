@@ -12,21 +12,46 @@
 #ifndef ALLPIX_RUNGE_KUTTA_H
 #define ALLPIX_RUNGE_KUTTA_H
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
 #include <functional>
+#include <type_traits>
+#include <utility>
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 
 namespace allpix {
 
+    /**
+     * @brief Butcher tableau of an explicit Runge-Kutta method with optional embedded error estimation
+     *
+     * The coefficients of the stages are stored in the lower triangle of \ref a, the weights of the solution in \ref b and
+     * the weights of the lower-order solution used for the error estimate in \ref b_error. Methods without error estimation
+     * have all weights of the error estimate set to zero.
+     */
+    template <typename T, size_t S> struct ButcherTableau {
+        std::array<std::array<T, S>, S> a;
+        std::array<T, S> b;
+        std::array<T, S> b_error;
+    };
+
     /**
      * @brief Class to perform arbitrary Runge-Kutta integration
      *
      * Class can be provided a Runge-Kutta tableau (optionally with an error function), together with the dimension of the
      * equations and a step function to integrate a step of the equation. Both the result, error and timestep can be
-     * retrieved and changed during the integration.
+     * retrieved and changed during the integration. The step function is stored with its own type, such that calls to
+     * lambdas can be inlined into the integration step.
+     *
+     * The derivative at the start of a step is reused if it is already known: for tableaus with the first-same-as-last
+     * property it is taken from the last stage of the previous step, and it can be provided together with a new value via
+     * \ref setValue when the caller already evaluated the step function at that point.
      */
-    template <typename T, int S, int D = 3> class RungeKutta {
+    template <typename T, size_t S, int D = 3, typename F = std::function<Eigen::Matrix<T, D, 1>(T, Eigen::Matrix<T, D, 1>)>>
+    class RungeKutta {
     public:
         /**
          * @brief Utility type to return both the value and the error at every step
@@ -41,7 +66,7 @@ namespace allpix {
         /**
          * @brief Stepping function to integrate a single step of the equations
          */
-        using StepFunction = std::function<Eigen::Matrix<T, D, 1>(T, Eigen::Matrix<T, D, 1>)>;
+        using StepFunction = F;
 
         /**
          * @brief Construct a Runge-Kutta integrator
@@ -51,13 +76,13 @@ namespace allpix {
          * @param initial_y Start values of the vector to perform integration on
          * @param initial_t Initial time at the start of the integration
          */
-        RungeKutta(Eigen::Matrix<T, S + 2, S> tableau,
+        RungeKutta(const ButcherTableau<T, S>& tableau,
                    StepFunction function,
                    T step_size,
                    Eigen::Matrix<T, D, 1> initial_y,
                    T initial_t = 0)
-            : tableau_(std::move(tableau)), function_(std::move(function)), h_(std::move(step_size)),
-              y_(std::move(initial_y)), t_(std::move(initial_t)) {
+            : tableau_(tableau), function_(std::move(function)), h_(std::move(step_size)), y_(std::move(initial_y)),
+              t_(std::move(initial_t)), fsal_(tableau.a[S - 1] == tableau.b) {
             error_.setZero();
         }
 
@@ -76,7 +101,21 @@ namespace allpix {
          * @brief Changes the current value during integration
          * @note Can be used to add additional processes during the integration
          */
-        void setValue(Eigen::Matrix<T, D, 1> y) { y_ = std::move(y); }
+        void setValue(Eigen::Matrix<T, D, 1> y) {
+            y_ = std::move(y);
+            has_first_stage_ = false;
+        }
+        /**
+         * @brief Changes the current value during integration together with the derivative at the new value
+         * @param y New value
+         * @param derivative Result of the step function at the new value and the current time
+         * @note Avoids evaluating the step function at the start of the next step
+         */
+        void setValue(Eigen::Matrix<T, D, 1> y, Eigen::Matrix<T, D, 1> derivative) {
+            y_ = std::move(y);
+            first_stage_ = std::move(derivative);
+            has_first_stage_ = true;
+        }
 
         /**
          * @brief Get the value to integrate
@@ -104,39 +143,59 @@ namespace allpix {
          * @return Combination of the current value and the error in this single step
          */
         Step step() {
-            // Initialize values
-            Step step;
-            Eigen::Matrix<T, D, 1> ys;
-            Eigen::Matrix<T, D, 1> yse;
-            ys.setZero();
-            yse.setZero();
-
-            // Compute step
-            Eigen::Matrix<T, S, D> k;
-            for(int i = 0; i < S; ++i) {
+            // Store state at the start of the step to allow rejecting it
+            last_y_ = y_;
+            last_t_ = t_;
+
+            // Compute the stages, reusing the derivative at the start of the step if known
+            std::array<Eigen::Matrix<T, D, 1>, S> k;
+            k[0] = (has_first_stage_ ? first_stage_ : function_(t_, y_));
+            last_first_stage_ = k[0];
+            for(size_t i = 1; i < S; ++i) {
                 Eigen::Matrix<T, D, 1> yt = y_;
                 T tt = t_;
-                for(int j = 0; j < i; ++j) {
-                    yt += h_ * tableau_(i, j) * k.row(j);
-                    tt += tableau_(i, j);
+                for(size_t j = 0; j < i; ++j) {
+                    yt += h_ * tableau_.a[i][j] * k[j];
+                    tt += h_ * tableau_.a[i][j];
                 }
-                k.row(i) = function_(tt, yt);
+                k[i] = function_(tt, yt);
+            }
 
-                ys += h_ * tableau_(S, i) * k.row(i);
-                yse += h_ * tableau_(S + 1, i) * k.row(i);
+            // Combine the stages to the step and the lower-order step of the error estimate
+            Step step;
+            step.value.setZero();
+            step.error.setZero();
+            for(size_t i = 0; i < S; ++i) {
+                step.value += h_ * tableau_.b[i] * k[i];
+                step.error += h_ * (tableau_.b[i] - tableau_.b_error[i]) * k[i];
             }
 
             // Update values with new step
-            y_ += ys;
+            y_ += step.value;
             t_ += h_;
-            error_ += ys - yse;
+            error_ += step.error;
+
+            // The last stage is evaluated at the new value for first-same-as-last tableaus
+            first_stage_ = k[S - 1];
+            has_first_stage_ = fsal_;
 
             // Return step information
-            step.value = ys;
-            step.error = ys - yse;
             return step;
         }
 
+        /**
+         * @brief Reject the last step and return to the value and time before it
+         * @param step Step returned by the last call to \ref step
+         * @note The time step should be changed before the step is repeated
+         */
+        void rejectStep(const Step& step) {
+            y_ = last_y_;
+            t_ = last_t_;
+            error_ -= step.error;
+            first_stage_ = last_first_stage_;
+            has_first_stage_ = true;
+        }
+
         /**
          * @brief Execute multiple time steps of the integration
          * @param amount Number of steps to combine
@@ -155,7 +214,7 @@ namespace allpix {
         }
 
     private:
-        const Eigen::Matrix<T, S + 2, S> tableau_;
+        const ButcherTableau<T, S> tableau_;
         StepFunction function_;
         // Step size
         T h_;
@@ -166,6 +225,66 @@ namespace allpix {
         Eigen::Matrix<T, D, 1> error_;
         // Current time
         T t_;
+
+        // Value and time before the last step
+        Eigen::Matrix<T, D, 1> last_y_;
+        T last_t_{};
+
+        // Derivative at the start of the next and of the last step
+        bool fsal_;
+        bool has_first_stage_{false};
+        Eigen::Matrix<T, D, 1> first_stage_;
+        Eigen::Matrix<T, D, 1> last_first_stage_;
+    };
+
+    /**
+     * @brief Proportional-integral controller for the step size of Runge-Kutta methods with embedded error estimation
+     *
+     * The controller scales the step size with the ratio of the tolerance and the error of the last step, damped by the
+     * error of the step before. Steps with an error above the tolerance are rejected unless the minimum step size has been
+     * reached.
+     */
+    template <typename T> class StepSizeController {
+    public:
+        /**
+         * @brief Construct a step size controller
+         * @param tolerance Tolerance on the norm of the error of a single step
+         * @param step_min Minimum step size
+         * @param step_max Maximum step size
+         * @param order Exponent of the step size in the local error estimate, one above the order of the embedded method
+         */
+        StepSizeController(T tolerance, T step_min, T step_max, int order)
+            : tolerance_(tolerance), step_min_(step_min), step_max_(step_max), alpha_(T(0.7) / order),
+              beta_(T(0.4) / order) {}
+
+        /**
+         * @brief Adapt the step size to the error of the last step
+         * @param error Norm of the error of the last step
+         * @param step_size Step size of the last step, replaced by the step size to use next
+         * @return True if the last step is accepted, false if it needs to be repeated with the new step size
+         */
+        bool adapt(T error, T& step_size) {
+            // Avoid division by zero for exact steps
+            auto ratio = std::max(error / tolerance_, T(1e-10));
+            if(ratio > 1 && step_size > step_min_) {
+                step_size = std::max(step_size * std::max(T(0.2), safety_ * std::pow(ratio, -alpha_)), step_min_);
+                return false;
+            }
+
+            auto factor = safety_ * std::pow(ratio, -alpha_) * std::pow(last_ratio_, beta_);
+            step_size = std::clamp(step_size * std::clamp(factor, T(0.2), T(5)), step_min_, step_max_);
+            last_ratio_ = ratio;
+            return true;
+        }
+
+    private:
+        T tolerance_;
+        T step_min_;
+        T step_max_;
+        T alpha_;
+        T beta_;
+        T safety_{0.9};
+        T last_ratio_{1};
     };
 
     // clang-format off
@@ -174,60 +293,76 @@ namespace allpix {
          * @brief Kutta's third order method
          * @warning Without error function
          */
-        static const auto RK3((Eigen::Matrix<double, 5, 3>() <<
-            0, 0, 0,
-            1.0/2, 0, 0,
-            -1, 2, 0,
-            1.0/6, 2.0/3, 1.0/6,
-            0, 0, 0).finished());
+        inline constexpr ButcherTableau<double, 3> RK3{
+            {{{0, 0, 0},
+              {1.0/2, 0, 0},
+              {-1, 2, 0}}},
+            {1.0/6, 2.0/3, 1.0/6},
+            {0, 0, 0}};
         /**
          * @brief Classic original Runge-Kutta method
          * @warning Without error function
          */
-        static const auto RK4((Eigen::Matrix<double, 6, 4>() <<
-            0, 0, 0, 0,
-            1.0/2, 0, 0, 0,
-            0, 1.0/2, 0, 0,
-            0, 0, 1, 0,
-            1.0/6, 1.0/3, 1.0/3, 1.0/6,
-            0, 0, 0, 0).finished());
+        inline constexpr ButcherTableau<double, 4> RK4{
+            {{{0, 0, 0, 0},
+              {1.0/2, 0, 0, 0},
+              {0, 1.0/2, 0, 0},
+              {0, 0, 1, 0}}},
+            {1.0/6, 1.0/3, 1.0/3, 1.0/6},
+            {0, 0, 0, 0}};
         /**
          * @brief Runge-Kutta-Fehlberg method
          * Values from https://ntrs.nasa.gov/citations/19680027281, p.13, Table III
          */
-        static const auto RK5((Eigen::Matrix<double, 8, 6>() <<
-            0, 0, 0, 0, 0, 0,
-            1.0/4, 0, 0, 0, 0, 0,
-            3.0/32, 9.0/32, 0, 0, 0, 0,
-            1932.0/2197, -7200.0/2197, 7296.0/2197, 0, 0, 0,
-            439.0/216, -8, 3680.0/513, -845.0/4104, 0, 0,
-            -8.0/27, 2, -3544.0/2565, 1859.0/4104, -11.0/40, 0,
-            16.0/135, 0, 6656.0/12825, 28561.0/56430, -9.0/50, 2.0/55,
-            25.0/216, 0, 1408.0/2565, 2197.0/4104, -1.0/5, 0).finished());
+        inline constexpr ButcherTableau<double, 6> RK5{
+            {{{0, 0, 0, 0, 0, 0},
+              {1.0/4, 0, 0, 0, 0, 0},
+              {3.0/32, 9.0/32, 0, 0, 0, 0},
+              {1932.0/2197, -7200.0/2197, 7296.0/2197, 0, 0, 0},
+              {439.0/216, -8, 3680.0/513, -845.0/4104, 0, 0},
+              {-8.0/27, 2, -3544.0/2565, 1859.0/4104, -11.0/40, 0}}},
+            {16.0/135, 0, 6656.0/12825, 28561.0/56430, -9.0/50, 2.0/55},
+            {25.0/216, 0, 1408.0/2565, 2197.0/4104, -1.0/5, 0}};
         /**
          * @brief Runge-Kutta-Cash-Karp method
          */
-        static const auto RKCK((Eigen::Matrix<double, 8, 6>() <<
-            0, 0, 0, 0, 0, 0,
-            1.0/5, 0, 0, 0, 0, 0,
-            3.0/40, 9.0/40, 0, 0, 0, 0,
-            3.0/10, -9.0/10, 6.0/5, 0, 0, 0,
-            -11.0/54, 5.0/2, -70.0/27, 35.0/27, 0, 0,
-            1631.0/55296, 175.0/512, 575.0/13824, 44275.0/110592, 253.0/4096, 0,
-            37.0/378, 0, 250.0/621, 125.0/594, 0, 512.0/1771,
-            2825.0/27648, 0, 18575.0/48384, 13525.0/55296, 277.0/14336, 1.0/4).finished());
+        inline constexpr ButcherTableau<double, 6> RKCK{
+            {{{0, 0, 0, 0, 0, 0},
+              {1.0/5, 0, 0, 0, 0, 0},
+              {3.0/40, 9.0/40, 0, 0, 0, 0},
+              {3.0/10, -9.0/10, 6.0/5, 0, 0, 0},
+              {-11.0/54, 5.0/2, -70.0/27, 35.0/27, 0, 0},
+              {1631.0/55296, 175.0/512, 575.0/13824, 44275.0/110592, 253.0/4096, 0}}},
+            {37.0/378, 0, 250.0/621, 125.0/594, 0, 512.0/1771},
+            {2825.0/27648, 0, 18575.0/48384, 13525.0/55296, 277.0/14336, 1.0/4}};
+        /**
+         * @brief Dormand-Prince method
+         * Fifth-order solution with fourth-order error estimate, the last stage is the first stage of the next step
+         */
+        inline constexpr ButcherTableau<double, 7> DP5{
+            {{{0, 0, 0, 0, 0, 0, 0},
+              {1.0/5, 0, 0, 0, 0, 0, 0},
+              {3.0/40, 9.0/40, 0, 0, 0, 0, 0},
+              {44.0/45, -56.0/15, 32.0/9, 0, 0, 0, 0},
+              {19372.0/6561, -25360.0/2187, 64448.0/6561, -212.0/729, 0, 0, 0},
+              {9017.0/3168, -355.0/33, 46732.0/5247, 49.0/176, -5103.0/18656, 0, 0},
+              {35.0/384, 0, 500.0/1113, 125.0/192, -2187.0/6784, 11.0/84, 0}}},
+            {35.0/384, 0, 500.0/1113, 125.0/192, -2187.0/6784, 11.0/84, 0},
+            {5179.0/57600, 0, 7571.0/16695, 393.0/640, -92097.0/339200, 187.0/2100, 1.0/40}};
     }
     // clang-format on
 
     /**
      * @brief Utility function to create RungeKutta class using template deduction
      * @param tableau One of the possible Runge-Kutta tableaus (see \ref allpix::tableau)
+     * @param function Step function to perform integration, its type is deduced to allow inlining it
      * @param args Other forwarded arguments to the \ref RungeKutta::RungeKutta constructor
      * @return Instantiation of \ref RungeKutta class with the forwarded arguments
      */
-    template <typename T, int S, int D = 3, class... Args>
-    RungeKutta<T, S, D> make_runge_kutta(const Eigen::Matrix<T, S + 2, S>& tableau, Args&&... args) {
-        return RungeKutta<T, S, D>(tableau, std::forward<Args>(args)...);
+    template <typename T, size_t S, int D = 3, typename F, class... Args>
+    RungeKutta<T, S, D, std::decay_t<F>>
+    make_runge_kutta(const ButcherTableau<T, S>& tableau, F&& function, Args&&... args) {
+        return RungeKutta<T, S, D, std::decay_t<F>>(tableau, std::forward<F>(function), std::forward<Args>(args)...);
     }
 } // namespace allpix
 
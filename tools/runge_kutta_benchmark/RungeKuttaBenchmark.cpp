@@ -0,0 +1,109 @@
+/**
+ * @file
+ * @brief Benchmark of the integration steps per second of the Runge-Kutta integrator
+ *
+ * @copyright Copyright (c) 2025 CERN and the Allpix Squared authors.
+ * This software is distributed under the terms of the MIT License, copied verbatim in the file "LICENSE.md".
+ * In applying this license, CERN does not waive the privileges and immunities granted to it by virtue of its status as an
+ * Intergovernmental Organization or submit itself to any jurisdiction.
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <Eigen/Core>
+
+#include "tools/runge_kutta.h"
+
+using namespace allpix;
+
+/**
+ * @brief Integrate the given number of steps and return the number of steps per second
+ * @param tableau Runge-Kutta tableau to integrate with
+ * @param function Step function, either a lambda or a std::function
+ * @param steps Number of steps to integrate
+ * @param checksum Sum of the final values, accumulated to keep the integration from being optimized away
+ */
+template <typename T, size_t S, typename F>
+static double steps_per_second(const ButcherTableau<T, S>& tableau, F&& function, long steps, double& checksum) {
+    // Charge carrier starting at the center of a 300um thick sensor, in millimeter and nanoseconds
+    const Eigen::Vector3d start(0.01, 0.02, 0.0);
+    auto runge_kutta = make_runge_kutta(tableau, std::forward<F>(function), 0.001, start);
+
+    auto begin = std::chrono::steady_clock::now();
+    for(long i = 0; i < steps; ++i) {
+        auto step = runge_kutta.step();
+        checksum += step.error.norm();
+
+        // Restart the carrier when it leaves the sensor to stay within the field
+        if(std::fabs(runge_kutta.getValue().z()) > 0.15) {
+            runge_kutta.setValue(start);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    checksum += runge_kutta.getValue().sum();
+
+    return static_cast<double>(steps) / std::chrono::duration<double>(end - begin).count();
+}
+
+/**
+ * @brief Benchmark a single tableau with both an inlined lambda and a std::function as step function
+ */
+template <typename T, size_t S, typename F>
+static void benchmark(const std::string& name, const ButcherTableau<T, S>& tableau, F function, long steps) {
+    double checksum = 0;
+    auto lambda = steps_per_second(tableau, function, steps, checksum);
+    auto wrapped = steps_per_second(
+        tableau, std::function<Eigen::Vector3d(double, const Eigen::Vector3d&)>(function), steps, checksum);
+
+    std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(2) << std::setw(20)
+              << lambda / 1e6 << std::setw(28) << wrapped / 1e6 << "    (checksum " << std::setprecision(6) << checksum
+              << ")" << std::endl;
+}
+
+/**
+ * @brief Main function running the application
+ */
+int main(int argc, const char* argv[]) {
+    long steps = 10000000;
+    for(int i = 1; i < argc; i++) {
+        if(strcmp(argv[i], "-n") == 0 && (i + 1 < argc)) {
+            steps = std::atol(argv[++i]);
+        } else {
+            std::cout << "Allpix Squared Runge-Kutta Benchmark" << std::endl;
+            std::cout << std::endl;
+            std::cout << "Usage: runge_kutta_benchmark [-n <steps>]" << std::endl;
+            std::cout << std::endl;
+            std::cout << "Options:" << std::endl;
+            std::cout << "  -n <steps>  number of integration steps per measurement (default 10000000)" << std::endl;
+            std::cout << std::endl;
+            std::cout << "For more help, please see <https://cern.ch/allpix-squared>" << std::endl;
+            return (strcmp(argv[i], "-h") == 0 ? 0 : 1);
+        }
+    }
+
+    // Drift velocity of electrons in a linear field with a velocity-saturated mobility, in framework units
+    auto carrier_velocity = [](double, const Eigen::Vector3d& pos) -> Eigen::Vector3d {
+        Eigen::Vector3d efield(1e-5 * pos.x(), 1e-5 * pos.y(), 1e-4 * (1.0 + pos.z() / 0.3));
+        // Low-field mobility of 1400 cm^2/V/s and saturation velocity of 1.07e7 cm/s
+        auto saturation = 140.0 * efield.norm() / 0.107;
+        auto mobility = 140.0 / std::sqrt(1.0 + saturation * saturation);
+        return -mobility * efield;
+    };
+
+    std::cout << "Integrating " << steps << " steps per measurement" << std::endl;
+    std::cout << std::left << std::setw(8) << "Method" << std::right << std::setw(20) << "lambda [Msteps/s]"
+              << std::setw(28) << "std::function [Msteps/s]" << std::endl;
+    benchmark("RK4", tableau::RK4, carrier_velocity, steps);
+    benchmark("RK5", tableau::RK5, carrier_velocity, steps);
+    benchmark("RKCK", tableau::RKCK, carrier_velocity, steps);
+
+    return 0;
+}